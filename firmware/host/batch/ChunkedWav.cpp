@@ -0,0 +1,65 @@
+/**
+ * @file ChunkedWav.cpp
+ * @brief Implementation of the ChunkedWav class.
+ */
+
+#include "ChunkedWav.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace batch {
+
+namespace {
+
+const uint32_t kHeaderBytes = 44;
+
+void putLE(uint8_t* p, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+}  // namespace
+
+bool ChunkedWav::open(const std::string& path, uint32_t totalFrames, uint32_t sampleRate) {
+  close();
+  fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return false;
+
+  uint32_t dataBytes = totalFrames * 4;
+  uint8_t h[kHeaderBytes];
+  memcpy(h, "RIFF", 4);
+  putLE(h + 4, 36 + dataBytes, 4);
+  memcpy(h + 8, "WAVEfmt ", 8);
+  putLE(h + 16, 16, 4);
+  putLE(h + 20, 1, 2);               // PCM
+  putLE(h + 22, 2, 2);               // Stereo
+  putLE(h + 24, sampleRate, 4);
+  putLE(h + 28, sampleRate * 4, 4);  // Byte rate
+  putLE(h + 32, 4, 2);               // Block align
+  putLE(h + 34, 16, 2);
+  memcpy(h + 36, "data", 4);
+  putLE(h + 40, dataBytes, 4);
+
+  // Full size up front; unwritten ranges read back as silence
+  if (pwrite(fd, h, kHeaderBytes, 0) != (ssize_t)kHeaderBytes ||
+      ftruncate(fd, (off_t)kHeaderBytes + dataBytes) != 0) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool ChunkedWav::write(uint32_t frameOffset, const int16_t* samples, uint32_t frames) {
+  if (fd < 0) return false;
+  size_t bytes = (size_t)frames * 4;
+  off_t offset = (off_t)kHeaderBytes + (off_t)frameOffset * 4;
+  return pwrite(fd, samples, bytes, offset) == (ssize_t)bytes;
+}
+
+void ChunkedWav::close() {
+  if (fd < 0) return;
+  ::close(fd);
+  fd = -1;
+}
+
+}  // namespace batch
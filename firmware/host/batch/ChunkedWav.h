@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+/**
+ * @file ChunkedWav.h
+ * @brief Fixed-size 16-bit stereo WAV file that several threads fill at
+ * known frame offsets.
+ */
+
+namespace batch {
+
+/**
+ * @class ChunkedWav
+ * @brief The header is written up front with the final size, so every
+ * writer can put its frames straight into place with pwrite() and nothing is
+ * buffered in RAM. Samples are written in host byte order (little-endian on
+ * x86 and ARM hosts).
+ */
+class ChunkedWav {
+public:
+  ~ChunkedWav() { close(); }
+
+  /**
+   * @brief Creates the file with room for totalFrames stereo frames.
+   * @return false if the file cannot be created
+   */
+  bool open(const std::string& path, uint32_t totalFrames, uint32_t sampleRate);
+
+  /**
+   * @brief Writes interleaved stereo frames at a frame offset. Thread-safe
+   * for non-overlapping ranges.
+   */
+  bool write(uint32_t frameOffset, const int16_t* samples, uint32_t frames);
+
+  void close();
+
+private:
+  int fd = -1;
+};
+
+}  // namespace batch
@@ -0,0 +1,298 @@
+/**
+ * @file EngineSnapshot.cpp
+ * @brief Archives for Pico303Engine::serialize() and the snapshot file format.
+ */
+
+#include "EngineSnapshot.h"
+#include "Pico303Engine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace batch {
+
+namespace {
+
+const uint32_t kMagic = 0x4E533350;  // "P3SN"
+const uint32_t kVersion = 4;
+
+/**
+ * @brief Appends to a byte vector.
+ */
+struct VectorSink {
+  std::vector<uint8_t>& out;
+  void put(const void* p, size_t n) {
+    const uint8_t* b = (const uint8_t*)p;
+    out.insert(out.end(), b, b + n);
+  }
+};
+
+/**
+ * @brief Writes into a fixed caller buffer and counts what did not fit.
+ */
+struct BufferSink {
+  uint8_t* out;
+  size_t capacity;
+  size_t size = 0;
+  void put(const void* p, size_t n) {
+    if (n <= capacity - std::min(size, capacity)) memcpy(out + size, p, n);
+    size += n;
+  }
+};
+
+/**
+ * @brief Visits values into a sink.
+ */
+template <class Sink>
+class Writer {
+public:
+  explicit Writer(Sink& sink) : sink(sink) {}
+
+  template <typename T>
+  void value(T& v) {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot values must be plain data");
+    put(&v, sizeof(T));
+  }
+
+  /// A value the reader range-checks; stored like any other
+  template <typename T>
+  void value(T& v, T, T) { value(v); }
+
+  /**
+   * @brief Stores a buffer as (zero run, literal run, literal samples)
+   * segments. A buffer that was never allocated is stored as empty.
+   */
+  void samples(float* buffer, int size) {
+    uint32_t count = buffer ? (uint32_t)size : 0;
+    put(&count, sizeof(count));
+    uint32_t i = 0;
+    while (i < count) {
+      uint32_t zeros = 0;
+      while (i + zeros < count && isZero(buffer[i + zeros])) zeros++;
+      uint32_t start = i + zeros;
+      uint32_t literals = 0;
+      // A literal run ends at the next stretch of at least 4 zeros
+      while (start + literals < count) {
+        uint32_t z = 0;
+        while (z < 4 && start + literals + z < count && isZero(buffer[start + literals + z])) z++;
+        if (z == 4 || start + literals + z == count) break;
+        literals += z + 1;
+      }
+      put(&zeros, sizeof(zeros));
+      put(&literals, sizeof(literals));
+      put(buffer + start, literals * sizeof(float));
+      i = start + literals;
+    }
+  }
+
+private:
+  static bool isZero(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits == 0;  // +0.0 only, so restoring is bit-exact
+  }
+
+  void put(const void* p, size_t n) { sink.put(p, n); }
+
+  Sink& sink;
+};
+
+/**
+ * @brief Integer type a range-checked value is read as. Enums and bools are
+ * compared as their stored bytes, so a corrupt one is rejected rather than
+ * loaded as a value the type cannot hold.
+ */
+template <typename T, bool = std::is_enum<T>::value>
+struct Stored { using type = T; };
+template <typename T>
+struct Stored<T, true> { using type = typename std::underlying_type<T>::type; };
+template <>
+struct Stored<bool, false> { using type = uint8_t; };
+
+/**
+ * @brief Reads visited values back in the same order.
+ *
+ * A checking reader parses and bounds-checks everything but writes nothing,
+ * so a snapshot can be validated against the engine it is meant for before
+ * any of it is applied.
+ */
+class Reader {
+public:
+  Reader(const uint8_t* data, size_t size, bool apply) : data(data), size(size), apply(apply) {}
+
+  bool ok() const { return !failed; }
+  bool atEnd() const { return pos == size; }
+
+  template <typename T>
+  void value(T& v) {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot values must be plain data");
+    T read{};
+    get(&read, sizeof(T));
+    if (apply && !failed) v = read;
+  }
+
+  /**
+   * @brief Reads a value that must lie in [lo, hi] (NaN does not), e.g. one
+   * the engine uses as an index, an enum or a bool.
+   */
+  template <typename T>
+  void value(T& v, T lo, T hi) {
+    using Raw = typename Stored<T>::type;
+    static_assert(sizeof(Raw) == sizeof(T), "Range-checked values are read as their stored bytes");
+    Raw read{};
+    get(&read, sizeof(T));
+    if (!(read >= (Raw)lo && read <= (Raw)hi)) failed = true;
+    if (apply && !failed) v = (T)read;
+  }
+
+  /**
+   * @brief Decodes into a buffer of fixed size; the stored length must match.
+   */
+  void samples(float* buffer, int size) {
+    uint32_t count = 0;
+    get(&count, sizeof(count));
+    if (failed || count != (buffer ? (uint32_t)size : 0)) {
+      failed = true;
+      return;
+    }
+    uint32_t i = 0;
+    while (!failed && i < count) {
+      uint32_t zeros = 0, literals = 0;
+      get(&zeros, sizeof(zeros));
+      get(&literals, sizeof(literals));
+      if (failed || zeros > count - i || literals > count - i - zeros) {
+        failed = true;
+        return;
+      }
+      if (apply) std::fill(buffer + i, buffer + i + zeros, 0.0f);
+      i += zeros;
+      if (apply) {
+        get(buffer + i, literals * sizeof(float));
+      } else {
+        skip(literals * sizeof(float));
+      }
+      i += literals;
+    }
+  }
+
+private:
+  void get(void* p, size_t n) {
+    if (failed || n > size - pos) {
+      failed = true;
+      return;
+    }
+    memcpy(p, data + pos, n);
+    pos += n;
+  }
+
+  void skip(size_t n) {
+    if (failed || n > size - pos) {
+      failed = true;
+      return;
+    }
+    pos += n;
+  }
+
+  const uint8_t* data;
+  size_t size;
+  bool apply;
+  size_t pos = 0;
+  bool failed = false;
+};
+
+/**
+ * @brief Checks state bytes against the engine, then decodes them into it.
+ * Decoding in place rather than assigning keeps setLog() and the buffers.
+ */
+bool restoreState(Pico303Engine& engine, const uint8_t* data, size_t size) {
+  Reader check(data, size, false);
+  engine.serialize(check);
+  if (!check.ok() || !check.atEnd()) return false;
+  Reader reader(data, size, true);
+  engine.serialize(reader);
+  return reader.ok();
+}
+
+}  // namespace
+
+EngineSnapshot saveEngine(Pico303Engine& engine, uint64_t position) {
+  EngineSnapshot snapshot;
+  snapshot.position = position;
+  VectorSink sink{snapshot.state};
+  Writer<VectorSink> writer(sink);
+  engine.serialize(writer);
+  return snapshot;
+}
+
+bool restoreEngine(Pico303Engine& engine, const EngineSnapshot& snapshot, std::string& error) {
+  if (!restoreState(engine, snapshot.state.data(), snapshot.state.size())) {
+    error = "snapshot does not match this engine build";
+    return false;
+  }
+  return true;
+}
+
+size_t saveSnapshot(Pico303Engine& engine, uint64_t position, uint8_t* out, size_t capacity) {
+  BufferSink sink{out, capacity};
+  uint32_t header[2] = {kMagic, kVersion};
+  uint64_t size = 0;
+  sink.put(header, sizeof(header));
+  sink.put(&position, sizeof(position));
+  sink.put(&size, sizeof(size));
+  size_t stateStart = sink.size;
+  Writer<BufferSink> writer(sink);
+  engine.serialize(writer);
+  // Patch the state size in now that it is known
+  size = sink.size - stateStart;
+  if (stateStart <= capacity) memcpy(out + stateStart - sizeof(size), &size, sizeof(size));
+  return sink.size;
+}
+
+bool restoreSnapshot(Pico303Engine& engine, const uint8_t* data, size_t size, uint64_t& position) {
+  const size_t headerSize = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+  uint32_t header[2];
+  uint64_t pos, stateSize;
+  if (!data || size < headerSize) return false;
+  memcpy(header, data, sizeof(header));
+  memcpy(&pos, data + 8, sizeof(pos));
+  memcpy(&stateSize, data + 16, sizeof(stateSize));
+  if (header[0] != kMagic || header[1] != kVersion || stateSize != size - headerSize) return false;
+  if (!restoreState(engine, data + headerSize, (size_t)stateSize)) return false;
+  position = pos;
+  return true;
+}
+
+bool writeSnapshot(const std::string& path, const EngineSnapshot& snapshot) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  uint32_t header[2] = {kMagic, kVersion};
+  uint64_t size = snapshot.state.size();
+  bool ok = fwrite(header, sizeof(header), 1, f) == 1 &&
+            fwrite(&snapshot.position, sizeof(snapshot.position), 1, f) == 1 &&
+            fwrite(&size, sizeof(size), 1, f) == 1 &&
+            fwrite(snapshot.state.data(), 1, snapshot.state.size(), f) == snapshot.state.size();
+  return fclose(f) == 0 && ok;
+}
+
+bool readSnapshot(const std::string& path, EngineSnapshot& snapshot, std::string& error) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) {
+    error = "cannot open " + path;
+    return false;
+  }
+  uint32_t header[2];
+  uint64_t size = 0;
+  bool ok = fread(header, sizeof(header), 1, f) == 1 && header[0] == kMagic && header[1] == kVersion &&
+            fread(&snapshot.position, sizeof(snapshot.position), 1, f) == 1 &&
+            fread(&size, sizeof(size), 1, f) == 1 && size < (1ull << 32);
+  if (ok) {
+    snapshot.state.resize(size);
+    ok = fread(snapshot.state.data(), 1, size, f) == size;
+  }
+  fclose(f);
+  if (!ok) error = path + ": not a pico-303 engine snapshot";
+  return ok;
+}
+
+}  // namespace batch
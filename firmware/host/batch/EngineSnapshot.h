@@ -0,0 +1,61 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class Pico303Engine;
+
+/**
+ * @file EngineSnapshot.h
+ * @brief Saves and restores the complete state of a Pico303Engine, so host
+ * renders can checkpoint, resume and seek without replaying from the start.
+ */
+
+namespace batch {
+
+/**
+ * @brief A snapshot: the engine state plus the render position it belongs to.
+ *
+ * Layout: "P3SN", format version, sample position, state size, then the
+ * values visited by Pico303Engine::serialize() in order. Delay lines are
+ * stored as alternating runs of zero samples (count only) and literal
+ * samples, so silent regions cost 8 bytes. Restoring is exact. A restore
+ * first parses the whole snapshot without applying it and rejects wrong
+ * buffer sizes and out-of-range values that index buffers.
+ */
+struct EngineSnapshot {
+  uint64_t position = 0;        ///< Frames rendered when the snapshot was taken
+  std::vector<uint8_t> state;
+};
+
+/**
+ * @brief Captures the engine's state.
+ */
+EngineSnapshot saveEngine(Pico303Engine& engine, uint64_t position);
+
+/**
+ * @brief Restores a snapshot into an engine started with begin() at the
+ * same delay length. Nothing is applied unless the whole snapshot fits.
+ * @return false (with a message in error) if the snapshot does not fit this engine
+ */
+bool restoreEngine(Pico303Engine& engine, const EngineSnapshot& snapshot, std::string& error);
+
+/**
+ * @brief Writes a snapshot in the file layout into a caller buffer, without
+ * allocating.
+ * @return Size of the snapshot; the buffer holds all of it only if this is <= capacity
+ */
+size_t saveSnapshot(Pico303Engine& engine, uint64_t position, uint8_t* out, size_t capacity);
+
+/**
+ * @brief Restores a snapshot in the file layout, like restoreEngine() but
+ * from a caller buffer and without allocating.
+ * @return false if the data is not a snapshot for this engine (it is left untouched)
+ */
+bool restoreSnapshot(Pico303Engine& engine, const uint8_t* data, size_t size, uint64_t& position);
+
+bool writeSnapshot(const std::string& path, const EngineSnapshot& snapshot);
+bool readSnapshot(const std::string& path, EngineSnapshot& snapshot, std::string& error);
+
+}  // namespace batch
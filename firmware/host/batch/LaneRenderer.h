@@ -0,0 +1,337 @@
+#pragma once
+#include <stdint.h>
+#include <cmath>
+#include "Pico303Engine.h"
+
+/**
+ * @file LaneRenderer.h
+ * @brief Renders N independent Pico303Engine instances with their voice
+ * state packed into SIMD lanes (host only).
+ *
+ * The voice stages (oscillator, filter, both envelopes, DC blocker, VCA and
+ * de-clicker) of N engines are loaded into GCC vector-extension registers and
+ * advanced together by one instruction stream: 4 lanes map to SSE or NEON,
+ * 8 lanes to AVX2 when the compiler targets it. Branches of the scalar code
+ * (envelope states, glide, PolyBLEP edges, phase wrap) become per-lane masks.
+ * Distortion, delay and the output clipper run per lane afterwards; they do
+ * not feed back into the voice.
+ *
+ * Events are applied per engine through the normal Pico303Engine API between
+ * render() calls, i.e. at block boundaries as on the device. Every operation
+ * matches the scalar code in type and order, so each lane's output is
+ * bit-identical to Pico303Engine::render() as long as the translation unit is
+ * built without FMA contraction (-ffp-contract=off).
+ */
+
+/**
+ * @brief Vector types for a lane count (float and int mask lanes).
+ */
+template <int N> struct LaneVectors;
+template <> struct LaneVectors<4> {
+  typedef float f __attribute__((vector_size(16)));
+  typedef int32_t i __attribute__((vector_size(16)));
+};
+template <> struct LaneVectors<8> {
+  typedef float f __attribute__((vector_size(32)));
+  typedef int32_t i __attribute__((vector_size(32)));
+};
+
+struct LaneRenderer {
+  static const int kMaxFrames = 256;  ///< Frames per internal pass
+
+  /**
+   * @brief Renders frames for every lane.
+   * @param engines N engines, each begin()-ed
+   * @param out N destinations of frames * 2 interleaved samples
+   */
+  template <int N>
+  static void render(Pico303Engine* const* engines, int16_t* const* out, int frames) {
+    float vca[N][kMaxFrames];
+    for (int lane = 0; lane < N; lane++) engines[lane]->updateCoefficients();
+    for (int done = 0; done < frames; done += kMaxFrames) {
+      int count = frames - done < kMaxFrames ? frames - done : kMaxFrames;
+      renderVoices<N>(engines, vca, count);
+      for (int lane = 0; lane < N; lane++) {
+        renderEffects(*engines[lane], vca[lane], out[lane] + done * 2, count);
+      }
+    }
+  }
+
+private:
+  /**
+   * @brief Voice stages of N engines in lockstep; writes the post-VCA signal.
+   */
+  template <int N>
+  static void renderVoices(Pico303Engine* const* engines, float (*vca)[kMaxFrames], int frames) {
+    typedef typename LaneVectors<N>::f vf;
+    typedef typename LaneVectors<N>::i vi;
+
+    // Gather
+    vf frequency, phase, phaseInc, blend, glideStep, subBlend, subPhase, subPhaseInc, pulseWidth, oscRate;
+    vi glideCounter;
+    vf cutoff, envMod, rSkew, filterRate, y1, y2, y3, y4, hpState, hpCoeff, zdfW;
+    vi zdf;
+    bool anyZdf = false;
+    vf filtY, filtCoeff;
+    vi ampState, ampNoteOn;
+    vf ampLevel, attackCoeff, decayCoeff, releaseCoeff;
+    vf dcState, dcAlpha, clickY, clickC, accentGain;
+    for (int l = 0; l < N; l++) {
+      const Pico303Engine& e = *engines[l];
+      frequency[l] = e.osc.frequency;
+      phase[l] = e.osc.phase;
+      phaseInc[l] = e.osc.phaseIncrement;
+      blend[l] = e.osc.blend;
+      glideStep[l] = e.osc.glideStep;
+      glideCounter[l] = e.osc.glideCounter;
+      subBlend[l] = e.osc.subBlend;
+      subPhase[l] = e.osc.subPhase;
+      subPhaseInc[l] = e.osc.subPhaseIncrement;
+      pulseWidth[l] = e.osc.pulseWidth;
+      oscRate[l] = e.osc.sampleRate;
+      cutoff[l] = e.filter.cutoff;
+      envMod[l] = e.filter.envMod;
+      rSkew[l] = e.filter.r_skew;
+      filterRate[l] = e.filter.sampleRate;
+      y1[l] = e.filter.y1;
+      y2[l] = e.filter.y2;
+      y3[l] = e.filter.y3;
+      y4[l] = e.filter.y4;
+      hpState[l] = e.filter.hp_state;
+      hpCoeff[l] = e.filter.hp_coeff;
+      zdfW[l] = e.filter.zdf_w;
+      zdf[l] = e.filter.model == Filter303::ZDF ? -1 : 0;
+      anyZdf |= e.filter.model == Filter303::ZDF;
+      filtY[l] = e.envFilt.y;
+      filtCoeff[l] = e.envFilt.coeff;
+      ampState[l] = e.envAmp.state;
+      ampNoteOn[l] = e.envAmp.isNoteOn ? -1 : 0;
+      ampLevel[l] = e.envAmp.currentLevel;
+      attackCoeff[l] = e.envAmp.attackCoeff;
+      decayCoeff[l] = e.envAmp.decayCoeff;
+      releaseCoeff[l] = e.envAmp.releaseCoeff;
+      dcState[l] = e.hpfPostFilter.lpfState;
+      dcAlpha[l] = e.hpfPostFilter.alpha;
+      clickY[l] = e.ampDeClicker.y;
+      clickC[l] = e.ampDeClicker.c;
+      accentGain[l] = e.currentAccentGain;
+    }
+
+    const vf zero = {};
+    const vf one = zero + 1.0f;
+    const vi attack = (vi){} + (int32_t)AnalogEnvelope::ATTACK;
+    const vi decay = (vi){} + (int32_t)AnalogEnvelope::DECAY;
+    const vi release = (vi){} + (int32_t)AnalogEnvelope::RELEASE;
+    const vi idle = (vi){} + (int32_t)AnalogEnvelope::IDLE;
+
+    for (int i = 0; i < frames; i++) {
+      // AnalogEnvelope::process()
+      vi isAttack = ampState == attack;
+      vi isFalling = (ampState == decay) | (ampState == release);
+      vf falling = ampLevel * ((ampState == decay) ? decayCoeff : releaseCoeff);
+      ampLevel = isAttack ? ampLevel + attackCoeff : (isFalling ? falling : ampLevel);
+      vi attackDone = isAttack & (ampLevel >= 1.0f);
+      vi fallDone = isFalling & (ampLevel < 0.0001f);
+      ampLevel = attackDone ? one : (fallDone ? zero : ampLevel);
+      ampState = attackDone ? decay : (fallDone ? idle : ampState);
+      vf envAmpOut = ampLevel;
+
+      // DecayEnvelope::process()
+      filtY *= filtCoeff;
+      vf envFiltOut = filtY;
+
+      // Oscillator::tick() and process()
+      vi gliding = glideCounter > 0;
+      frequency = gliding ? frequency * glideStep : frequency;
+      phaseInc = gliding ? frequency / oscRate : phaseInc;
+      subPhaseInc = gliding ? (frequency * 0.5f) / oscRate : subPhaseInc;
+      glideCounter += gliding;  // Mask is -1 where gliding
+
+      vf shifted = phase + 0.5f;
+      shifted = shifted >= 1.0f ? shifted - 1.0f : shifted;  // fmod(x, 1), x < 2
+      vf saw = 2.0f * shifted - 1.0f - polyBLEP<vf>(shifted, phaseInc);
+      vf square = phase < pulseWidth ? one : -one;
+      square += polyBLEP<vf>(phase, phaseInc);
+      vf fall = phase + 1.0f - pulseWidth;
+      fall = fall >= 1.0f ? fall - 1.0f : fall;
+      square -= polyBLEP<vf>(fall, phaseInc);
+      vf value = (1.0f - blend) * square + blend * saw;
+
+      vf subVal = subPhase < 0.5f ? one : -one;
+      subPhase += subPhaseInc;
+      subPhase = subPhase >= 1.0f ? subPhase - floorPositive<vf, vi>(subPhase) : subPhase;
+      value = (1.0f - subBlend) * value + subBlend * subVal;
+      value *= 0.707f;
+
+      phase += phaseInc;
+      phase = phase >= 1.0f ? phase - floorPositive<vf, vi>(phase) : phase;
+
+      // Filter303::process()
+      vf modAmt = envMod * envFiltOut;
+      vf lower = -0.95f * cutoff;
+      vf upper = 4.0f * cutoff;
+      modAmt = modAmt > lower ? modAmt : lower;
+      modAmt = modAmt < upper ? modAmt : upper;
+      vf modCutoff = cutoff + modAmt;
+
+      // Filter303::processZDF() on copies of the state, selected below
+      vf zy1 = y1, zy2 = y2, zy3 = y3, zy4 = y4, zHp = hpState;
+      vf zdfOut = anyZdf ? processZDF<vf>(value, modCutoff, zdfW, rSkew, hpCoeff, filterRate,
+                                          zy1, zy2, zy3, zy4, zHp) : zero;
+
+      vf nyquistLimit = 0.45f * filterRate;
+      modCutoff = modCutoff > 5.0f ? modCutoff : zero + 5.0f;
+      modCutoff = modCutoff < nyquistLimit ? modCutoff : nyquistLimit;
+
+      vf fx = modCutoff * (0.70710678f / filterRate);
+
+      vf b0 = (0.00045522346f + 6.1922189f * fx) / (1.0f + 12.358354f * fx + 4.4156345f * (fx * fx));
+      vf k  = fx*(fx*(fx*(fx*(fx*(fx+7198.6997f)-5837.7917f)-476.47308f)+614.95611f)+213.87126f)+16.998792f;
+      vf g  = k * 0.058823529411764705882352941176471f;
+      g = (g - 1.0f) * rSkew + 1.0f;
+      g = (g * (1.0f + rSkew));
+      k = k * rSkew;
+
+      vf fbIn = k * y4;
+      hpState += (1.0f - hpCoeff) * (fbIn - hpState);
+      vf y0 = value - (fbIn - hpState);
+
+      y1 += 2 * b0 * (y0 - y1 + y2);
+      y2 +=     b0 * (y1 - 2 * y2 + y3);
+      y3 +=     b0 * (y2 - 2 * y3 + y4);
+      y4 +=     b0 * (y3 - 2 * y4);
+      vf filtered = 2 * g * y4;
+      if (anyZdf) {
+        y1 = zdf ? zy1 : y1;
+        y2 = zdf ? zy2 : y2;
+        y3 = zdf ? zy3 : y3;
+        y4 = zdf ? zy4 : y4;
+        hpState = zdf ? zHp : hpState;
+        filtered = zdf ? zdfOut : filtered;
+      }
+
+      // DCBlocker::processHPF()
+      dcState += (filtered - dcState) * dcAlpha;
+      filtered = filtered - dcState;
+
+      // VCA and LeakyIntegrator::process()
+      vf vcaMod = envAmpOut + 0.45f * envFiltOut;
+      vcaMod += accentGain * 3.0f * envFiltOut;
+      vcaMod = ampNoteOn ? vcaMod : envAmpOut;
+      clickY += clickC * (vcaMod - clickY);
+      vf out = filtered * clickY;
+
+      for (int l = 0; l < N; l++) vca[l][i] = out[l];
+    }
+
+    // Scatter
+    for (int l = 0; l < N; l++) {
+      Pico303Engine& e = *engines[l];
+      e.osc.frequency = frequency[l];
+      e.osc.phase = phase[l];
+      e.osc.phaseIncrement = phaseInc[l];
+      e.osc.glideCounter = glideCounter[l];
+      e.osc.subPhase = subPhase[l];
+      e.osc.subPhaseIncrement = subPhaseInc[l];
+      e.filter.y1 = y1[l];
+      e.filter.y2 = y2[l];
+      e.filter.y3 = y3[l];
+      e.filter.y4 = y4[l];
+      e.filter.hp_state = hpState[l];
+      e.envFilt.y = filtY[l];
+      e.envAmp.state = (AnalogEnvelope::State)ampState[l];
+      e.envAmp.currentLevel = ampLevel[l];
+      e.hpfPostFilter.lpfState = dcState[l];
+      e.ampDeClicker.y = clickY[l];
+    }
+  }
+
+  /**
+   * @brief Oscillator::polyBLEP() with both edge cases evaluated and selected.
+   */
+  template <typename V>
+  static inline V polyBLEP(V t, V inc) {
+    V rising = t / inc;
+    V fallingT = (t - 1.0f) / inc;
+    V zero = {};
+    V r = rising + rising - rising * rising - 1.0f;
+    V f = fallingT * fallingT + fallingT + fallingT + 1.0f;
+    return t < inc ? r : (t > 1.0f - inc ? f : zero);
+  }
+
+  /**
+   * @brief Filter303::processZDF() for a vector of lanes.
+   */
+  template <typename V>
+  static inline V processZDF(V input, V modCutoff, V zdfW, V rSkew, V hpCoeff, V rate,
+                             V& y1, V& y2, V& y3, V& y4, V& hpState) {
+    V limit = 0.49f * rate;
+    modCutoff = modCutoff > 5.0f ? modCutoff : (V){} + 5.0f;
+    modCutoff = modCutoff < limit ? modCutoff : limit;
+
+    V w = zdfW * modCutoff;
+    V w2 = w * w;
+    V G = w * (945.0f + w2 * (w2 - 105.0f)) / (945.0f + w2 * (15.0f * w2 - 420.0f)) * 0.70710678f;
+
+    V G2 = G * G;
+    V a = 1.0f + 2.0f * G;
+    V t2 = a * a - 2.0f * G2;
+    V t3 = a * (t2 - G2);
+    V t4 = a * t3 - G2 * t2;
+    V p3 = t2 + G2;
+    V c1 = G2 * G;
+    V c2 = G2 * a;
+    V c3 = G * t2;
+    V c5 = G * a * a;
+    V c6 = a * t2;
+    V c7 = G * p3;
+    V c8 = a * p3;
+
+    V k = 17.0f * rSkew;
+    V h = 0.5f + 0.5f * hpCoeff;
+    V hk = h * k;
+    V ns = c1 * y1 + c2 * y2 + c3 * y3 + t3 * y4;
+    V g4 = 2.0f * G2 * G2;
+    V den = t4 + hk * g4;
+    V inv = 1.0f / (t4 * den);
+    V u = ((input + h * hpState) * t4 - hk * ns) * t4 * inv;
+    V invT4 = den * inv;
+
+    V r1 = y1 + 2.0f * G * u;
+    V v1 = (c6 * r1 + 2.0f * (c7 * y2 + c2 * y3 + c1 * y4)) * invT4;
+    V v2 = (c7 * r1 + c8 * y2 + c5 * y3 + c2 * y4) * invT4;
+    V v3 = (c2 * r1 + c5 * y2 + c6 * y3 + c3 * y4) * invT4;
+    V v4 = (ns + g4 * u) * invT4;
+
+    y1 = 2.0f * v1 - y1;
+    y2 = 2.0f * v2 - y2;
+    y3 = 2.0f * v3 - y3;
+    y4 = 2.0f * v4 - y4;
+    hpState += 2.0f * (1.0f - h) * (k * v4 - hpState);
+
+    return 2.0f * (1.0f + rSkew) * v4;
+  }
+
+  /**
+   * @brief floorf() for non-negative values below 2^31.
+   */
+  template <typename V, typename I>
+  static inline V floorPositive(V x) {
+    return __builtin_convertvector(__builtin_convertvector(x, I), V);
+  }
+
+  /**
+   * @brief Distortion, volume, delay and output clipper of one engine,
+   * in the same order as Pico303Engine::render().
+   */
+  static void renderEffects(Pico303Engine& e, const float* vca, int16_t* out, int frames) {
+    for (int i = 0; i < frames; i++) {
+      float sample = e.distFx.process(vca[i]) * e.volume;
+      float outL = e.stereoDelay.processL(sample);
+      float outR = e.stereoDelay.processR(sample);
+      e.stereoDelay.tick(sample, sample);
+      out[i * 2] = (int16_t)(std::tanh(outL * 0.10f) * 30000.0f);
+      out[i * 2 + 1] = (int16_t)(std::tanh(outR * 0.10f) * 30000.0f);
+    }
+  }
+};
@@ -0,0 +1,184 @@
+/**
+ * @file MidiFile.cpp
+ * @brief Standard MIDI File reader.
+ */
+
+#include "MidiFile.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace batch {
+
+namespace {
+
+struct TickEvent {
+  uint64_t tick;
+  uint32_t tempo;     ///< Microseconds per quarter note, 0 = not a tempo change
+  SynthEvent event;
+};
+
+class Reader {
+public:
+  Reader(const std::vector<uint8_t>& data, size_t begin, size_t end)
+    : data(data), pos(begin), end(end) {}
+
+  bool atEnd() const { return pos >= end; }
+  bool has(size_t n) const { return pos + n <= end; }
+  uint8_t peek() const { return data[pos]; }
+  uint8_t byte() { return data[pos++]; }
+  void skip(size_t n) { pos = std::min(pos + n, end); }
+
+  uint32_t be(int bytes) {
+    uint32_t v = 0;
+    for (int i = 0; i < bytes; i++) v = (v << 8) | data[pos++];
+    return v;
+  }
+
+  bool varLen(uint32_t& v) {
+    v = 0;
+    for (int i = 0; i < 4; i++) {
+      if (atEnd()) return false;
+      uint8_t b = byte();
+      v = (v << 7) | (b & 0x7F);
+      if (!(b & 0x80)) return true;
+    }
+    return false;
+  }
+
+private:
+  const std::vector<uint8_t>& data;
+  size_t pos;
+  size_t end;
+};
+
+bool readTrack(Reader& in, std::vector<TickEvent>& out) {
+  uint64_t tick = 0;
+  uint8_t status = 0;
+  while (!in.atEnd()) {
+    uint32_t delta;
+    if (!in.varLen(delta)) return false;
+    tick += delta;
+    if (in.atEnd()) return false;
+
+    if (in.peek() & 0x80) {
+      status = in.byte();
+    } else if (status < 0x80 || status >= 0xF0) {
+      return false;  // Running status without a preceding channel message
+    }
+
+    if (status == 0xFF) {
+      if (!in.has(1)) return false;
+      uint8_t type = in.byte();
+      uint32_t len;
+      if (!in.varLen(len) || !in.has(len)) return false;
+      if (type == 0x51 && len == 3) {
+        out.push_back({tick, in.be(3), {SynthEvent::TEMPO, 0, 0, 0, 0.0f}});
+      } else {
+        in.skip(len);
+      }
+      if (type == 0x2F) break;  // End of track
+      status = 0;
+      continue;
+    }
+    if (status == 0xF0 || status == 0xF7) {
+      uint32_t len;
+      if (!in.varLen(len)) return false;
+      in.skip(len);
+      status = 0;
+      continue;
+    }
+
+    uint8_t kind = status & 0xF0;
+    uint8_t channel = (status & 0x0F) + 1;
+    int dataBytes = (kind == 0xC0 || kind == 0xD0) ? 1 : 2;
+    if (!in.has(dataBytes)) return false;
+    uint8_t d1 = in.byte() & 0x7F;
+    uint8_t d2 = dataBytes > 1 ? (in.byte() & 0x7F) : 0;
+
+    if (kind == 0x90 && d2 > 0) {
+      out.push_back({tick, 0, {SynthEvent::NOTE_ON, channel, d1, d2, 0.0f}});
+    } else if (kind == 0x80 || kind == 0x90) {
+      out.push_back({tick, 0, {SynthEvent::NOTE_OFF, channel, d1, d2, 0.0f}});
+    } else if (kind == 0xB0) {
+      out.push_back({tick, 0, {SynthEvent::CONTROL_CHANGE, channel, d1, d2, 0.0f}});
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool loadMidiFile(const std::string& path, std::vector<TimedEvent>& events, std::string& error) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+  fclose(f);
+  return parseMidiFile(data, path, events, error);
+}
+
+bool parseMidiFile(const std::vector<uint8_t>& data, const std::string& path,
+                   std::vector<TimedEvent>& events, std::string& error) {
+  Reader in(data, 0, data.size());
+  if (!in.has(14) || in.be(4) != 0x4D546864 || in.be(4) != 6) {  // "MThd"
+    error = path + ": not a Standard MIDI File";
+    return false;
+  }
+  uint16_t format = in.be(2);
+  uint16_t tracks = in.be(2);
+  uint16_t division = in.be(2);
+  if (format > 1) {
+    error = path + ": SMF format " + std::to_string(format) + " not supported";
+    return false;
+  }
+  if (division & 0x8000 || division == 0) {
+    error = path + ": SMPTE time division not supported";
+    return false;
+  }
+
+  std::vector<TickEvent> merged;
+  size_t pos = 14;
+  for (int t = 0; t < tracks && pos + 8 <= data.size(); ) {
+    Reader header(data, pos, data.size());
+    uint32_t id = header.be(4);
+    uint32_t len = header.be(4);
+    size_t begin = pos + 8;
+    size_t end = std::min(begin + len, data.size());
+    pos = end;
+    if (id != 0x4D54726B) continue;  // Skip unknown chunks, "MTrk" only
+    Reader track(data, begin, end);
+    if (!readTrack(track, merged)) {
+      error = path + ": malformed track " + std::to_string(t);
+      return false;
+    }
+    t++;
+  }
+
+  // Stable: simultaneous events keep their file order (track 0 tempo first)
+  std::stable_sort(merged.begin(), merged.end(),
+                   [](const TickEvent& a, const TickEvent& b) { return a.tick < b.tick; });
+
+  uint32_t tempo = 500000;  // 120 BPM until the first tempo event
+  uint64_t lastTick = 0;
+  double seconds = 0.0;
+  events.clear();
+  for (const TickEvent& e : merged) {
+    seconds += (double)(e.tick - lastTick) * tempo / (1e6 * division);
+    lastTick = e.tick;
+    SynthEvent ev = e.event;
+    if (ev.type == SynthEvent::TEMPO) {
+      if (e.tempo == 0) continue;
+      tempo = e.tempo;
+      ev.value = 60e6f / tempo;
+    }
+    events.push_back({seconds, ev});
+  }
+  return true;
+}
+
+}  // namespace batch
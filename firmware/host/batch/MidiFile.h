@@ -0,0 +1,39 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "SynthEvent.h"
+
+/**
+ * @file MidiFile.h
+ * @brief Minimal Standard MIDI File reader for the host batch tools.
+ */
+
+namespace batch {
+
+/**
+ * @brief An engine event at an absolute time.
+ */
+struct TimedEvent {
+  double seconds;
+  SynthEvent event;
+};
+
+/**
+ * @brief Reads a format 0 or 1 SMF into engine events, sorted by time.
+ *
+ * Tracks are merged, tempo changes are applied to the timing and also
+ * reported as TEMPO events (for the tempo-synced delay). Only note on/off
+ * and control changes are kept; SMPTE time division is not supported.
+ * @return false (with a message in error) if the file cannot be read
+ */
+bool loadMidiFile(const std::string& path, std::vector<TimedEvent>& events, std::string& error);
+
+/**
+ * @brief Same as loadMidiFile() for a file already in memory.
+ * @param name Used in error messages
+ */
+bool parseMidiFile(const std::vector<uint8_t>& data, const std::string& name,
+                   std::vector<TimedEvent>& events, std::string& error);
+
+}  // namespace batch
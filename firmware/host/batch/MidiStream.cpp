@@ -0,0 +1,53 @@
+/**
+ * @file MidiStream.cpp
+ * @brief Implementation of the MidiStreamParser class.
+ */
+
+#include "MidiStream.h"
+
+namespace batch {
+
+MidiStreamParser::Result MidiStreamParser::feed(uint8_t byte, SynthEvent& ev) {
+  if (byte >= 0xF8) {
+    // Real-time messages may appear anywhere and do not touch running status
+    return byte == 0xF8 ? CLOCK : NONE;
+  }
+  if (byte == 0xF0) {
+    inSysEx = true;
+    status = 0;
+    return NONE;
+  }
+  if (byte >= 0xF1) {
+    // End of SysEx or a system common message: cancels running status
+    inSysEx = false;
+    status = 0;
+    return NONE;
+  }
+  if (byte & 0x80) {
+    inSysEx = false;
+    status = byte;
+    count = 0;
+    return NONE;
+  }
+  if (inSysEx || status == 0) return NONE;
+
+  uint8_t kind = status & 0xF0;
+  int dataBytes = (kind == 0xC0 || kind == 0xD0) ? 1 : 2;
+  data[count++] = byte;
+  if (count < dataBytes) return NONE;
+  count = 0;  // Running status: the next data byte starts a new message
+
+  uint8_t channel = (status & 0x0F) + 1;
+  if (kind == 0x90 && data[1] > 0) {
+    ev = {SynthEvent::NOTE_ON, channel, data[0], data[1], 0.0f};
+  } else if (kind == 0x80 || kind == 0x90) {
+    ev = {SynthEvent::NOTE_OFF, channel, data[0], data[1], 0.0f};
+  } else if (kind == 0xB0) {
+    ev = {SynthEvent::CONTROL_CHANGE, channel, data[0], data[1], 0.0f};
+  } else {
+    return NONE;
+  }
+  return EVENT;
+}
+
+}  // namespace batch
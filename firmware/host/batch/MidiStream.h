@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include "SynthEvent.h"
+
+/**
+ * @file MidiStream.h
+ * @brief Incremental parser for a live MIDI byte stream (host tools).
+ */
+
+namespace batch {
+
+/**
+ * @class MidiStreamParser
+ * @brief Turns MIDI bytes into engine events one byte at a time.
+ *
+ * Handles running status, real-time bytes in the middle of a message and
+ * SysEx (skipped). Note on with velocity 0 becomes a note off, as with the
+ * MIDI library on the device. Keeps no buffers, so it is safe to call from
+ * any thread.
+ */
+class MidiStreamParser {
+public:
+  enum Result {
+    NONE,    ///< Byte consumed, nothing complete yet
+    EVENT,   ///< ev holds a note or control change
+    CLOCK    ///< A MIDI clock pulse (0xF8)
+  };
+
+  /**
+   * @brief Feeds one byte.
+   * @param byte Next byte of the stream
+   * @param ev Receives the event when EVENT is returned
+   */
+  Result feed(uint8_t byte, SynthEvent& ev);
+
+private:
+  uint8_t status = 0;
+  uint8_t data[2] = {0, 0};
+  int count = 0;
+  bool inSysEx = false;
+};
+
+}  // namespace batch
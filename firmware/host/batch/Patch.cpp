@@ -0,0 +1,40 @@
+/**
+ * @file Patch.cpp
+ * @brief Patch file parser.
+ */
+
+#include "Patch.h"
+#include <fstream>
+#include <sstream>
+
+namespace batch {
+
+bool parsePatch(std::istream& in, const std::string& source, Patch& patch, std::string& error) {
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream ss(line);
+    int cc, value;
+    if (!(ss >> cc)) continue;  // Blank line
+    if (!(ss >> value) || cc < 0 || cc > 127 || value < 0 || value > 127) {
+      error = source + ":" + std::to_string(lineNo) + ": expected <cc> <value>";
+      return false;
+    }
+    patch.ccs.push_back({(uint8_t)cc, (uint8_t)value});
+  }
+  return true;
+}
+
+bool loadPatch(const std::string& path, Patch& patch, std::string& error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  return parsePatch(in, path, patch, error);
+}
+
+}  // namespace batch
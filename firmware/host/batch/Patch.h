@@ -0,0 +1,32 @@
+#pragma once
+#include <istream>
+#include <string>
+#include <vector>
+#include "StressScenarios.h"
+
+/**
+ * @file Patch.h
+ * @brief Patch files for the host tools: controller values applied before a render.
+ */
+
+namespace batch {
+
+/**
+ * @brief A parameter set, as the CC values that produce it.
+ *
+ * The text form has one "<cc> <value>" pair per line; '#' starts a comment.
+ */
+struct Patch {
+  std::string name;
+  std::vector<StressCC> ccs;
+};
+
+/**
+ * @brief Parses patch text. The name is left to the caller.
+ * @param source Used in error messages
+ */
+bool parsePatch(std::istream& in, const std::string& source, Patch& patch, std::string& error);
+
+bool loadPatch(const std::string& path, Patch& patch, std::string& error);
+
+}  // namespace batch
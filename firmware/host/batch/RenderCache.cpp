@@ -0,0 +1,172 @@
+/**
+ * @file RenderCache.cpp
+ * @brief Implementation of the RenderCache class.
+ */
+
+#include "RenderCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+namespace batch {
+
+RenderCache::Entry* RenderCache::Lru::find(const std::string& key) {
+  auto it = index.find(key);
+  if (it == index.end()) return nullptr;
+  entries.splice(entries.begin(), entries, it->second);  // Mark as most recent
+  return &entries.front();
+}
+
+void RenderCache::Lru::insert(Entry entry) {
+  auto it = index.find(entry.key);
+  if (it != index.end()) {
+    bytes -= it->second->bytes;
+    entries.erase(it->second);
+  }
+  bytes += entry.bytes;
+  entries.push_front(std::move(entry));
+  index[entries.front().key] = entries.begin();
+}
+
+void RenderCache::Lru::erase(const std::string& key) {
+  auto it = index.find(key);
+  if (it == index.end()) return;
+  bytes -= it->second->bytes;
+  entries.erase(it->second);
+  index.erase(it);
+}
+
+bool RenderCache::Lru::popOldest(Entry& entry) {
+  if (entries.empty()) return false;
+  entry = std::move(entries.back());
+  entries.pop_back();
+  index.erase(entry.key);
+  bytes -= entry.bytes;
+  return true;
+}
+
+RenderCache::RenderCache(uint64_t memoryBudget, const std::string& directory, uint64_t diskBudget)
+  : directory(directory) {
+  memory.budget = memoryBudget;
+  disk.budget = diskBudget;
+  if (!directory.empty()) {
+    mkdir(directory.c_str(), 0755);
+    scanDirectory();
+  }
+}
+
+std::string RenderCache::pathFor(const std::string& key) const {
+  return directory + "/" + key + ".wav";
+}
+
+void RenderCache::scanDirectory() {
+  DIR* dir = opendir(directory.c_str());
+  if (!dir) return;
+  struct Found {
+    std::string key;
+    uint64_t bytes;
+    time_t used;
+  };
+  std::vector<Found> found;
+  while (dirent* d = readdir(dir)) {
+    std::string name = d->d_name;
+    if (name.size() <= 4 || name.compare(name.size() - 4, 4, ".wav") != 0) continue;
+    struct stat st;
+    std::string key = name.substr(0, name.size() - 4);
+    if (stat(pathFor(key).c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+    found.push_back({key, (uint64_t)st.st_size, st.st_mtime});
+  }
+  closedir(dir);
+
+  // Oldest first, so the most recently used file ends up at the front
+  std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.used < b.used; });
+  for (const Found& f : found) disk.insert({f.key, f.bytes, nullptr});
+  Entry old;
+  while (disk.bytes > disk.budget && disk.popOldest(old)) {
+    remove(pathFor(old.key).c_str());
+    evictions++;
+  }
+}
+
+RenderCache::Tier RenderCache::get(const std::string& key, Data& data) {
+  std::lock_guard<std::mutex> guard(lock);
+  if (Entry* e = memory.find(key)) {
+    data = e->data;
+    hits[MEMORY]++;
+    if (disk.find(key)) utime(pathFor(key).c_str(), nullptr);
+    return MEMORY;
+  }
+  if (!disk.find(key)) {
+    hits[MISS]++;
+    return MISS;
+  }
+
+  std::string path = pathFor(key);
+  FILE* f = fopen(path.c_str(), "rb");
+  std::shared_ptr<std::vector<uint8_t>> bytes(new std::vector<uint8_t>);
+  if (f) {
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    bytes->resize(size > 0 ? (size_t)size : 0);
+    if (fread(bytes->data(), 1, bytes->size(), f) != bytes->size()) bytes->clear();
+    fclose(f);
+  }
+  if (bytes->empty()) {
+    // Deleted or damaged behind our back: forget it
+    disk.erase(key);
+    hits[MISS]++;
+    return MISS;
+  }
+  utime(path.c_str(), nullptr);
+  data = bytes;
+  putMemory(key, data);
+  hits[DISK]++;
+  return DISK;
+}
+
+void RenderCache::putMemory(const std::string& key, const Data& data) {
+  if (data->size() > memory.budget) return;
+  memory.insert({key, data->size(), data});
+  Entry old;
+  while (memory.bytes > memory.budget && memory.popOldest(old)) evictions++;
+}
+
+void RenderCache::put(const std::string& key, const Data& data) {
+  std::lock_guard<std::mutex> guard(lock);
+  putMemory(key, data);
+  if (directory.empty() || data->size() > disk.budget) return;
+
+  // Write under a temporary name so a crash never leaves a truncated entry
+  std::string path = pathFor(key);
+  std::string tmp = path + ".tmp";
+  FILE* f = fopen(tmp.c_str(), "wb");
+  if (!f) return;
+  bool ok = fwrite(data->data(), 1, data->size(), f) == data->size();
+  if (fclose(f) != 0 || !ok || rename(tmp.c_str(), path.c_str()) != 0) {
+    remove(tmp.c_str());
+    return;
+  }
+  disk.insert({key, data->size(), nullptr});
+  Entry old;
+  while (disk.bytes > disk.budget && disk.popOldest(old)) {
+    remove(pathFor(old.key).c_str());
+    evictions++;
+  }
+}
+
+RenderCache::Stats RenderCache::stats() {
+  std::lock_guard<std::mutex> guard(lock);
+  Stats s;
+  s.memoryEntries = memory.entries.size();
+  s.memoryBytes = memory.bytes;
+  s.diskEntries = disk.entries.size();
+  s.diskBytes = disk.bytes;
+  std::copy(hits, hits + 3, s.hits);
+  s.evictions = evictions;
+  return s;
+}
+
+}  // namespace batch
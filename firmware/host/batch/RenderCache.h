@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file RenderCache.h
+ * @brief Two-tier (memory, disk) LRU cache of finished renders for the render service.
+ */
+
+namespace batch {
+
+/**
+ * @class RenderCache
+ * @brief Maps a content key to the bytes of a rendered file.
+ *
+ * The memory tier holds the most recently used renders. The disk tier keeps
+ * one "<key>.wav" per render in a directory, survives restarts (access order
+ * is recovered from the file times) and is optional. Each tier evicts its
+ * least recently used entries when it goes over its byte budget; an entry
+ * larger than a budget is simply not kept in that tier. Thread-safe.
+ */
+class RenderCache {
+public:
+  typedef std::shared_ptr<const std::vector<uint8_t>> Data;
+
+  enum Tier {
+    MISS,
+    MEMORY,
+    DISK
+  };
+
+  struct Stats {
+    size_t memoryEntries;
+    uint64_t memoryBytes;
+    size_t diskEntries;
+    uint64_t diskBytes;
+    uint64_t hits[3];   ///< Indexed by Tier
+    uint64_t evictions;
+  };
+
+  /**
+   * @param memoryBudget Bytes kept in memory
+   * @param directory Disk tier location, empty = memory only
+   * @param diskBudget Bytes kept on disk
+   */
+  RenderCache(uint64_t memoryBudget, const std::string& directory, uint64_t diskBudget);
+
+  /**
+   * @brief Looks a key up, memory first. Disk hits are promoted to memory.
+   * @return Where the data came from, MISS if data was not set
+   */
+  Tier get(const std::string& key, Data& data);
+
+  /**
+   * @brief Stores a render in both tiers.
+   */
+  void put(const std::string& key, const Data& data);
+
+  Stats stats();
+
+private:
+  struct Entry {
+    std::string key;
+    uint64_t bytes;
+    Data data;       ///< Memory tier only
+  };
+
+  /**
+   * @brief One LRU list: most recent at the front.
+   */
+  struct Lru {
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    uint64_t bytes = 0;
+    uint64_t budget = 0;
+
+    Entry* find(const std::string& key);
+    void insert(Entry entry);
+    void erase(const std::string& key);
+    bool popOldest(Entry& entry);
+  };
+
+  void putMemory(const std::string& key, const Data& data);
+  std::string pathFor(const std::string& key) const;
+  void scanDirectory();
+
+  std::mutex lock;
+  Lru memory;
+  Lru disk;
+  std::string directory;
+  uint64_t hits[3] = {0, 0, 0};
+  uint64_t evictions = 0;
+};
+
+}  // namespace batch
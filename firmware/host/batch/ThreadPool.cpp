@@ -0,0 +1,93 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of the work-stealing thread pool.
+ */
+
+#include "ThreadPool.h"
+
+namespace batch {
+
+ThreadPool::ThreadPool(unsigned threads) {
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  for (unsigned i = 0; i < threads; i++) {
+    workers.emplace_back(new Worker);
+  }
+  for (unsigned i = 0; i < threads; i++) {
+    workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(stateLock);
+    stopping = true;
+  }
+  workAvailable.notify_all();
+  for (auto& w : workers) w->thread.join();
+}
+
+void ThreadPool::submit(Task task) {
+  Worker& w = *workers[nextWorker.fetch_add(1) % workers.size()];
+  {
+    // Counted before the task is visible, so a worker that takes it at once
+    // cannot decrement either count below zero. Under stateLock so an idle
+    // worker cannot miss the wakeup.
+    std::lock_guard<std::mutex> guard(stateLock);
+    unfinished++;
+    queued.fetch_add(1);
+  }
+  {
+    std::lock_guard<std::mutex> guard(w.lock);
+    w.tasks.push_back(std::move(task));
+  }
+  workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> guard(stateLock);
+  allDone.wait(guard, [this] { return unfinished == 0; });
+}
+
+bool ThreadPool::take(unsigned self, Task& task) {
+  // Own deque first (newest task, still warm in cache)...
+  {
+    Worker& w = *workers[self];
+    std::lock_guard<std::mutex> guard(w.lock);
+    if (!w.tasks.empty()) {
+      task = std::move(w.tasks.back());
+      w.tasks.pop_back();
+      return true;
+    }
+  }
+  // ...then steal the oldest task of another worker
+  for (size_t i = 1; i < workers.size(); i++) {
+    Worker& victim = *workers[(self + i) % workers.size()];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::run(unsigned self) {
+  for (;;) {
+    Task task;
+    if (take(self, task)) {
+      queued.fetch_sub(1);
+      task();
+      std::lock_guard<std::mutex> guard(stateLock);
+      if (--unfinished == 0) allDone.notify_all();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> guard(stateLock);
+    workAvailable.wait(guard, [this] { return stopping || queued.load() > 0; });
+    if (stopping && queued.load() == 0) return;
+  }
+}
+
+}  // namespace batch
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file ThreadPool.h
+ * @brief Work-stealing thread pool for the host batch tools.
+ */
+
+namespace batch {
+
+/**
+ * @class ThreadPool
+ * @brief Each worker owns a deque. Workers take their own tasks from the back
+ * and, when idle, steal from the front of the others, so a few long jobs do
+ * not leave the remaining cores waiting.
+ */
+class ThreadPool {
+public:
+  typedef std::function<void()> Task;
+
+  /**
+   * @param threads Worker count, 0 = std::thread::hardware_concurrency()
+   */
+  explicit ThreadPool(unsigned threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Queues a task. Tasks are spread round-robin over the workers.
+   */
+  void submit(Task task);
+
+  /**
+   * @brief Blocks until every submitted task has finished.
+   */
+  void wait();
+
+  unsigned size() const { return (unsigned)workers.size(); }
+
+private:
+  struct Worker {
+    std::mutex lock;
+    std::deque<Task> tasks;
+    std::thread thread;
+  };
+
+  void run(unsigned self);
+  bool take(unsigned self, Task& task);
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::atomic<unsigned> nextWorker{0};
+  std::atomic<size_t> queued{0};     ///< Submitted, not yet taken
+  size_t unfinished = 0;             ///< Submitted, not yet done (guarded by stateLock)
+  bool stopping = false;
+  std::mutex stateLock;
+  std::condition_variable workAvailable;
+  std::condition_variable allDone;
+};
+
+}  // namespace batch
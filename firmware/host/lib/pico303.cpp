@@ -0,0 +1,171 @@
+/**
+ * @file pico303.cpp
+ * @brief libpico303: C API over Pico303Engine.
+ */
+
+#include "pico303.h"
+#include "batch/EngineSnapshot.h"
+#include "Pico303Engine.h"
+#include "ParameterMap.h"
+#include <algorithm>
+#include <new>
+
+/**
+ * @brief An engine and the events queued for it.
+ */
+struct pico303_engine {
+  struct Pending {
+    uint32_t offset;   ///< Frames from the start of the next render
+    SynthEvent event;
+  };
+
+  Pico303Engine engine;
+  uint64_t position = 0;
+  Pending pending[PICO303_MAX_EVENTS];
+  uint32_t pendingCount = 0;
+};
+
+namespace {
+
+/**
+ * @brief Inserts an event after every pending event with the same or an
+ * earlier offset, so events on one frame apply in call order.
+ */
+pico303_status enqueue(pico303_engine* e, uint32_t offset, const SynthEvent& ev) {
+  if (!e) return PICO303_ERR_ARGUMENT;
+  if (e->pendingCount == PICO303_MAX_EVENTS) return PICO303_ERR_QUEUE_FULL;
+  uint32_t i = e->pendingCount++;
+  for (; i > 0 && e->pending[i - 1].offset > offset; i--) e->pending[i] = e->pending[i - 1];
+  e->pending[i] = {offset, ev};
+  return PICO303_OK;
+}
+
+}  // namespace
+
+extern "C" {
+
+uint32_t pico303_api_version(void) {
+  return PICO303_API_VERSION;
+}
+
+uint32_t pico303_render_version(void) {
+  return Pico303Engine::renderVersion;
+}
+
+pico303_engine* pico303_create(uint32_t sampleRate) {
+  if (sampleRate < 8000 || sampleRate > 192000) return nullptr;
+  pico303_engine* e = new (std::nothrow) pico303_engine;
+  if (!e) return nullptr;
+  if (!e->engine.begin((int)sampleRate)) {
+    delete e;
+    return nullptr;
+  }
+  for (int i = 0; i < kParameterCount; i++) {
+    e->engine.controlChange(1, kParameterMap[i].cc, kParameterMap[i].value);
+  }
+  return e;
+}
+
+void pico303_destroy(pico303_engine* engine) {
+  delete engine;
+}
+
+uint32_t pico303_param_count(void) {
+  return kParameterCount;
+}
+
+pico303_status pico303_param_info_get(uint32_t id, pico303_param_info* info) {
+  if (id >= kParameterCount || !info) return PICO303_ERR_ARGUMENT;
+  const Parameter& p = kParameterMap[id];
+  info->name = p.name;
+  info->cc = p.cc;
+  info->min_value = p.minVal;
+  info->max_value = p.maxVal;
+  info->default_value = p.value;
+  return PICO303_OK;
+}
+
+int32_t pico303_param_id(uint8_t cc) {
+  for (int i = 0; i < kParameterCount; i++) {
+    if (kParameterMap[i].cc == cc) return i;
+  }
+  return -1;
+}
+
+pico303_status pico303_set_cc(pico303_engine* engine, uint32_t offset, uint8_t cc, uint8_t value) {
+  if (cc > 127 || value > 127) return PICO303_ERR_ARGUMENT;
+  return enqueue(engine, offset, {SynthEvent::CONTROL_CHANGE, 1, cc, value, 0.0f});
+}
+
+pico303_status pico303_set_param(pico303_engine* engine, uint32_t offset, uint32_t id, uint8_t value) {
+  if (id >= kParameterCount) return PICO303_ERR_ARGUMENT;
+  const Parameter& p = kParameterMap[id];
+  value = std::min(std::max(value, p.minVal), p.maxVal);
+  return enqueue(engine, offset, {SynthEvent::CONTROL_CHANGE, 1, p.cc, value, 0.0f});
+}
+
+pico303_status pico303_note_on(pico303_engine* engine, uint32_t offset, uint8_t note, uint8_t velocity) {
+  if (note > 127 || velocity > 127) return PICO303_ERR_ARGUMENT;
+  if (velocity == 0) return pico303_note_off(engine, offset, note);
+  return enqueue(engine, offset, {SynthEvent::NOTE_ON, 1, note, velocity, 0.0f});
+}
+
+pico303_status pico303_note_off(pico303_engine* engine, uint32_t offset, uint8_t note) {
+  if (note > 127) return PICO303_ERR_ARGUMENT;
+  return enqueue(engine, offset, {SynthEvent::NOTE_OFF, 1, note, 0, 0.0f});
+}
+
+pico303_status pico303_set_tempo(pico303_engine* engine, uint32_t offset, float bpm) {
+  if (!(bpm > 0.0f && bpm < 1000.0f)) return PICO303_ERR_ARGUMENT;
+  return enqueue(engine, offset, {SynthEvent::TEMPO, 0, 0, 0, bpm});
+}
+
+uint32_t pico303_pending_events(const pico303_engine* engine) {
+  return engine ? engine->pendingCount : 0;
+}
+
+pico303_status pico303_render(pico303_engine* engine, int16_t* out, uint32_t frames) {
+  if (!engine || (!out && frames > 0)) return PICO303_ERR_ARGUMENT;
+  pico303_engine& e = *engine;
+  uint32_t next = 0;
+  uint32_t pos = 0;
+  while (pos < frames) {
+    while (next < e.pendingCount && e.pending[next].offset <= pos) e.engine.apply(e.pending[next++].event);
+    // Straight into the caller's buffer, up to the next event
+    uint32_t end = next < e.pendingCount ? std::min(e.pending[next].offset, frames) : frames;
+    e.engine.render(out + (size_t)pos * 2, (int)(end - pos));
+    pos = end;
+  }
+  // Events stamped at the end of this render apply before the next one starts,
+  // which is the same thing as offset 0 of the next call
+  uint32_t kept = 0;
+  for (uint32_t i = next; i < e.pendingCount; i++) {
+    e.pending[kept] = e.pending[i];
+    e.pending[kept++].offset -= frames;
+  }
+  e.pendingCount = kept;
+  e.position += frames;
+  return PICO303_OK;
+}
+
+uint64_t pico303_position(const pico303_engine* engine) {
+  return engine ? engine->position : 0;
+}
+
+size_t pico303_snapshot(pico303_engine* engine, void* buffer, size_t capacity) {
+  if (!engine) return 0;
+  return batch::saveSnapshot(engine->engine, engine->position, (uint8_t*)buffer, buffer ? capacity : 0);
+}
+
+pico303_status pico303_restore(pico303_engine* engine, const void* data, size_t size) {
+  if (!engine || !data) return PICO303_ERR_ARGUMENT;
+  uint64_t position = 0;
+  if (!batch::restoreSnapshot(engine->engine, (const uint8_t*)data, size, position)) {
+    return PICO303_ERR_STATE;
+  }
+  engine->position = position;
+  engine->pendingCount = 0;
+  return PICO303_OK;
+}
+
+}  // extern "C"
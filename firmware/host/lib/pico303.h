@@ -0,0 +1,133 @@
+/**
+ * @file pico303.h
+ * @brief C API of libpico303: the pico-303 engine as a shared library.
+ *
+ * For tooling in other languages (Python ctypes, Go cgo, ...). The library
+ * is built from the same DSP sources as the firmware, and a render through
+ * it matches the device's 16-bit output for the same events.
+ *
+ * Events are queued with a frame offset relative to the start of the next
+ * pico303_render() call and are applied at exactly that frame. Offsets past
+ * the end of a render carry over to the following calls. Rendering writes
+ * straight into the caller's buffer. After pico303_create(), no call
+ * allocates memory.
+ *
+ * A handle is not thread-safe. Use one handle per thread, or serialize
+ * calls to it.
+ */
+
+#ifndef PICO303_H
+#define PICO303_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define PICO303_API __declspec(dllexport)
+#else
+#define PICO303_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bumped on any incompatible change to this header. */
+#define PICO303_API_VERSION 1
+
+/** Events that can be pending at once. */
+#define PICO303_MAX_EVENTS 1024
+
+typedef enum {
+  PICO303_OK = 0,
+  PICO303_ERR_ARGUMENT = -1,    /**< Null handle, bad ID or out-of-range value */
+  PICO303_ERR_QUEUE_FULL = -2,  /**< PICO303_MAX_EVENTS events already pending */
+  PICO303_ERR_STATE = -3        /**< Snapshot from a different engine build */
+} pico303_status;
+
+typedef struct pico303_engine pico303_engine;
+
+/**
+ * One entry of the hardware CC map. The parameter ID is its index.
+ */
+typedef struct {
+  const char* name;
+  uint8_t cc;
+  uint8_t min_value;
+  uint8_t max_value;
+  uint8_t default_value;
+} pico303_param_info;
+
+/** PICO303_API_VERSION of the loaded library. */
+PICO303_API uint32_t pico303_api_version(void);
+
+/** Pico303Engine::renderVersion: changes whenever the sound changes. */
+PICO303_API uint32_t pico303_render_version(void);
+
+/**
+ * Creates an engine in its power-on state, with every parameter at its
+ * default. Returns NULL if sample_rate is unusable or memory is short.
+ */
+PICO303_API pico303_engine* pico303_create(uint32_t sample_rate);
+PICO303_API void pico303_destroy(pico303_engine* engine);
+
+/* ---- Parameters ---- */
+
+PICO303_API uint32_t pico303_param_count(void);
+PICO303_API pico303_status pico303_param_info_get(uint32_t id, pico303_param_info* info);
+
+/** Parameter ID of a CC number, -1 if the CC is not mapped. */
+PICO303_API int32_t pico303_param_id(uint8_t cc);
+
+/* ---- Events, applied at a frame offset into the next render ---- */
+
+/** Any controller, mapped or not (e.g. 123 = all notes off). */
+PICO303_API pico303_status pico303_set_cc(pico303_engine* engine, uint32_t offset, uint8_t cc, uint8_t value);
+
+/** A mapped parameter by ID. The value is clamped to its range. */
+PICO303_API pico303_status pico303_set_param(pico303_engine* engine, uint32_t offset, uint32_t id, uint8_t value);
+
+/** Velocity 0 counts as a note off, as in MIDI. */
+PICO303_API pico303_status pico303_note_on(pico303_engine* engine, uint32_t offset, uint8_t note, uint8_t velocity);
+PICO303_API pico303_status pico303_note_off(pico303_engine* engine, uint32_t offset, uint8_t note);
+
+/** Tempo for the synced delay, as measured from MIDI clock on the device. */
+PICO303_API pico303_status pico303_set_tempo(pico303_engine* engine, uint32_t offset, float bpm);
+
+/** Number of queued events not yet applied. */
+PICO303_API uint32_t pico303_pending_events(const pico303_engine* engine);
+
+/* ---- Rendering ---- */
+
+/**
+ * Renders frames of interleaved 16-bit stereo into out (frames * 2
+ * samples), applying queued events on their frames.
+ */
+PICO303_API pico303_status pico303_render(pico303_engine* engine, int16_t* out, uint32_t frames);
+
+/** Frames rendered since creation. Restoring a snapshot sets it back. */
+PICO303_API uint64_t pico303_position(const pico303_engine* engine);
+
+/* ---- Snapshots ---- */
+
+/**
+ * Writes the complete engine state and the render position into buffer.
+ * It works like snprintf(): the return value is the size needed, and the
+ * snapshot is only complete if that is <= capacity. Call once with
+ * capacity 0 to size the buffer. With no delay running, the delay lines
+ * are silent and a snapshot is a few hundred bytes. Pending events are not
+ * part of a snapshot.
+ */
+PICO303_API size_t pico303_snapshot(pico303_engine* engine, void* buffer, size_t capacity);
+
+/**
+ * Restores a snapshot taken by this library build and drops pending
+ * events. On error the engine is unchanged. Does not allocate.
+ */
+PICO303_API pico303_status pico303_restore(pico303_engine* engine, const void* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // PICO303_H
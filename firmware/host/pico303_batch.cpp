@@ -0,0 +1,338 @@
+/**
+ * @file pico303_batch.cpp
+ * @brief Renders many independent Pico303Engine instances in parallel, for
+ * sample packs and regression renders.
+ *
+ * Every MIDI file is rendered once per patch (or once without --patch), each
+ * render is one job on a work-stealing thread pool with its own engine. The
+ * stress scenarios can be used as jobs too, which gives a throughput
+ * benchmark without any input files. The report gives the real-time factor
+ * (seconds of audio per second of wall time) overall and per worker thread.
+ *
+ * Patch files hold one "<cc> <value>" pair per line, '#' starts a comment.
+ *
+ * MIDI jobs can write engine snapshots every N seconds of audio
+ * (--checkpoint), and a single MIDI job can continue from one (--resume);
+ * the resumed WAV then holds the audio from the snapshot position on.
+ */
+
+#include "sim/SimHost.h"
+#include "batch/EngineSnapshot.h"
+#include "batch/MidiFile.h"
+#include "batch/Patch.h"
+#include "batch/ThreadPool.h"
+#include "Pico303Engine.h"
+#include "StressScenarios.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBlockSize = 256;   // Same block size as the firmware default
+
+struct Job {
+  std::string name;
+  std::vector<batch::TimedEvent> events;  // MIDI file jobs
+  int scenario = -1;                      // Stress scenario jobs
+  const batch::Patch* patch = nullptr;
+  const batch::EngineSnapshot* resume = nullptr;
+  std::string wavPath;
+  std::string checkpointPrefix;           // Empty: no checkpoints
+};
+
+struct JobResult {
+  uint64_t frames = 0;
+  double cpuSeconds = 0.0;
+  std::string error;
+};
+
+std::string stem(const std::string& path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string base = (slash == std::string::npos) ? path : path.substr(slash + 1);
+  size_t dot = base.find_last_of('.');
+  return (dot == std::string::npos || dot == 0) ? base : base.substr(0, dot);
+}
+
+double threadCpuSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// StressPlayer emits through a plain function pointer; each worker thread
+// renders one job at a time, so the target engine is a thread-local
+thread_local Pico303Engine* emitTarget = nullptr;
+
+void emitToEngine(const SynthEvent& ev) {
+  emitTarget->apply(ev);
+}
+
+/**
+ * @brief Renders one job with its own engine. Runs on a pool worker.
+ */
+void renderJob(const Job& job, double tailSeconds, uint64_t checkpointFrames, JobResult& result) {
+  double cpuStart = threadCpuSeconds();
+  std::unique_ptr<Pico303Engine> engine(new Pico303Engine);
+  if (!engine->begin(kSampleRate)) {
+    result.error = "delay buffer allocation failed";
+    return;
+  }
+  uint64_t pos = 0;
+  if (job.resume) {
+    // The snapshot already holds the patch and every event applied before it
+    if (!batch::restoreEngine(*engine, *job.resume, result.error)) return;
+    pos = job.resume->position;
+  } else if (job.patch) {
+    for (const StressCC& c : job.patch->ccs) {
+      engine->apply({SynthEvent::CONTROL_CHANGE, 1, c.cc, c.value, 0.0f});
+    }
+  }
+
+  sim::WavWriter wav;
+  if (!job.wavPath.empty() && !wav.open(job.wavPath, kSampleRate)) {
+    result.error = "cannot write " + job.wavPath;
+    return;
+  }
+
+  int16_t block[kBlockSize * 2];
+  uint64_t startPos = pos;
+  if (job.scenario >= 0) {
+    emitTarget = engine.get();
+    StressPlayer player;
+    player.start(job.scenario, kSampleRate);
+    while (player.advance(kBlockSize, emitToEngine)) {
+      engine->render(block, kBlockSize);
+      if (!job.wavPath.empty()) wav.write(block, kBlockSize * 2);
+      pos += kBlockSize;
+    }
+    emitTarget = nullptr;
+  } else {
+    uint64_t endSample = (uint64_t)(tailSeconds * kSampleRate);
+    if (!job.events.empty()) endSample += (uint64_t)(job.events.back().seconds * kSampleRate);
+    size_t next = 0;
+    // Events up to one block before the snapshot were applied before it was taken
+    while (next < job.events.size() &&
+           (uint64_t)(job.events[next].seconds * kSampleRate) + kBlockSize <= pos) {
+      next++;
+    }
+    uint64_t nextCheckpoint = checkpointFrames ? pos + checkpointFrames : UINT64_MAX;
+    while (pos < endSample) {
+      if (pos >= nextCheckpoint) {
+        std::string path = job.checkpointPrefix + "_" + std::to_string(pos) + ".p3sn";
+        if (!batch::writeSnapshot(path, batch::saveEngine(*engine, pos))) {
+          result.error = "cannot write " + path;
+          return;
+        }
+        nextCheckpoint += checkpointFrames;
+      }
+      // Events take effect at the block boundary, like on the device
+      while (next < job.events.size() &&
+             (uint64_t)(job.events[next].seconds * kSampleRate) <= pos) {
+        engine->apply(job.events[next++].event);
+      }
+      engine->render(block, kBlockSize);
+      if (!job.wavPath.empty()) wav.write(block, kBlockSize * 2);
+      pos += kBlockSize;
+    }
+  }
+  result.frames = pos - startPos;
+  result.cpuSeconds = threadCpuSeconds() - cpuStart;
+}
+
+/**
+ * @brief Runs all jobs on a pool of the given size.
+ * @return Wall time in seconds
+ */
+double runJobs(const std::vector<Job>& jobs, unsigned threads, double tailSeconds,
+               uint64_t checkpointFrames, std::vector<JobResult>& results) {
+  results.assign(jobs.size(), JobResult());
+  auto t0 = std::chrono::steady_clock::now();
+  {
+    batch::ThreadPool pool(threads);
+    for (size_t i = 0; i < jobs.size(); i++) {
+      pool.submit([&, i] { renderJob(jobs[i], tailSeconds, checkpointFrames, results[i]); });
+    }
+    pool.wait();
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+double audioSeconds(const std::vector<JobResult>& results) {
+  uint64_t frames = 0;
+  for (const JobResult& r : results) frames += r.frames;
+  return (double)frames / kSampleRate;
+}
+
+void usage(const char* argv0) {
+  fprintf(stderr,
+          "Usage: %s [options] [file.mid ...]\n"
+          "  --patch FILE        render every MIDI file with this patch (repeatable)\n"
+          "  --scenario NAME|all add stress scenarios as jobs\n"
+          "  --copies N          repeat the job list N times (default 1)\n"
+          "  --out DIR           write one WAV per job into DIR\n"
+          "  --threads N         worker threads (default: all cores)\n"
+          "  --tail SEC          render time after the last MIDI event (default 2)\n"
+          "  --checkpoint SEC    write an engine snapshot every SEC of audio (MIDI jobs, needs --out)\n"
+          "  --resume FILE       continue a single MIDI job from a snapshot\n"
+          "  --scaling           run with 1, 2, 4 ... threads and print the speedup\n"
+          "  --quiet             no per-job lines\n",
+          argv0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> midiPaths;
+  std::vector<std::string> patchPaths;
+  std::vector<std::string> scenarios;
+  std::string outDir;
+  unsigned threads = 0;
+  int copies = 1;
+  double tailSeconds = 2.0;
+  double checkpointSeconds = 0.0;
+  std::string resumePath;
+  bool scaling = false;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--patch" && hasValue) patchPaths.push_back(argv[++i]);
+    else if (arg == "--scenario" && hasValue) scenarios.push_back(argv[++i]);
+    else if (arg == "--copies" && hasValue) copies = std::max(1, atoi(argv[++i]));
+    else if (arg == "--out" && hasValue) outDir = argv[++i];
+    else if (arg == "--threads" && hasValue) threads = (unsigned)std::max(0, atoi(argv[++i]));
+    else if (arg == "--tail" && hasValue) tailSeconds = std::max(0.0, atof(argv[++i]));
+    else if (arg == "--checkpoint" && hasValue) checkpointSeconds = std::max(0.0, atof(argv[++i]));
+    else if (arg == "--resume" && hasValue) resumePath = argv[++i];
+    else if (arg == "--scaling") scaling = true;
+    else if (arg == "--quiet") quiet = true;
+    else if (!arg.empty() && arg[0] != '-') midiPaths.push_back(arg);
+    else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::string error;
+  std::vector<batch::Patch> patches(patchPaths.size());
+  for (size_t p = 0; p < patchPaths.size(); p++) {
+    patches[p].name = stem(patchPaths[p]);
+    if (!batch::loadPatch(patchPaths[p], patches[p], error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+  }
+
+  std::vector<Job> jobs;
+  for (int copy = 0; copy < copies; copy++) {
+    std::string suffix = copies > 1 ? "_" + std::to_string(copy) : "";
+    for (const std::string& path : midiPaths) {
+      std::vector<batch::TimedEvent> events;
+      if (!loadMidiFile(path, events, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+      }
+      size_t variants = std::max<size_t>(1, patches.size());
+      for (size_t p = 0; p < variants; p++) {
+        Job job;
+        job.events = events;
+        job.patch = patches.empty() ? nullptr : &patches[p];
+        job.name = stem(path) + (job.patch ? "_" + job.patch->name : "") + suffix;
+        jobs.push_back(std::move(job));
+      }
+    }
+    for (const std::string& name : scenarios) {
+      bool found = false;
+      for (int s = 0; s < kStressScenarioCount; s++) {
+        if (name != "all" && name != kStressScenarios[s].name) continue;
+        Job job;
+        job.scenario = s;
+        job.name = std::string(kStressScenarios[s].name) + suffix;
+        jobs.push_back(std::move(job));
+        found = true;
+      }
+      if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", name.c_str());
+        return 1;
+      }
+    }
+  }
+  if (jobs.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (!outDir.empty()) {
+    for (Job& job : jobs) {
+      job.wavPath = outDir + "/" + job.name + ".wav";
+      if (checkpointSeconds > 0.0 && job.scenario < 0) job.checkpointPrefix = outDir + "/" + job.name;
+    }
+  }
+  uint64_t checkpointFrames = 0;
+  if (checkpointSeconds > 0.0) {
+    if (outDir.empty()) {
+      fprintf(stderr, "--checkpoint needs --out\n");
+      return 2;
+    }
+    // Snapshots fall on block boundaries, where events are applied
+    checkpointFrames = std::max<uint64_t>(1, (uint64_t)(checkpointSeconds * kSampleRate / kBlockSize)) * kBlockSize;
+  }
+
+  batch::EngineSnapshot resume;
+  if (!resumePath.empty()) {
+    if (jobs.size() != 1 || jobs[0].scenario >= 0) {
+      fprintf(stderr, "--resume needs exactly one MIDI job\n");
+      return 2;
+    }
+    if (!batch::readSnapshot(resumePath, resume, error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+    jobs[0].resume = &resume;
+  }
+
+  std::vector<JobResult> results;
+  if (scaling) {
+    printf("%7s %10s %10s %10s %8s %10s\n", "threads", "wall s", "audio s", "RTF", "speedup", "RTF/core");
+    double baseRtf = 0.0;
+    for (unsigned n = 1;; n = std::min(n * 2, threads)) {
+      double wall = runJobs(jobs, n, tailSeconds, checkpointFrames, results);
+      double rtf = audioSeconds(results) / wall;
+      if (n == 1) baseRtf = rtf;
+      printf("%7u %10.3f %10.1f %10.1f %7.2fx %10.1f\n", n, wall, audioSeconds(results), rtf,
+             rtf / baseRtf, rtf / n);
+      if (n == threads) break;
+    }
+  } else {
+    double wall = runJobs(jobs, threads, tailSeconds, checkpointFrames, results);
+    if (!quiet) {
+      for (size_t i = 0; i < jobs.size(); i++) {
+        const JobResult& r = results[i];
+        double seconds = (double)r.frames / kSampleRate;
+        printf("%-32s %8.2f s audio %8.3f s cpu  RTF %7.1f\n", jobs[i].name.c_str(), seconds,
+               r.cpuSeconds, r.cpuSeconds > 0 ? seconds / r.cpuSeconds : 0.0);
+      }
+    }
+    double audio = audioSeconds(results);
+    printf("%zu jobs, %.1f s audio in %.3f s on %u threads: RTF %.1f (%.1f per thread)\n",
+           jobs.size(), audio, wall, threads, audio / wall, audio / wall / threads);
+  }
+
+  int failed = 0;
+  for (size_t i = 0; i < jobs.size(); i++) {
+    if (!results[i].error.empty()) {
+      fprintf(stderr, "%s: %s\n", jobs[i].name.c_str(), results[i].error.c_str());
+      failed++;
+    }
+  }
+  return failed ? 1 : 0;
+}
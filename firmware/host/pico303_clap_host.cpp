@@ -0,0 +1,321 @@
+/**
+ * @file pico303_clap_host.cpp
+ * @brief Minimal headless CLAP host for validating the pico-303 plugin.
+ *
+ * Loads a .clap with dlopen, lists its parameters, plays a MIDI file through
+ * it and optionally writes the result as a WAV:
+ *
+ *   pico303_clap_host pico303.clap song.mid [--out song.wav] [--patch acid.txt]
+ *
+ * The MIDI file is rendered twice: with fixed 256-frame buffers and with
+ * random buffer sizes, notes and controllers at their exact frames. Both
+ * renders must match sample for sample. A state save/load round trip and
+ * the parameter list are checked too. Exit code 0 means every check passed.
+ */
+
+#include <clap/clap.h>
+#include "batch/MidiFile.h"
+#include "batch/Patch.h"
+#include "sim/SimHost.h"
+#include <dlfcn.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const double kSampleRate = 44100.0;
+const uint32_t kMaxBuffer = 1024;
+
+// ---- Host callbacks: nothing to do for an offline render ----
+
+const void* hostGetExtension(const clap_host_t*, const char*) { return nullptr; }
+void hostRequestRestart(const clap_host_t*) {}
+void hostRequestProcess(const clap_host_t*) {}
+void hostRequestCallback(const clap_host_t*) {}
+
+const clap_host_t kHost = {
+  CLAP_VERSION_INIT, nullptr, "pico303_clap_host", "pico-303", "", "1.0.0",
+  hostGetExtension, hostRequestRestart, hostRequestProcess, hostRequestCallback,
+};
+
+/**
+ * @brief A buffer's worth of input events, in the layout process() receives.
+ */
+struct EventList {
+  union Slot {
+    clap_event_header_t header;
+    clap_event_note_t note;
+    clap_event_param_value_t param;
+    clap_event_midi_t midi;
+  };
+  std::vector<Slot> slots;
+  clap_input_events_t in;
+
+  EventList() {
+    in.ctx = this;
+    in.size = [](const clap_input_events_t* list) { return (uint32_t)((EventList*)list->ctx)->slots.size(); };
+    in.get = [](const clap_input_events_t* list, uint32_t i) -> const clap_event_header_t* {
+      return &((EventList*)list->ctx)->slots[i].header;
+    };
+  }
+
+  void add(uint32_t time, const SynthEvent& ev) {
+    Slot s;
+    memset(&s, 0, sizeof(s));
+    s.header.time = time;
+    s.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+    if (ev.type == SynthEvent::NOTE_ON || ev.type == SynthEvent::NOTE_OFF) {
+      s.header.size = sizeof(clap_event_note_t);
+      s.header.type = ev.type == SynthEvent::NOTE_ON ? CLAP_EVENT_NOTE_ON : CLAP_EVENT_NOTE_OFF;
+      s.note.note_id = -1;
+      s.note.port_index = 0;
+      s.note.channel = (int16_t)(ev.channel > 0 ? ev.channel - 1 : 0);
+      s.note.key = ev.data1;
+      s.note.velocity = ev.data2 / 127.0;
+    } else if (ev.type == SynthEvent::CONTROL_CHANGE) {
+      // Controllers go in as MIDI, like from a hardware sequencer
+      s.header.size = sizeof(clap_event_midi_t);
+      s.header.type = CLAP_EVENT_MIDI;
+      s.midi.port_index = 0;
+      s.midi.data[0] = (uint8_t)(0xB0 | ((ev.channel > 0 ? ev.channel - 1 : 0) & 0x0F));
+      s.midi.data[1] = ev.data1;
+      s.midi.data[2] = ev.data2;
+    } else {
+      return;
+    }
+    slots.push_back(s);
+  }
+};
+
+bool tryPush(const clap_output_events_t*, const clap_event_header_t*) {
+  return true;
+}
+
+struct Loaded {
+  void* library = nullptr;
+  const clap_plugin_entry_t* entry = nullptr;
+  const clap_plugin_t* plugin = nullptr;
+};
+
+bool load(const char* path, Loaded& l) {
+  l.library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  if (!l.library) {
+    fprintf(stderr, "%s\n", dlerror());
+    return false;
+  }
+  l.entry = (const clap_plugin_entry_t*)dlsym(l.library, "clap_entry");
+  if (!l.entry || !clap_version_is_compatible(l.entry->clap_version) || !l.entry->init(path)) {
+    fprintf(stderr, "%s: no usable clap_entry\n", path);
+    return false;
+  }
+  const clap_plugin_factory_t* factory =
+      (const clap_plugin_factory_t*)l.entry->get_factory(CLAP_PLUGIN_FACTORY_ID);
+  if (!factory || factory->get_plugin_count(factory) < 1) {
+    fprintf(stderr, "%s: no plugins\n", path);
+    return false;
+  }
+  const clap_plugin_descriptor_t* desc = factory->get_plugin_descriptor(factory, 0);
+  l.plugin = factory->create_plugin(factory, &kHost, desc->id);
+  if (!l.plugin || !l.plugin->init(l.plugin)) {
+    fprintf(stderr, "%s: cannot create %s\n", path, desc->id);
+    return false;
+  }
+  printf("loaded %s (%s %s)\n", desc->name, desc->id, desc->version);
+  return true;
+}
+
+/**
+ * @brief Renders the events through an activated plugin.
+ * @param randomSizes Vary the buffer size from 1 to kMaxBuffer frames
+ */
+void render(const clap_plugin_t* plugin, const std::vector<batch::TimedEvent>& events, uint32_t frames,
+            bool randomSizes, std::vector<float>& left, std::vector<float>& right) {
+  left.assign(frames, 0.0f);
+  right.assign(frames, 0.0f);
+  plugin->start_processing(plugin);
+
+  clap_event_transport_t transport;
+  memset(&transport, 0, sizeof(transport));
+  transport.header.size = sizeof(transport);
+  transport.header.type = CLAP_EVENT_TRANSPORT;
+  transport.flags = CLAP_TRANSPORT_HAS_TEMPO | CLAP_TRANSPORT_IS_PLAYING;
+  transport.tempo = 120.0;
+
+  clap_output_events_t out = {nullptr, tryPush};
+  EventList list;
+  uint32_t seed = 12345;
+  size_t next = 0;
+  for (uint32_t pos = 0; pos < frames;) {
+    uint32_t n = 256;
+    if (randomSizes) {
+      seed = seed * 1664525u + 1013904223u;
+      n = 1 + (seed >> 8) % kMaxBuffer;
+    }
+    n = std::min(n, frames - pos);
+    list.slots.clear();
+    while (next < events.size()) {
+      uint32_t at = (uint32_t)(events[next].seconds * kSampleRate);
+      if (at >= pos + n) break;
+      if (events[next].event.type == SynthEvent::TEMPO) transport.tempo = events[next].event.value;
+      list.add(at - std::min(at, pos), events[next].event);
+      next++;
+    }
+
+    float* channels[2] = {&left[pos], &right[pos]};
+    clap_audio_buffer_t output;
+    memset(&output, 0, sizeof(output));
+    output.data32 = channels;
+    output.channel_count = 2;
+
+    clap_process_t process;
+    memset(&process, 0, sizeof(process));
+    process.steady_time = pos;
+    process.frames_count = n;
+    process.transport = &transport;
+    process.audio_outputs = &output;
+    process.audio_outputs_count = 1;
+    process.in_events = &list.in;
+    process.out_events = &out;
+    plugin->process(plugin, &process);
+    pos += n;
+  }
+  plugin->stop_processing(plugin);
+}
+
+// ---- State streams ----
+
+struct Buffer {
+  std::string data;
+  size_t readPos = 0;
+};
+
+int64_t streamWrite(const clap_ostream_t* s, const void* p, uint64_t n) {
+  ((Buffer*)s->ctx)->data.append((const char*)p, n);
+  return (int64_t)n;
+}
+
+int64_t streamRead(const clap_istream_t* s, void* p, uint64_t n) {
+  Buffer* b = (Buffer*)s->ctx;
+  uint64_t take = std::min<uint64_t>(n, b->data.size() - b->readPos);
+  memcpy(p, b->data.data() + b->readPos, take);
+  b->readPos += take;
+  return (int64_t)take;
+}
+
+bool report(const char* name, bool ok, const std::string& detail) {
+  printf("%-24s %s  %s\n", name, ok ? "PASS" : "FAIL", detail.c_str());
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string pluginPath, midiPath, outPath, patchPath;
+  double tailSeconds = 2.0;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+    else if (arg == "--patch" && i + 1 < argc) patchPath = argv[++i];
+    else if (arg == "--tail" && i + 1 < argc) tailSeconds = atof(argv[++i]);
+    else if (pluginPath.empty()) pluginPath = arg;
+    else if (midiPath.empty()) midiPath = arg;
+    else pluginPath.clear();
+  }
+  if (pluginPath.empty() || midiPath.empty()) {
+    fprintf(stderr, "Usage: %s plugin.clap file.mid [--out file.wav] [--patch FILE] [--tail SEC]\n", argv[0]);
+    return 2;
+  }
+
+  std::string error;
+  std::vector<batch::TimedEvent> events;
+  if (!batch::loadMidiFile(midiPath, events, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  if (!patchPath.empty()) {
+    // Patch controllers go in at frame 0, ahead of the file's own events
+    batch::Patch patch;
+    if (!batch::loadPatch(patchPath, patch, error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+    std::vector<batch::TimedEvent> withPatch;
+    for (const StressCC& c : patch.ccs) withPatch.push_back({0.0, {SynthEvent::CONTROL_CHANGE, 1, c.cc, c.value, 0.0f}});
+    withPatch.insert(withPatch.end(), events.begin(), events.end());
+    events.swap(withPatch);
+  }
+  double seconds = tailSeconds + (events.empty() ? 0.0 : events.back().seconds);
+  uint32_t frames = (uint32_t)(seconds * kSampleRate);
+
+  Loaded l;
+  if (!load(pluginPath.c_str(), l)) return 1;
+  const clap_plugin_t* plugin = l.plugin;
+  bool ok = true;
+
+  const clap_plugin_params_t* params = (const clap_plugin_params_t*)plugin->get_extension(plugin, CLAP_EXT_PARAMS);
+  const clap_plugin_state_t* state = (const clap_plugin_state_t*)plugin->get_extension(plugin, CLAP_EXT_STATE);
+  uint32_t paramCount = params ? params->count(plugin) : 0;
+  std::string names;
+  for (uint32_t i = 0; i < paramCount; i++) {
+    clap_param_info_t info;
+    if (params->get_info(plugin, i, &info)) names += std::string(i ? ", " : "") + info.name;
+  }
+  ok &= report("parameters", paramCount > 0, std::to_string(paramCount) + ": " + names);
+
+  // The file's CCs move the patch; both renders start from the same one
+  Buffer initial;
+  clap_ostream_t initialOut = {&initial, streamWrite};
+  clap_istream_t initialIn = {&initial, streamRead};
+  if (state) state->save(plugin, &initialOut);
+
+  std::vector<float> fixedL, fixedR, randomL, randomR;
+  ok &= report("activate", plugin->activate(plugin, kSampleRate, 1, kMaxBuffer), "44100 Hz, 1.." +
+               std::to_string(kMaxBuffer) + " frames");
+  render(plugin, events, frames, false, fixedL, fixedR);
+  plugin->deactivate(plugin);
+  if (state) state->load(plugin, &initialIn);
+  plugin->activate(plugin, kSampleRate, 1, kMaxBuffer);
+  render(plugin, events, frames, true, randomL, randomR);
+  plugin->deactivate(plugin);
+
+  uint32_t differ = 0;
+  for (uint32_t i = 0; i < frames; i++) differ += (fixedL[i] != randomL[i]) + (fixedR[i] != randomR[i]);
+  ok &= report("sample-accurate events", differ == 0, std::to_string(events.size()) + " events, " +
+               std::to_string(differ) + " samples differ between buffer layouts");
+
+  if (state) {
+    Buffer saved;
+    clap_ostream_t os = {&saved, streamWrite};
+    clap_istream_t is = {&saved, streamRead};
+    bool roundTrip = state->save(plugin, &os) && state->load(plugin, &is);
+    Buffer again;
+    clap_ostream_t os2 = {&again, streamWrite};
+    roundTrip = roundTrip && state->save(plugin, &os2) && again.data == saved.data;
+    ok &= report("state round trip", roundTrip, std::to_string(saved.data.size()) + " bytes");
+  }
+
+  if (!outPath.empty()) {
+    sim::WavWriter wav;
+    std::vector<int16_t> pcm(frames * 2);
+    for (uint32_t i = 0; i < frames; i++) {
+      pcm[i * 2] = (int16_t)std::lround(std::fmax(-1.0f, std::fmin(1.0f, fixedL[i])) * 32767.0f);
+      pcm[i * 2 + 1] = (int16_t)std::lround(std::fmax(-1.0f, std::fmin(1.0f, fixedR[i])) * 32767.0f);
+    }
+    if (wav.open(outPath, (uint32_t)kSampleRate)) {
+      wav.write(pcm.data(), pcm.size());
+    } else {
+      fprintf(stderr, "cannot write %s\n", outPath.c_str());
+      ok = false;
+    }
+  }
+
+  plugin->destroy(plugin);
+  l.entry->deinit();
+  dlclose(l.library);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file pico303_coefficients.cpp
+ * @brief Checks the compile-time coefficient tables (CoefficientTables.h)
+ * against exp() at every tabulated sample rate.
+ *
+ * For time constants from 0.1 ms to 30 s and cutoffs from 1 Hz to just
+ * below Nyquist, the table step is turned back into the time constant or
+ * cutoff it implies, and compared with the requested one. Time constants
+ * and cutoffs up to a quarter of the rate (the engine's DC and feedback
+ * filters sit at 30 and 150 Hz) must stay within 2.6e-4. Above that the
+ * interpolation error grows with the curvature of 1 - exp(); up to 0.49 fs
+ * it must stay within the 3e-4 that CoefficientTables.h documents. (That
+ * the engine passes its rate on to the modules is checked by
+ * tools/pico303.py.)
+ *
+ *   pico303_coefficients [--points N]
+ */
+
+#include "CoefficientTables.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+namespace {
+
+const double kMaxError = 2.6e-4;      ///< Time constants, and cutoffs up to fs / 4
+const double kMaxErrorHigh = 3e-4;    ///< Cutoffs up to 0.49 fs
+
+struct Worst {
+  double error = 0.0;
+  double at = 0.0;
+};
+
+/**
+ * @brief Largest relative error of the implied time constant over log-spaced ms.
+ */
+Worst timeError(float rate, int points) {
+  Worst w;
+  for (int i = 0; i < points; i++) {
+    double ms = 0.1 * std::pow(300000.0, (double)i / (points - 1));
+    double step = onePoleForTime((float)ms, rate);
+    double implied = -1.0 / (0.001 * rate * std::log1p(-step));
+    double error = std::fabs(implied / ms - 1.0);
+    if (error > w.error) w = {error, ms};
+  }
+  return w;
+}
+
+/**
+ * @brief Largest relative error of the implied cutoff over log-spaced Hz up to top.
+ */
+Worst cutoffError(float rate, double top, int points) {
+  Worst w;
+  for (int i = 0; i < points; i++) {
+    double hz = std::pow(top, (double)i / (points - 1));
+    double step = onePoleForCutoff((float)hz, rate);
+    double implied = -rate * std::log1p(-step) / (2.0 * M_PI);
+    double error = std::fabs(implied / hz - 1.0);
+    if (error > w.error) w = {error, hz};
+  }
+  return w;
+}
+
+bool report(const char* name, bool ok, const char* detail) {
+  printf("%-28s %s  %s\n", name, ok ? "PASS" : "FAIL", detail);
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int points = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--points") && i + 1 < argc) points = std::max(2, atoi(argv[++i]));
+    else {
+      fprintf(stderr, "Usage: %s [--points N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  bool ok = true;
+  char name[64], detail[160];
+  for (float rate : {44100.0f, 48000.0f}) {
+    Worst t = timeError(rate, points);
+    snprintf(name, sizeof(name), "time constant %.0f Hz", rate);
+    snprintf(detail, sizeof(detail), "max relative error %.2e at %.3f ms", t.error, t.at);
+    ok &= report(name, t.error <= kMaxError, detail);
+
+    Worst c = cutoffError(rate, 0.25 * rate, points);
+    snprintf(name, sizeof(name), "cutoff %.0f Hz", rate);
+    snprintf(detail, sizeof(detail), "max relative error %.2e at %.1f Hz (to fs/4)", c.error, c.at);
+    ok &= report(name, c.error <= kMaxError, detail);
+
+    Worst h = cutoffError(rate, 0.49 * rate, points);
+    snprintf(name, sizeof(name), "cutoff %.0f Hz, high", rate);
+    snprintf(detail, sizeof(detail), "max relative error %.2e at %.1f Hz (to 0.49 fs)", h.error, h.at);
+    ok &= report(name, h.error <= kMaxErrorHigh, detail);
+  }
+  return ok ? 0 : 1;
+}
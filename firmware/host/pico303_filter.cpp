@@ -0,0 +1,201 @@
+/**
+ * @file pico303_filter.cpp
+ * @brief Compares the two Filter303 models: frequency response against the
+ * analog ladder both discretize, and cost per sample.
+ *
+ * Accuracy: for each resonance and cutoff the impulse response of a model is
+ * evaluated at log-spaced frequencies and compared with the continuous-time
+ * ladder (Open303's stage equations at the integrator rate Open303 uses at
+ * low cutoffs, with the 150 Hz highpass in the feedback path). Per model:
+ * the resonance peak in cents against the analog peak and its level, and the
+ * largest deviation in dB from 20 Hz to the cutoff. Above the cutoff the ZDF
+ * model follows the bilinear transform's warping towards its zero at
+ * Nyquist, which is not counted as error.
+ *
+ * Cost: each model filters a saw while an envelope sweeps its cutoff every
+ * sample, as during a note. Best of several runs, in ns and in
+ * StageProfiler::now() ticks (TSC on x86, so cycles only at a fixed clock).
+ * On the device the same comparison is the filter row of the profiler
+ * report (ENABLE_PROFILER) with CC76 at 0 and 1.
+ *
+ * Usage: pico303_filter [--rate 44100] [--runs 20]
+ */
+
+#include "Filter303.h"
+#include "StageProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const int kGridPoints = 300;
+
+struct Model {
+  const char* name;
+  Filter303::Model model;
+};
+
+const Model kModels[] = {{"open303", Filter303::OPEN303}, {"zdf", Filter303::ZDF}};
+
+/**
+ * @brief Analog ladder response at f Hz (output over input, as Filter303).
+ */
+double analogDb(double f, double cutoff, float resonance) {
+  double wa = 6.1922189 * 0.70710678 * cutoff;   // Open303's b0 * fs at low cutoffs
+  double wh = 2.0 * kPi * 150.0;
+  double r = (1.0 - std::exp(-3.0 * resonance)) / 0.9502129316;
+  std::complex<double> s(0.0, 2.0 * kPi * f);
+  std::complex<double> a = s + 2.0 * wa;
+  std::complex<double> det = a * a * a * a - 4.0 * a * a * wa * wa + 2.0 * wa * wa * wa * wa;
+  std::complex<double> ladder = 2.0 * wa * wa * wa * wa / det;
+  std::complex<double> hp = s / (s + wh);
+  std::complex<double> y4 = ladder / (1.0 + 17.0 * r * hp * ladder);
+  return 20.0 * std::log10(std::abs(2.0 * (1.0 + r) * y4));
+}
+
+/**
+ * @brief Magnitude of a sampled impulse response at f Hz (Goertzel).
+ */
+double responseDb(const std::vector<float>& h, double f, double rate) {
+  double w = 2.0 * kPi * f / rate;
+  double c = 2.0 * std::cos(w);
+  double s1 = 0.0, s2 = 0.0;
+  for (float x : h) {
+    double s0 = x + c * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  double re = s1 - s2 * std::cos(w);
+  double im = s2 * std::sin(w);
+  return 10.0 * std::log10(re * re + im * im + 1e-300);
+}
+
+/**
+ * @brief Finds the resonance peak: best grid point, then golden-section
+ * search. Returns false if the response has no peak above lo.
+ */
+template <typename Response>
+bool findPeak(Response db, double lo, double hi, double& peakHz, double& peakDb) {
+  double best = lo, bestDb = -1e9;
+  for (int i = 0; i < kGridPoints; i++) {
+    double f = lo * std::pow(hi / lo, (double)i / (kGridPoints - 1));
+    double d = db(f);
+    if (d > bestDb) { bestDb = d; best = f; }
+  }
+  if (best == lo) return false;
+  double step = std::pow(hi / lo, 1.0 / (kGridPoints - 1));
+  double a = std::log(best / step), b = std::log(best * step);
+  const double phi = 0.6180339887;
+  for (int i = 0; i < 40; i++) {
+    double x1 = b - phi * (b - a), x2 = a + phi * (b - a);
+    if (db(std::exp(x1)) > db(std::exp(x2))) b = x2; else a = x1;
+  }
+  peakHz = std::exp(0.5 * (a + b));
+  peakDb = db(peakHz);
+  return true;
+}
+
+std::vector<float> impulseResponse(Filter303::Model model, float rate, float cutoff, float resonance) {
+  Filter303 filter(rate);
+  filter.setModel(model);
+  filter.setCutoff(cutoff);
+  filter.setResonance(resonance);
+  filter.update();
+  std::vector<float> h((size_t)rate);
+  for (size_t i = 0; i < h.size(); i++) h[i] = filter.process(i == 0 ? 1.0f : 0.0f, 0.0f);
+  return h;
+}
+
+void accuracy(float rate) {
+  const float resonances[] = {0.0f, 0.5f, 0.9f};
+  const float cutoffs[] = {100.0f, 300.0f, 1000.0f, 3000.0f, 6000.0f, 10000.0f, 14000.0f, 18000.0f};
+  double lo = 20.0, hi = 0.49 * rate;
+
+  printf("accuracy against the analog ladder, %.0f Hz\n", rate);
+  printf("%5s %7s %9s |", "res", "cutoff", "analog");
+  for (const Model& m : kModels) printf(" %-8s %6s %7s %6s |", m.name, "cents", "dB", "maxdev");
+  printf("\n");
+  for (float res : resonances) {
+    for (float fc : cutoffs) {
+      double aHz, aDb;
+      bool peak = findPeak([&](double f) { return analogDb(f, fc, res); }, lo, hi, aHz, aDb);
+      if (peak) printf("%5.2f %7.0f %9.1f |", res, fc, aHz);
+      else printf("%5.2f %7.0f %9s |", res, fc, "-");
+      for (const Model& m : kModels) {
+        std::vector<float> h = impulseResponse(m.model, rate, fc, res);
+        double dev = 0.0;
+        for (int i = 0; i < kGridPoints; i++) {
+          double f = lo * std::pow(fc / lo, (double)i / (kGridPoints - 1));
+          dev = std::max(dev, std::fabs(responseDb(h, f, rate) - analogDb(f, fc, res)));
+        }
+        double pHz, pDb;
+        if (peak && findPeak([&](double f) { return responseDb(h, f, rate); }, lo, hi, pHz, pDb)) {
+          printf(" %8.1f %+6.0f %+7.2f %6.2f |", pHz, 1200.0 * std::log2(pHz / aHz), pDb - aDb, dev);
+        } else {
+          printf(" %8s %6s %7s %6.2f |", "-", "", "", dev);
+        }
+      }
+      printf("\n");
+    }
+  }
+}
+
+void cost(float rate, int runs) {
+  const int frames = 4096;
+  std::vector<float> saw(frames), env(frames), out(frames);
+  for (int i = 0; i < frames; i++) {
+    saw[i] = 2.0f * std::fmod(i * 110.0f / rate, 1.0f) - 1.0f;
+    env[i] = std::exp(-i / (0.3f * rate));
+  }
+
+  printf("\ncost per sample, cutoff swept every sample\n");
+  double base = 0.0;
+  for (const Model& m : kModels) {
+    Filter303 filter(rate);
+    filter.setModel(m.model);
+    filter.setCutoff(500.0f);
+    filter.setResonance(0.8f);
+    filter.setEnvMod(2000.0f);
+    filter.update();
+    double bestNs = 1e30;
+    uint32_t bestTicks = UINT32_MAX;
+    for (int r = 0; r < runs; r++) {
+      auto t0 = std::chrono::steady_clock::now();
+      uint32_t c0 = StageProfiler::now();
+      for (int i = 0; i < frames; i++) out[i] = filter.process(saw[i], env[i]);
+      uint32_t ticks = StageProfiler::now() - c0;
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+      bestNs = std::min(bestNs, ns);
+      bestTicks = std::min(bestTicks, ticks);
+    }
+    if (base == 0.0) base = bestNs;
+    printf("%-8s %6.2f ns  %6.1f ticks  (%.2fx)  out %+.3f\n", m.name, bestNs / frames,
+           (double)bestTicks / frames, bestNs / base, out[frames - 1]);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  float rate = 44100.0f;
+  int runs = 20;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--rate" && hasValue) rate = (float)atof(argv[++i]);
+    else if (arg == "--runs" && hasValue) runs = std::max(1, atoi(argv[++i]));
+    else {
+      fprintf(stderr, "Usage: %s [--rate 44100] [--runs 20]\n", argv[0]);
+      return 2;
+    }
+  }
+  accuracy(rate);
+  cost(rate, runs);
+  return 0;
+}
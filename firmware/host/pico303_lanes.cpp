@@ -0,0 +1,187 @@
+/**
+ * @file pico303_lanes.cpp
+ * @brief Throughput of the SIMD lane renderer (batch/LaneRenderer.h) against
+ * the same engines rendered one after another, on one core.
+ *
+ * Every lane plays the same stress scenario with its own cutoff and
+ * resonance, like one step of a parameter sweep. --check compares each lane
+ * with a scalar Pico303Engine fed the same events, block by block. --zdf
+ * switches every other pair of lanes to the ZDF filter model.
+ */
+
+#include "batch/LaneRenderer.h"
+#include "Pico303Engine.h"
+#include "StressScenarios.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBlockSize = 256;
+const int kMaxLanes = 8;
+
+// StressPlayer emits through a plain function pointer; fan out to every engine
+std::vector<Pico303Engine*> emitTargets;
+bool zdfLanes = false;
+
+void emitToAll(const SynthEvent& ev) {
+  for (Pico303Engine* e : emitTargets) e->apply(ev);
+}
+
+/**
+ * @brief Gives each lane its own point of a cutoff x resonance grid.
+ */
+void applyLanePatch(Pico303Engine& e, int lane, int lanes) {
+  uint8_t cutoff = (uint8_t)(16 + lane * 100 / lanes);
+  uint8_t resonance = (uint8_t)(lane % 2 ? 120 : 60);
+  e.apply({SynthEvent::CONTROL_CHANGE, 1, 74, cutoff, 0.0f});
+  e.apply({SynthEvent::CONTROL_CHANGE, 1, 71, resonance, 0.0f});
+  if (zdfLanes && (lane / 2) % 2) e.apply({SynthEvent::CONTROL_CHANGE, 1, 76, 1, 0.0f});
+}
+
+struct Run {
+  double seconds = 0.0;   ///< Wall time
+  uint64_t frames = 0;    ///< Per lane
+  uint64_t mismatches = 0;
+};
+
+template <int N>
+Run run(int scenario, int repeats, bool check) {
+  std::vector<std::unique_ptr<Pico303Engine>> lanes, scalar;
+  for (int l = 0; l < N; l++) {
+    lanes.emplace_back(new Pico303Engine);
+    scalar.emplace_back(new Pico303Engine);
+    lanes[l]->begin(kSampleRate);
+    scalar[l]->begin(kSampleRate);
+  }
+  Pico303Engine* laneEngines[N];
+  int16_t laneOut[N][kBlockSize * 2];
+  int16_t* laneOutPtr[N];
+  for (int l = 0; l < N; l++) {
+    laneEngines[l] = lanes[l].get();
+    laneOutPtr[l] = laneOut[l];
+  }
+  int16_t scalarOut[kBlockSize * 2];
+
+  emitTargets.clear();
+  for (auto& e : lanes) emitTargets.push_back(e.get());
+  if (check) for (auto& e : scalar) emitTargets.push_back(e.get());
+
+  Run result;
+  StressPlayer player;
+  for (int r = 0; r < repeats; r++) {
+    player.start(scenario, kSampleRate);
+    bool first = true;
+    while (player.advance(kBlockSize, emitToAll)) {
+      if (first) {
+        // After the scenario's own setup controllers
+        for (int l = 0; l < N; l++) {
+          applyLanePatch(*lanes[l], l, N);
+          if (check) applyLanePatch(*scalar[l], l, N);
+        }
+        first = false;
+      }
+      auto t0 = std::chrono::steady_clock::now();
+      LaneRenderer::render<N>(laneEngines, laneOutPtr, kBlockSize);
+      result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+      result.frames += kBlockSize;
+
+      if (check) {
+        for (int l = 0; l < N; l++) {
+          scalar[l]->render(scalarOut, kBlockSize);
+          if (memcmp(scalarOut, laneOut[l], sizeof(scalarOut)) != 0) result.mismatches++;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+template <int N>
+Run runScalar(int scenario, int repeats) {
+  std::vector<std::unique_ptr<Pico303Engine>> engines;
+  for (int l = 0; l < N; l++) {
+    engines.emplace_back(new Pico303Engine);
+    engines[l]->begin(kSampleRate);
+  }
+  emitTargets.clear();
+  for (auto& e : engines) emitTargets.push_back(e.get());
+
+  int16_t out[kBlockSize * 2];
+  Run result;
+  StressPlayer player;
+  for (int r = 0; r < repeats; r++) {
+    player.start(scenario, kSampleRate);
+    bool first = true;
+    while (player.advance(kBlockSize, emitToAll)) {
+      if (first) {
+        for (int l = 0; l < N; l++) applyLanePatch(*engines[l], l, N);
+        first = false;
+      }
+      auto t0 = std::chrono::steady_clock::now();
+      for (auto& e : engines) e->render(out, kBlockSize);
+      result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+      result.frames += kBlockSize;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+#if defined(__AVX2__)
+  int lanes = 8;
+#else
+  int lanes = 4;
+#endif
+  std::string scenarioName = "accent_slides";
+  int repeats = 3;
+  bool check = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--lanes" && hasValue) lanes = atoi(argv[++i]);
+    else if (arg == "--scenario" && hasValue) scenarioName = argv[++i];
+    else if (arg == "--repeats" && hasValue) repeats = std::max(1, atoi(argv[++i]));
+    else if (arg == "--check") check = true;
+    else if (arg == "--zdf") zdfLanes = true;
+    else {
+      fprintf(stderr, "Usage: %s [--lanes 4|8] [--scenario NAME] [--repeats N] [--check] [--zdf]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (lanes != 4 && lanes != kMaxLanes) {
+    fprintf(stderr, "--lanes must be 4 or 8\n");
+    return 2;
+  }
+  int scenario = -1;
+  for (int s = 0; s < kStressScenarioCount; s++) {
+    if (scenarioName == kStressScenarios[s].name) scenario = s;
+  }
+  if (scenario < 0) {
+    fprintf(stderr, "unknown scenario %s\n", scenarioName.c_str());
+    return 1;
+  }
+
+  Run scalar = lanes == 4 ? runScalar<4>(scenario, repeats) : runScalar<8>(scenario, repeats);
+  Run simd = lanes == 4 ? run<4>(scenario, repeats, check) : run<8>(scenario, repeats, check);
+
+  double audio = (double)simd.frames * lanes / kSampleRate;
+  double scalarRtf = audio / scalar.seconds;
+  double simdRtf = audio / simd.seconds;
+  printf("%d engines x %.1f s (%s)\n", lanes, (double)simd.frames / kSampleRate, scenarioName.c_str());
+  printf("scalar   RTF %8.1f per core\n", scalarRtf);
+  printf("lanes    RTF %8.1f per core  (%.2fx)\n", simdRtf, simdRtf / scalarRtf);
+  if (check) {
+    printf("check    %llu of %llu lane blocks differ from the scalar engine\n",
+           (unsigned long long)simd.mismatches, (unsigned long long)(simd.frames / kBlockSize * lanes));
+  }
+  return simd.mismatches ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file pico303_latency.cpp
+ * @brief MIDI-to-audio latency benchmark on the host simulator.
+ *
+ * Fires note-ons at jittered times (so arrivals fall on every phase of the
+ * block/I2S cycle), detects each onset in the stream leaving the I2S FIFO and
+ * reports the latency distribution for the block size and buffering this
+ * binary was built with.
+ */
+
+#include "sim/SimHost.h"
+#include "sim/SimRunner.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifndef AUDIO_BLOCK_SIZE
+#define AUDIO_BLOCK_SIZE 256
+#endif
+#ifndef I2S_BUFFER_COUNT
+#define I2S_BUFFER_COUNT 8
+#endif
+#ifndef I2S_BUFFER_WORDS
+#define I2S_BUFFER_WORDS 256
+#endif
+
+using sim::host;
+
+namespace {
+
+/**
+ * @brief Tracks one probe note from MIDI arrival to its first audible frame.
+ */
+struct Probe {
+  uint64_t sentNs;
+  uint64_t onsetNs = 0;
+  bool silentBefore = true;  ///< Output was quiet when the note arrived (valid measurement)
+  bool detected = false;
+  bool checked = false;
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(i, sorted.size() - 1)];
+}
+
+sim::ScriptEvent midiAt(uint64_t ns, std::vector<uint8_t> bytes) {
+  sim::ScriptEvent ev;
+  ev.timeNs = ns;
+  ev.type = sim::ScriptEvent::MIDI;
+  ev.bytes = std::move(bytes);
+  return ev;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int notes = 200;
+  double intervalMs = 400.0;  // Long enough for the release tail to fall below threshold
+  double gateMs = 20.0;
+  int threshold = 64;  // ~-54 dBFS
+  uint32_t seed = 1;
+  bool csv = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--notes" && hasValue) notes = atoi(argv[++i]);
+    else if (arg == "--interval-ms" && hasValue) intervalMs = atof(argv[++i]);
+    else if (arg == "--threshold" && hasValue) threshold = atoi(argv[++i]);
+    else if (arg == "--seed" && hasValue) seed = (uint32_t)atol(argv[++i]);
+    else if (arg == "--render-us" && hasValue) host.cost.renderNsPerFrame = (uint64_t)(atof(argv[++i]) * 1000.0);
+    else if (arg == "--loop-us" && hasValue) host.cost.loopOverheadNs = (uint64_t)(atof(argv[++i]) * 1000.0);
+    else if (arg == "--csv") csv = true;
+    else {
+      fprintf(stderr,
+              "Usage: %s [--notes N] [--interval-ms MS] [--threshold LEVEL] [--seed N]\n"
+              "          [--render-us US] [--loop-us US] [--csv]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  // Dry, short notes so every probe starts from silence: delay off, fast decay
+  const uint64_t startNs = 500000000ULL;
+  host.script.push_back(midiAt(0, {0xB0, 83, 0}));
+  host.script.push_back(midiAt(0, {0xB0, 82, 0}));
+  host.script.push_back(midiAt(0, {0xB0, 75, 0}));
+
+  std::vector<Probe> probes;
+  uint32_t rng = seed;
+  for (int k = 0; k < notes; k++) {
+    rng = rng * 1664525u + 1013904223u;
+    // Up to 10 ms of jitter spreads arrivals over all block phases
+    uint64_t t = startNs + (uint64_t)(k * intervalMs * 1e6) + (rng >> 8) % 10000000ULL;
+    host.script.push_back(midiAt(t, {0x90, 45, 100}));
+    host.script.push_back(midiAt(t + (uint64_t)(gateMs * 1e6), {0x80, 45, 0}));
+    probes.push_back({t});
+  }
+  std::stable_sort(host.script.begin(), host.script.end(),
+                   [](const sim::ScriptEvent& a, const sim::ScriptEvent& b) { return a.timeNs < b.timeNs; });
+
+  // Onset detection on the frames as they leave the FIFO
+  size_t next = 0;
+  host.i2s.sinks.push_back([&](const int16_t* frames, size_t count, uint64_t firstNs) {
+    for (size_t i = 0; i < count && next < probes.size(); i++) {
+      uint64_t t = firstNs + i * 1000000000ULL / host.i2s.sampleRate;
+      Probe& p = probes[next];
+      if (t < p.sentNs) continue;
+      bool loud = std::abs(frames[i * 2]) > threshold || std::abs(frames[i * 2 + 1]) > threshold;
+      if (!p.checked) {
+        // Still ringing from the previous probe: the onset cannot be seen
+        p.checked = true;
+        p.silentBefore = !loud;
+      }
+      if (loud) {
+        p.onsetNs = t;
+        p.detected = true;
+        next++;
+      }
+    }
+  });
+
+  sim::Runner runner;
+  runner.boot();
+  runner.runUntil(startNs + (uint64_t)((notes + 1) * intervalMs * 1e6));
+
+  std::vector<double> latencies;
+  int missed = 0, dirty = 0;
+  for (const Probe& p : probes) {
+    if (!p.detected) missed++;
+    else if (!p.silentBefore) dirty++;
+    else latencies.push_back((p.onsetNs - p.sentNs) / 1e6);
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  double mean = 0.0;
+  for (double v : latencies) mean += v;
+  if (!latencies.empty()) mean /= latencies.size();
+
+  char config[64];
+  snprintf(config, sizeof(config), "block %d, i2s %dx%d%s", AUDIO_BLOCK_SIZE, I2S_BUFFER_COUNT,
+           I2S_BUFFER_WORDS, runner.isDualCore() ? ", dual" : "");
+  if (csv) {
+    printf("%d,%d,%d,%d,%zu,%.3f,%.3f,%.3f,%.3f,%.3f,%llu\n", AUDIO_BLOCK_SIZE, I2S_BUFFER_COUNT, I2S_BUFFER_WORDS,
+           runner.isDualCore() ? 1 : 0, latencies.size(), percentile(latencies, 0.0), percentile(latencies, 0.5),
+           percentile(latencies, 0.99), latencies.empty() ? 0.0 : latencies.back(), mean,
+           (unsigned long long)host.i2s.underrunEvents);
+  } else {
+    printf("%-28s n=%zu  min %.2f  p50 %.2f  p99 %.2f  max %.2f  mean %.2f ms  jitter(p99-min) %.2f ms  underruns %llu",
+           config, latencies.size(), percentile(latencies, 0.0), percentile(latencies, 0.5),
+           percentile(latencies, 0.99), latencies.empty() ? 0.0 : latencies.back(), mean,
+           percentile(latencies, 0.99) - percentile(latencies, 0.0), (unsigned long long)host.i2s.underrunEvents);
+    if (missed || dirty) printf("  (missed %d, not silent %d)", missed, dirty);
+    printf("\n");
+  }
+  return latencies.empty() ? 1 : 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * @file pico303_plugin_check.cpp
+ * @brief Headless validation of the plugin core, with no DAW and no plugin SDK.
+ *
+ * Plays a generated pattern (notes, slides, automation of every mapped
+ * parameter at arbitrary frames) through PluginCore the way a host would and
+ * checks:
+ *   - sample accuracy: random host buffer sizes give the same output as
+ *     fixed 64-frame buffers
+ *   - hardware match: with events on 256-frame block boundaries the output is
+ *     exactly the engine's 16-bit output, as fillAudioBlock() produces it,
+ *     at 44.1 and 48 kHz
+ *   - the engine's DryChain (distortion and delay compiled out) renders
+ *     exactly what the full chain does with both switched off
+ *   - the audio thread never allocates (operator new is counted)
+ *   - main-thread parameter changes are safe while the engine renders, and
+ *     reach it exactly like the same CC sent as an event
+ *   - state save/load round-trips every parameter
+ *
+ *   pico303_plugin_check [--seconds N] [--seed N]
+ */
+
+#include "plugin/PluginCore.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+thread_local bool auditing = false;
+std::atomic<uint64_t> auditedAllocations{0};
+
+const int kSampleRate = 44100;
+
+struct Rng {
+  uint32_t state;
+  uint32_t next() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+  int range(int n) { return (int)(next() % (uint32_t)n); }
+};
+
+/**
+ * @brief A pattern with a note every 1/16 at 130 BPM plus random automation.
+ * @param blockAligned Put every event on a 256-frame boundary
+ */
+std::vector<plugin::PluginCore::Event> makePattern(uint32_t seed, int frames, bool blockAligned) {
+  Rng rng{seed};
+  std::vector<plugin::PluginCore::Event> events;
+  const int step = kSampleRate * 60 / 130 / 4;
+  int note = -1;
+  for (int t = 0; t < frames; t += step) {
+    int jitter = rng.range(step / 4);
+    uint32_t at = (uint32_t)(t + jitter);
+    bool slide = rng.range(4) == 0;
+    int pitch = 36 + rng.range(24);
+    uint8_t velocity = rng.range(3) == 0 ? 120 : 80;
+    events.push_back({at, {SynthEvent::NOTE_ON, 1, (uint8_t)pitch, velocity, 0.0f}});
+    if (note >= 0) {
+      // Slides release the previous note after the next one starts
+      uint32_t off = slide ? at + 1 : at;
+      events.push_back({off, {SynthEvent::NOTE_OFF, 1, (uint8_t)note, 0, 0.0f}});
+    }
+    note = pitch;
+    for (int k = rng.range(3); k > 0; k--) {
+      const Parameter& p = kParameterMap[rng.range(kParameterCount)];
+      uint8_t value = (uint8_t)(p.minVal + rng.range(p.maxVal - p.minVal + 1));
+      events.push_back({at + (uint32_t)rng.range(step), {SynthEvent::CONTROL_CHANGE, 1, p.cc, value, 0.0f}});
+    }
+  }
+  for (auto& e : events) {
+    if (blockAligned) e.frame = e.frame / 256 * 256;
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const plugin::PluginCore::Event& a, const plugin::PluginCore::Event& b) { return a.frame < b.frame; });
+  return events;
+}
+
+/**
+ * @brief Runs the pattern through a core like a host: buffer by buffer,
+ * events rebased to each buffer.
+ * @param maxBuffer Fixed buffer size, or the upper bound of random sizes
+ */
+void renderCore(plugin::PluginCore& core, const std::vector<plugin::PluginCore::Event>& pattern, int frames,
+                int maxBuffer, bool randomSizes, uint32_t seed, std::vector<float>& left, std::vector<float>& right) {
+  Rng rng{seed};
+  left.assign(frames, 0.0f);
+  right.assign(frames, 0.0f);
+  std::vector<plugin::PluginCore::Event> buffer;
+  buffer.reserve(plugin::PluginCore::kMaxEvents);
+  size_t next = 0;
+  for (int pos = 0; pos < frames;) {
+    int n = randomSizes ? 1 + rng.range(maxBuffer) : maxBuffer;
+    n = std::min(n, frames - pos);
+    buffer.clear();
+    while (next < pattern.size() && pattern[next].frame < (uint32_t)(pos + n)) {
+      plugin::PluginCore::Event e = pattern[next++];
+      e.frame -= pos;
+      buffer.push_back(e);
+    }
+    auditing = true;
+    core.process(buffer.data(), (int)buffer.size(), 130.0, &left[pos], &right[pos], n);
+    auditing = false;
+    pos += n;
+  }
+}
+
+bool report(const char* name, bool ok, const char* detail) {
+  printf("%-28s %s  %s\n", name, ok ? "PASS" : "FAIL", detail);
+  return ok;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  if (auditing) auditedAllocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+int main(int argc, char** argv) {
+  double seconds = 20.0;
+  uint32_t seed = 303;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)atoi(argv[++i]);
+    else {
+      fprintf(stderr, "Usage: %s [--seconds N] [--seed N]\n", argv[0]);
+      return 2;
+    }
+  }
+  const int frames = (int)(seconds * kSampleRate);
+  bool ok = true;
+  char detail[160];
+
+  // Sample accuracy: the buffer layout must not change a single sample
+  std::vector<plugin::PluginCore::Event> pattern = makePattern(seed, frames, false);
+  std::vector<float> refL, refR, l, r;
+  {
+    std::unique_ptr<plugin::PluginCore> core(new plugin::PluginCore);
+    core->activate(kSampleRate);
+    renderCore(*core, pattern, frames, 64, false, seed, refL, refR);
+    core.reset(new plugin::PluginCore);
+    core->activate(kSampleRate);
+    renderCore(*core, pattern, frames, 1024, true, seed + 1, l, r);
+  }
+  int mismatches = 0;
+  for (int i = 0; i < frames; i++) mismatches += (l[i] != refL[i]) + (r[i] != refR[i]);
+  snprintf(detail, sizeof(detail), "%zu events, random buffers 1..1024 vs 64: %d samples differ",
+           pattern.size(), mismatches);
+  ok &= report("sample-accurate events", mismatches == 0, detail);
+
+  uint64_t allocations = auditedAllocations.load();
+  snprintf(detail, sizeof(detail), "%llu allocations inside process()", (unsigned long long)allocations);
+  ok &= report("audio thread allocation", allocations == 0, detail);
+
+  // Hardware match: block-aligned events against the firmware's render loop,
+  // at the device rate and at a common DAW rate
+  std::vector<plugin::PluginCore::Event> aligned = makePattern(seed, frames, true);
+  for (int rate : {kSampleRate, 48000}) {
+    {
+      std::unique_ptr<plugin::PluginCore> core(new plugin::PluginCore);
+      core->activate(rate);
+      renderCore(*core, aligned, frames, 256, false, seed, l, r);
+    }
+    std::unique_ptr<Pico303Engine> engine(new Pico303Engine);
+    engine->begin(rate);
+    for (int i = 0; i < kParameterCount; i++) engine->controlChange(1, kParameterMap[i].cc, kParameterMap[i].value);
+    engine->apply({SynthEvent::TEMPO, 0, 0, 0, 130.0f});
+    int16_t block[256 * 2];
+    mismatches = 0;
+    size_t next = 0;
+    for (int pos = 0; pos + 256 <= frames; pos += 256) {
+      while (next < aligned.size() && aligned[next].frame <= (uint32_t)pos) engine->apply(aligned[next++].event);
+      engine->render(block, 256);
+      for (int i = 0; i < 256; i++) {
+        mismatches += (l[pos + i] * 32768.0f != block[i * 2]) + (r[pos + i] * 32768.0f != block[i * 2 + 1]);
+      }
+    }
+    snprintf(detail, sizeof(detail), "%d Hz: %d samples differ from Pico303Engine::render()", rate, mismatches);
+    ok &= report("matches firmware render", mismatches == 0, detail);
+  }
+
+  // Dry chain: with distortion off and the delay mix at 0 the stages it
+  // leaves out pass the voice through unchanged, so the output must match
+  {
+    NullProfiler probe;
+    std::unique_ptr<Pico303Engine> full(new Pico303Engine), dry(new Pico303Engine);
+    for (Pico303Engine* e : {full.get(), dry.get()}) {
+      e->begin(kSampleRate);
+      for (int i = 0; i < kParameterCount; i++) e->controlChange(1, kParameterMap[i].cc, kParameterMap[i].value);
+      e->controlChange(1, 80, 0);  // Distortion off
+      e->controlChange(1, 83, 0);  // Delay mix
+    }
+    int16_t a[256 * 2], b[256 * 2];
+    mismatches = 0;
+    size_t next = 0;
+    for (int pos = 0; pos + 256 <= frames; pos += 256) {
+      for (; next < aligned.size() && aligned[next].frame <= (uint32_t)pos; next++) {
+        if (aligned[next].event.type == SynthEvent::CONTROL_CHANGE) continue;
+        full->apply(aligned[next].event);
+        dry->apply(aligned[next].event);
+      }
+      full->render<Pico303Engine::FullChain>(a, 256, nullptr, probe);
+      dry->render<Pico303Engine::DryChain>(b, 256, nullptr, probe);
+      for (int i = 0; i < 256 * 2; i++) mismatches += a[i] != b[i];
+    }
+    snprintf(detail, sizeof(detail), "%d samples differ from the full chain", mismatches);
+    ok &= report("dry chain", mismatches == 0, detail);
+  }
+
+  // Parameter path: another thread turns the cutoff knob during the render
+  {
+    std::unique_ptr<plugin::PluginCore> core(new plugin::PluginCore);
+    core->activate(kSampleRate);
+    int cutoff = plugin::PluginCore::indexOfCC(74);
+    std::atomic<bool> done{false};
+    std::thread knob([&] {
+      for (int v = 0; !done; v = (v + 1) % 128) {
+        core->setParameter(cutoff, (uint8_t)v);
+        std::this_thread::yield();
+      }
+    });
+    renderCore(*core, pattern, std::min(frames, kSampleRate * 2), 128, false, seed, l, r);
+    done = true;
+    knob.join();
+  }
+
+  // The knob's value reaches the engine: a change from the main thread must
+  // render exactly like the same CC as an event, and unlike no change at all
+  {
+    const int half = 4096;
+    plugin::PluginCore::Event note = {0, {SynthEvent::NOTE_ON, 1, 45, 100, 0.0f}};
+    plugin::PluginCore::Event cc = {0, {SynthEvent::CONTROL_CHANGE, 1, 74, 5, 0.0f}};
+    int cutoff = plugin::PluginCore::indexOfCC(74);
+    std::vector<float> outL[3], outR[3];
+    for (int run = 0; run < 3; run++) {
+      std::unique_ptr<plugin::PluginCore> core(new plugin::PluginCore);
+      core->activate(kSampleRate);
+      outL[run].assign(half * 2, 0.0f);
+      outR[run].assign(half * 2, 0.0f);
+      core->process(&note, 1, 130.0, outL[run].data(), outR[run].data(), half);
+      if (run == 0) std::thread([&] { core->setParameter(cutoff, 5); }).join();
+      core->process(&cc, run == 1 ? 1 : 0, 130.0, &outL[run][half], &outR[run][half], half);
+    }
+    int differ = 0, changed = 0;
+    for (int i = half; i < half * 2; i++) {
+      differ += (outL[0][i] != outL[1][i]) + (outR[0][i] != outR[1][i]);
+      changed += (outL[0][i] != outL[2][i]) + (outR[0][i] != outR[2][i]);
+    }
+    snprintf(detail, sizeof(detail), "cutoff 5 from another thread: %d samples differ from the CC event, %d from no change",
+             differ, changed);
+    ok &= report("lock-free parameter path", differ == 0 && changed > 0, detail);
+  }
+
+  // State: a saved patch restores every parameter
+  {
+    plugin::PluginCore a, b;
+    Rng rng{seed};
+    for (int i = 0; i < kParameterCount; i++) {
+      a.setParameter(i, (uint8_t)(kParameterMap[i].minVal + rng.range(kParameterMap[i].maxVal - kParameterMap[i].minVal + 1)));
+    }
+    bool loaded = b.loadState(a.saveState());
+    int differ = 0;
+    for (int i = 0; i < kParameterCount; i++) differ += a.getParameter(i) != b.getParameter(i);
+    snprintf(detail, sizeof(detail), "%d of %d parameters differ after load", differ, (int)kParameterCount);
+    ok &= report("state round trip", loaded && differ == 0, detail);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,486 @@
+/**
+ * @file pico303_renderd.cpp
+ * @brief Local render service: renders patch + MIDI pattern jobs sent over a
+ * UNIX socket and caches the results by content.
+ *
+ *   pico303_renderd --socket /tmp/pico303.sock --cache-dir ~/.cache/pico303
+ *   pico303_renderd --render --socket /tmp/pico303.sock --patch acid.txt song.mid > song.wav
+ *
+ * Every job is keyed by a hash of (Pico303Engine::renderVersion, sample
+ * rate, block size, tail, patch controllers, MIDI file bytes). A repeated job
+ * is answered from the memory or disk tier of the RenderCache without
+ * rendering; identical jobs that arrive while one is rendering wait for that
+ * render instead of starting their own. Misses run on the work-stealing
+ * ThreadPool, one engine per job.
+ *
+ * Protocol, one request per connection. Headers are text lines, payloads raw:
+ *   RENDER <patch bytes> <midi bytes> <tail ms>\n<patch text><SMF data>
+ *   STATS\n
+ * Reply:
+ *   OK <memory|disk|render|shared|stats> <bytes>\n<WAV file or stats text>
+ *   ERR <message>\n
+ */
+
+#include "batch/MidiFile.h"
+#include "batch/Patch.h"
+#include "batch/RenderCache.h"
+#include "batch/ThreadPool.h"
+#include "Pico303Engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBlockSize = 256;   // Same block size as the firmware default
+const size_t kMaxPatchBytes = 64 * 1024;
+const size_t kMaxMidiBytes = 16 * 1024 * 1024;
+
+// ---- Socket helpers ----
+
+bool readAll(int fd, void* buf, size_t n) {
+  uint8_t* p = (uint8_t*)buf;
+  while (n > 0) {
+    ssize_t r = read(fd, p, n);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return false;
+    p += r;
+    n -= (size_t)r;
+  }
+  return true;
+}
+
+bool writeAll(int fd, const void* buf, size_t n) {
+  const uint8_t* p = (const uint8_t*)buf;
+  while (n > 0) {
+    ssize_t w = write(fd, p, n);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return false;
+    p += w;
+    n -= (size_t)w;
+  }
+  return true;
+}
+
+bool readLine(int fd, std::string& line) {
+  line.clear();
+  char c;
+  while (line.size() < 256) {
+    if (!readAll(fd, &c, 1)) return false;
+    if (c == '\n') return true;
+    line += c;
+  }
+  return false;
+}
+
+bool writeReply(int fd, const std::string& source, const std::vector<uint8_t>& payload) {
+  std::string header = "OK " + source + " " + std::to_string(payload.size()) + "\n";
+  return writeAll(fd, header.data(), header.size()) && writeAll(fd, payload.data(), payload.size());
+}
+
+void writeError(int fd, const std::string& message) {
+  std::string line = "ERR " + message + "\n";
+  writeAll(fd, line.data(), line.size());
+}
+
+sockaddr_un socketAddress(const std::string& path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  return addr;
+}
+
+// ---- Jobs ----
+
+struct Request {
+  batch::Patch patch;
+  std::vector<uint8_t> midi;
+  uint32_t tailMs = 0;
+};
+
+struct Result {
+  batch::RenderCache::Data wav;
+  std::string error;
+};
+
+/**
+ * @brief Content key of a job: 128 bits from two independent FNV-1a passes.
+ */
+std::string jobKey(const Request& req) {
+  std::vector<uint8_t> bytes;
+  auto add32 = [&bytes](uint32_t v) {
+    for (int i = 0; i < 4; i++) bytes.push_back((v >> (8 * i)) & 0xFF);
+  };
+  const char tag[] = "pico303-render";
+  bytes.insert(bytes.end(), tag, tag + sizeof(tag));
+  add32(Pico303Engine::renderVersion);
+  add32(kSampleRate);
+  add32(kBlockSize);
+  add32(req.tailMs);
+  add32((uint32_t)req.patch.ccs.size());
+  for (const StressCC& c : req.patch.ccs) {
+    bytes.push_back(c.cc);
+    bytes.push_back(c.value);
+  }
+  add32((uint32_t)req.midi.size());
+  bytes.insert(bytes.end(), req.midi.begin(), req.midi.end());
+
+  uint64_t h[2] = {0xcbf29ce484222325ull, 0x84222325cbf29ce4ull};
+  for (uint8_t b : bytes) {
+    h[0] = (h[0] ^ b) * 0x100000001b3ull;
+    h[1] = (h[1] ^ (uint8_t)~b) * 0x100000001b3ull;
+  }
+  char hex[33];
+  snprintf(hex, sizeof(hex), "%016llx%016llx", (unsigned long long)h[0], (unsigned long long)h[1]);
+  return hex;
+}
+
+void putLE(std::vector<uint8_t>& out, size_t at, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) out[at + i] = (v >> (8 * i)) & 0xFF;
+}
+
+/**
+ * @brief Renders a job into a complete WAV file. Runs on a pool worker.
+ */
+Result renderRequest(const Request& req) {
+  Result result;
+  std::vector<batch::TimedEvent> events;
+  if (!batch::parseMidiFile(req.midi, "pattern", events, result.error)) return result;
+
+  std::unique_ptr<Pico303Engine> engine(new Pico303Engine);
+  if (!engine->begin(kSampleRate)) {
+    result.error = "delay buffer allocation failed";
+    return result;
+  }
+  for (const StressCC& c : req.patch.ccs) {
+    engine->apply({SynthEvent::CONTROL_CHANGE, 1, c.cc, c.value, 0.0f});
+  }
+
+  uint64_t endSample = (uint64_t)req.tailMs * kSampleRate / 1000;
+  if (!events.empty()) endSample += (uint64_t)(events.back().seconds * kSampleRate);
+  uint64_t frames = (endSample + kBlockSize - 1) / kBlockSize * kBlockSize;
+  if (frames * 4 > 0xFFFFFFFFull - 44) {
+    result.error = "render too long for a WAV file";
+    return result;
+  }
+
+  std::shared_ptr<std::vector<uint8_t>> wav(new std::vector<uint8_t>(44 + frames * 4));
+  std::vector<uint8_t>& w = *wav;
+  memcpy(&w[0], "RIFF", 4);
+  putLE(w, 4, (uint32_t)(36 + frames * 4), 4);
+  memcpy(&w[8], "WAVEfmt ", 8);
+  putLE(w, 16, 16, 4);
+  putLE(w, 20, 1, 2);                 // PCM
+  putLE(w, 22, 2, 2);                 // Stereo
+  putLE(w, 24, kSampleRate, 4);
+  putLE(w, 28, kSampleRate * 4, 4);   // Byte rate
+  putLE(w, 32, 4, 2);                 // Block align
+  putLE(w, 34, 16, 2);
+  memcpy(&w[36], "data", 4);
+  putLE(w, 40, (uint32_t)(frames * 4), 4);
+
+  int16_t block[kBlockSize * 2];
+  size_t next = 0;
+  for (uint64_t pos = 0; pos < frames; pos += kBlockSize) {
+    // Events take effect at the block boundary, like on the device
+    while (next < events.size() && (uint64_t)(events[next].seconds * kSampleRate) <= pos) {
+      engine->apply(events[next++].event);
+    }
+    engine->render(block, kBlockSize);
+    memcpy(&w[44 + pos * 4], block, sizeof(block));  // Host is little-endian
+  }
+  result.wav = wav;
+  return result;
+}
+
+// ---- Service ----
+
+struct Service {
+  batch::ThreadPool* pool;
+  batch::RenderCache* cache;
+  std::mutex inflightLock;
+  std::map<std::string, std::shared_future<Result>> inflight;
+  std::atomic<uint64_t> renders{0};
+  std::atomic<uint64_t> shared{0};
+};
+
+// Never destroyed: detached connection threads may still use it at exit
+Service& service = *new Service;
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) {
+  stopRequested = 1;
+}
+
+std::string statsText() {
+  batch::RenderCache::Stats s = service.cache->stats();
+  std::ostringstream out;
+  out << "engine_version " << Pico303Engine::renderVersion << "\n"
+      << "renders " << service.renders << "\n"
+      << "shared " << service.shared << "\n"
+      << "hits_memory " << s.hits[batch::RenderCache::MEMORY] << "\n"
+      << "hits_disk " << s.hits[batch::RenderCache::DISK] << "\n"
+      << "misses " << s.hits[batch::RenderCache::MISS] << "\n"
+      << "memory_entries " << s.memoryEntries << "\n"
+      << "memory_bytes " << s.memoryBytes << "\n"
+      << "disk_entries " << s.diskEntries << "\n"
+      << "disk_bytes " << s.diskBytes << "\n"
+      << "evictions " << s.evictions << "\n";
+  return out.str();
+}
+
+/**
+ * @brief Reads a RENDER request body after its header line.
+ */
+bool readRequest(int fd, const std::string& header, Request& req, std::string& error) {
+  std::istringstream ss(header);
+  std::string verb;
+  size_t patchBytes = 0, midiBytes = 0;
+  if (!(ss >> verb >> patchBytes >> midiBytes >> req.tailMs) || patchBytes > kMaxPatchBytes ||
+      midiBytes > kMaxMidiBytes || req.tailMs > 600000) {
+    error = "bad RENDER header";
+    return false;
+  }
+  std::string patchText(patchBytes, '\0');
+  req.midi.resize(midiBytes);
+  if (!readAll(fd, &patchText[0], patchBytes) || !readAll(fd, req.midi.data(), midiBytes)) {
+    error = "short request";
+    return false;
+  }
+  std::istringstream patchIn(patchText);
+  return batch::parsePatch(patchIn, "patch", req.patch, error);
+}
+
+void serve(int fd) {
+  std::string header;
+  std::string error;
+  Request req;
+  if (!readLine(fd, header)) {
+    close(fd);
+    return;
+  }
+  if (header == "STATS") {
+    std::string text = statsText();
+    writeReply(fd, "stats", std::vector<uint8_t>(text.begin(), text.end()));
+    close(fd);
+    return;
+  }
+  if (header.compare(0, 7, "RENDER ") != 0) {
+    writeError(fd, "unknown request");
+    close(fd);
+    return;
+  }
+  if (!readRequest(fd, header, req, error)) {
+    writeError(fd, error);
+    close(fd);
+    return;
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  std::string key = jobKey(req);
+  batch::RenderCache::Data wav;
+  batch::RenderCache::Tier tier = service.cache->get(key, wav);
+  std::string source = tier == batch::RenderCache::MEMORY ? "memory" : "disk";
+  if (tier == batch::RenderCache::MISS) {
+    std::shared_future<Result> pending;
+    {
+      std::lock_guard<std::mutex> guard(service.inflightLock);
+      auto it = service.inflight.find(key);
+      if (it != service.inflight.end()) {
+        pending = it->second;
+        source = "shared";
+        service.shared++;
+      } else {
+        std::shared_ptr<std::promise<Result>> promise(new std::promise<Result>);
+        pending = promise->get_future().share();
+        service.inflight[key] = pending;
+        source = "render";
+        service.renders++;
+        std::shared_ptr<Request> job(new Request(std::move(req)));
+        service.pool->submit([promise, job, key] {
+          Result r = renderRequest(*job);
+          if (r.error.empty()) service.cache->put(key, r.wav);
+          {
+            std::lock_guard<std::mutex> guard(service.inflightLock);
+            service.inflight.erase(key);
+          }
+          promise->set_value(r);
+        });
+      }
+    }
+    const Result& r = pending.get();
+    if (!r.error.empty()) {
+      writeError(fd, r.error);
+      close(fd);
+      return;
+    }
+    wav = r.wav;
+  }
+  writeReply(fd, source, *wav);
+  close(fd);
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  fprintf(stderr, "%s %-6s %8.1f KB %9.2f ms\n", key.c_str(), source.c_str(), wav->size() / 1024.0, ms);
+}
+
+// ---- Client ----
+
+int runClient(const std::string& socketPath, const std::string& patchPath, const std::string& midiPath,
+              uint32_t tailMs, bool stats) {
+  std::string request;
+  if (stats) {
+    request = "STATS\n";
+  } else {
+    std::string patchText;
+    if (!patchPath.empty()) {
+      std::ifstream in(patchPath);
+      if (!in) {
+        fprintf(stderr, "cannot open %s\n", patchPath.c_str());
+        return 1;
+      }
+      patchText.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::ifstream midi(midiPath, std::ios::binary);
+    if (!midi) {
+      fprintf(stderr, "cannot open %s\n", midiPath.c_str());
+      return 1;
+    }
+    std::string midiData((std::istreambuf_iterator<char>(midi)), std::istreambuf_iterator<char>());
+    request = "RENDER " + std::to_string(patchText.size()) + " " + std::to_string(midiData.size()) + " " +
+              std::to_string(tailMs) + "\n" + patchText + midiData;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = socketAddress(socketPath);
+  if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    fprintf(stderr, "cannot connect to %s\n", socketPath.c_str());
+    return 1;
+  }
+  auto t0 = std::chrono::steady_clock::now();
+  std::string header;
+  if (!writeAll(fd, request.data(), request.size()) || !readLine(fd, header)) {
+    fprintf(stderr, "no reply\n");
+    return 1;
+  }
+  std::istringstream ss(header);
+  std::string status, source;
+  size_t bytes = 0;
+  if (!(ss >> status >> source >> bytes) || status != "OK") {
+    fprintf(stderr, "%s\n", header.c_str());
+    return 1;
+  }
+  std::vector<uint8_t> payload(bytes);
+  if (!readAll(fd, payload.data(), bytes)) {
+    fprintf(stderr, "short reply\n");
+    return 1;
+  }
+  close(fd);
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  if (!writeAll(STDOUT_FILENO, payload.data(), payload.size())) return 1;
+  if (!stats) fprintf(stderr, "%s, %.1f KB in %.2f ms\n", source.c_str(), bytes / 1024.0, ms);
+  return 0;
+}
+
+void usage(const char* argv0) {
+  fprintf(stderr,
+          "Usage: %s [options]                        run the service\n"
+          "       %s --render [--patch FILE] [--tail SEC] file.mid > out.wav\n"
+          "       %s --stats\n"
+          "  --socket PATH     UNIX socket (default /tmp/pico303.sock)\n"
+          "  --threads N       render workers (default: all cores)\n"
+          "  --memory MB       memory cache budget (default 256)\n"
+          "  --cache-dir DIR   disk cache location (default: memory only)\n"
+          "  --disk MB         disk cache budget (default 4096)\n",
+          argv0, argv0, argv0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string socketPath = "/tmp/pico303.sock";
+  std::string cacheDir;
+  std::string patchPath;
+  std::string midiPath;
+  unsigned threads = 0;
+  double memoryMb = 256.0;
+  double diskMb = 4096.0;
+  double tailSeconds = 2.0;
+  bool client = false;
+  bool stats = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--socket" && hasValue) socketPath = argv[++i];
+    else if (arg == "--threads" && hasValue) threads = (unsigned)std::max(0, atoi(argv[++i]));
+    else if (arg == "--memory" && hasValue) memoryMb = std::max(0.0, atof(argv[++i]));
+    else if (arg == "--cache-dir" && hasValue) cacheDir = argv[++i];
+    else if (arg == "--disk" && hasValue) diskMb = std::max(0.0, atof(argv[++i]));
+    else if (arg == "--render") client = true;
+    else if (arg == "--stats") stats = true;
+    else if (arg == "--patch" && hasValue) patchPath = argv[++i];
+    else if (arg == "--tail" && hasValue) tailSeconds = std::max(0.0, atof(argv[++i]));
+    else if (!arg.empty() && arg[0] != '-' && midiPath.empty()) midiPath = arg;
+    else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (stats || client) {
+    if (client && midiPath.empty()) {
+      usage(argv[0]);
+      return 2;
+    }
+    return runClient(socketPath, patchPath, midiPath, (uint32_t)(tailSeconds * 1000.0), stats);
+  }
+
+  service.pool = new batch::ThreadPool(threads);
+  service.cache = new batch::RenderCache((uint64_t)(memoryMb * 1048576.0), cacheDir, (uint64_t)(diskMb * 1048576.0));
+
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = socketAddress(socketPath);
+  unlink(socketPath.c_str());
+  if (listenFd < 0 || bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 64) != 0) {
+    fprintf(stderr, "cannot listen on %s\n", socketPath.c_str());
+    return 1;
+  }
+
+  // No SA_RESTART, so a signal breaks accept() out
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = onSignal;
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  batch::RenderCache::Stats s = service.cache->stats();
+  fprintf(stderr, "listening on %s, %u workers, cache: %zu entries (%.1f MB) on disk\n", socketPath.c_str(),
+          service.pool->size(), s.diskEntries, s.diskBytes / 1048576.0);
+  while (!stopRequested) {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) continue;
+    std::thread(serve, fd).detach();
+  }
+
+  close(listenFd);
+  unlink(socketPath.c_str());
+  fprintf(stderr, "%s", statsText().c_str());
+  return 0;
+}
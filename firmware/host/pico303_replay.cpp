@@ -0,0 +1,203 @@
+/**
+ * @file pico303_replay.cpp
+ * @brief Replays an event trace dumped by the firmware (SYSEX_TRACE_REQUEST)
+ * through the sketch's render path, block by block.
+ *
+ * Events are applied at the sample positions where they took effect on the
+ * device, so a complete trace reproduces the audio exactly (for the same
+ * build flags and float behaviour). Each block is timed on the host for
+ * offline profiling of the passages that glitched.
+ */
+
+#include "sim/SimHost.h"
+#include "sim/SimRunner.h"
+#include "SketchHooks.h"
+#include "SynthEvent.h"
+#include "SysExProtocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Trace {
+  uint8_t flags = 0;
+  uint32_t sampleRate = 0;
+  uint32_t blockSize = 0;
+  uint32_t start = 0;
+  uint32_t end = 0;
+  uint32_t count = 0;
+  uint32_t bpmBits = 0;
+  bool ccSet[128] = {};
+  uint8_t cc[128] = {};
+  std::vector<std::pair<uint32_t, SynthEvent>> events;
+  bool haveHeader = false;
+};
+
+float floatFromBits(uint32_t bits) {
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+/**
+ * @brief Parses a .syx file holding TRACE_HEADER and TRACE_EVENTS messages.
+ */
+bool loadTrace(const std::string& path, Trace& trace, std::string& error) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+  fclose(f);
+
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t endPos = pos;
+    while (endPos < data.size() && data[endPos] != 0xF7) endPos++;
+    if (endPos == data.size()) break;
+    const uint8_t* msg = &data[pos];
+    unsigned size = (unsigned)(endPos - pos + 1);
+    pos = endPos + 1;
+    if (!sysexIsOurs(msg, size)) continue;
+
+    const uint8_t* p = msg + SYSEX_HEADER_SIZE;
+    if (msg[4] == SYSEX_TRACE_HEADER && size >= SYSEX_HEADER_SIZE + 24 + 19 + 128 + 1) {
+      trace.flags = p[0];
+      trace.sampleRate = sysexRead(p + 1, 4);
+      trace.blockSize = sysexRead(p + 5, 2);
+      trace.start = sysexRead(p + 7, 5);
+      trace.end = sysexRead(p + 12, 5);
+      trace.count = sysexRead(p + 17, 2);
+      trace.bpmBits = sysexRead(p + 19, 5);
+      for (int cc = 0; cc < 128; cc++) {
+        trace.ccSet[cc] = (p[24 + cc / 7] >> (cc % 7)) & 1;
+        trace.cc[cc] = p[24 + 19 + cc];
+      }
+      trace.haveHeader = true;
+    } else if (msg[4] == SYSEX_TRACE_EVENTS && size >= SYSEX_HEADER_SIZE + 3 + 1) {
+      uint32_t first = sysexRead(p, 2);
+      unsigned count = p[2];
+      if (size < SYSEX_HEADER_SIZE + 3 + count * 14 + 1 || first != trace.events.size()) {
+        error = "trace events out of order or truncated";
+        return false;
+      }
+      p += 3;
+      for (unsigned i = 0; i < count; i++, p += 14) {
+        SynthEvent ev;
+        ev.type = (SynthEvent::Type)p[5];
+        ev.channel = p[6];
+        ev.data1 = p[7];
+        ev.data2 = p[8];
+        ev.value = floatFromBits(sysexRead(p + 9, 5));
+        trace.events.push_back({sysexRead(p, 5), ev});
+      }
+    }
+  }
+
+  if (!trace.haveHeader) {
+    error = "no trace header in " + path;
+    return false;
+  }
+  if (trace.events.size() != trace.count) {
+    error = "trace has " + std::to_string(trace.events.size()) + " of " + std::to_string(trace.count) + " events";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string tracePath, wavPath, timesPath;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--wav" && hasValue) wavPath = argv[++i];
+    else if (arg == "--times" && hasValue) timesPath = argv[++i];
+    else if (arg[0] != '-' && tracePath.empty()) tracePath = arg;
+    else tracePath.clear(), i = argc;
+  }
+  if (tracePath.empty()) {
+    fprintf(stderr, "Usage: %s <trace.syx> [--wav out.wav] [--times blocks.csv]\n", argv[0]);
+    return 2;
+  }
+
+  Trace trace;
+  std::string error;
+  if (!loadTrace(tracePath, trace, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 2;
+  }
+
+  sim::Runner runner;
+  runner.boot();
+
+  // Settings from before the recorded window
+  for (int cc = 0; cc < 128; cc++) {
+    if (trace.ccSet[cc]) applyEvent({SynthEvent::CONTROL_CHANGE, 1, (uint8_t)cc, trace.cc[cc], 0.0f});
+  }
+  if (trace.bpmBits) applyEvent({SynthEvent::TEMPO, 0, 0, 0, floatFromBits(trace.bpmBits)});
+
+  sim::WavWriter wav;
+  if (!wavPath.empty() && !wav.open(wavPath, trace.sampleRate)) {
+    fprintf(stderr, "cannot write %s\n", wavPath.c_str());
+    return 2;
+  }
+  FILE* times = timesPath.empty() ? nullptr : fopen(timesPath.c_str(), "w");
+  if (times) fprintf(times, "block,sample,events,render_ns\n");
+
+  uint32_t base = samplesRendered;
+  size_t next = 0;
+  uint64_t blocks = 0, totalNs = 0, maxNs = 0, worstBlock = 0;
+  uint64_t minNs = UINT64_MAX;
+  for (uint32_t pos = trace.start; pos < trace.end; blocks++) {
+    int applied = 0;
+    while (next < trace.events.size() && trace.events[next].first <= pos) {
+      applyEvent(trace.events[next++].second);
+      applied++;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    renderBlock();
+    auto t1 = std::chrono::steady_clock::now();
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+
+    uint32_t block = samplesRendered - base;
+    base = samplesRendered;
+    if (block != trace.blockSize) {
+      fprintf(stderr, "trace was recorded with %u-sample blocks, this build renders %u\n", trace.blockSize, block);
+      return 2;
+    }
+
+    wav.write(renderedBlock(), block * 2);
+    if (times) fprintf(times, "%llu,%u,%d,%llu\n", (unsigned long long)blocks, pos, applied, (unsigned long long)ns);
+    totalNs += ns;
+    minNs = std::min(minNs, ns);
+    if (ns > maxNs) {
+      maxNs = ns;
+      worstBlock = blocks;
+    }
+    pos += block;
+  }
+  wav.close();
+  if (times) fclose(times);
+
+  double seconds = (double)(trace.end - trace.start) / trace.sampleRate;
+  printf("trace              %zu events, %.2f s, %s\n", trace.events.size(), seconds,
+         (trace.flags & TRACE_COMPLETE) ? "complete (exact from power-on)" : "windowed (voice state before start not captured)");
+  if (blocks) {
+    printf("render per block   min %.1f  mean %.1f  max %.1f us (host)\n", minNs / 1e3, totalNs / 1e3 / blocks,
+           maxNs / 1e3);
+    printf("worst block        #%llu at %.3f s\n", (unsigned long long)worstBlock,
+           (double)worstBlock * trace.blockSize / trace.sampleRate);
+  }
+  return 0;
+}
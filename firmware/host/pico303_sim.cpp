@@ -0,0 +1,161 @@
+/**
+ * @file pico303_sim.cpp
+ * @brief Runs the unmodified pico-303 sketch on the host against simulated hardware.
+ *
+ * The scheduler interleaves loop() and loop1() in virtual time, feeds scripted
+ * MIDI/encoder input and reports I2S underruns, loop latency and bus traffic.
+ */
+
+#include "sim/SimHost.h"
+#include "sim/SimRunner.h"
+#include "SysExProtocol.h"
+#include "Arena.h"
+#include "AudioTap.h"
+#include "DeferredLog.h"
+#include "FixedFFT.h"
+#include "Pico303Engine.h"
+#include "ScopeStreamer.h"
+#include "TraceRecorder.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using sim::host;
+
+// Sketch globals, for the memory report
+extern Arena dspArena;
+extern Arena hotArena;
+extern Pico303Engine engine;
+extern AudioTap audioTap;
+extern FixedFFT scopeFFT;
+extern ScopeStreamer scopeStreamer;
+extern TraceRecorder traceRecorder;
+extern DeferredLog eventLog;
+
+/**
+ * @brief Prints the arena maps after setup() and the largest fixed-size
+ * objects (host sizes; pointers are 8 bytes here, 4 on the device).
+ * @return false if an arena overflowed
+ */
+static bool printMemoryReport() {
+  auto line = [](const char* text) { printf("%s\n", text); };
+  printf("arena  offset    bytes  owner\n");
+  hotArena.report(line);
+  dspArena.report(line);
+  printf("\nstatic objects\n");
+  printf("  %-22s %8zu\n", "Pico303Engine engine", sizeof(engine));
+  printf("    %-20s %8zu  (%zu cache lines of 64)\n", "hot voice state", engine.hotStateBytes(),
+         (engine.hotStateBytes() + 63) / 64);
+  printf("  %-22s %8zu\n", "AudioTap audioTap", sizeof(audioTap));
+  printf("  %-22s %8zu\n", "FixedFFT scopeFFT", sizeof(scopeFFT));
+  printf("  %-22s %8zu\n", "ScopeStreamer", sizeof(scopeStreamer));
+  printf("  %-22s %8zu\n", "TraceRecorder", sizeof(traceRecorder));
+  printf("  %-22s %8zu\n", "DeferredLog eventLog", sizeof(eventLog));
+  size_t total = hotArena.capacity() + dspArena.capacity() + sizeof(engine) + sizeof(audioTap) + sizeof(scopeFFT) +
+                 sizeof(scopeStreamer) + sizeof(traceRecorder) + sizeof(eventLog);
+  printf("\ntotal                    %8zu of 532480 bytes SRAM (%.0f%%)\n", total, total * 100.0 / 532480);
+  return !hotArena.overflowed() && !dspArena.overflowed();
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --script <file>     Input events (see sim/SimScript.cpp)\n"
+          "  --duration <ms>     Simulated time (default 5000)\n"
+          "  --render-us <us>    Render cost per stereo frame (default 6.0)\n"
+          "  --loop-us <us>      Overhead per loop pass (default 2.0)\n"
+          "  --i2c-hz <hz>       Display bus clock for DMA transfers (default 400000)\n"
+          "  --wav <file>        Write the played I2S stream (including underrun silence)\n"
+          "  --trace-out <file>  Request the firmware's event trace at the end and save it (.syx)\n"
+          "  --fail-on-underrun  Exit with status 1 if the FIFO ever ran dry\n"
+          "  --memory            Print the RAM map after setup() and exit\n",
+          argv0);
+}
+
+int main(int argc, char** argv) {
+  std::string scriptPath, wavPath, tracePath;
+  double durationMs = 5000.0;
+  bool failOnUnderrun = false;
+  bool memoryReport = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--script" && hasValue) scriptPath = argv[++i];
+    else if (arg == "--duration" && hasValue) durationMs = atof(argv[++i]);
+    else if (arg == "--render-us" && hasValue) host.cost.renderNsPerFrame = (uint64_t)(atof(argv[++i]) * 1000.0);
+    else if (arg == "--loop-us" && hasValue) host.cost.loopOverheadNs = (uint64_t)(atof(argv[++i]) * 1000.0);
+    else if (arg == "--i2c-hz" && hasValue) host.cost.i2cHz = (uint32_t)atol(argv[++i]);
+    else if (arg == "--wav" && hasValue) wavPath = argv[++i];
+    else if (arg == "--trace-out" && hasValue) tracePath = argv[++i];
+    else if (arg == "--fail-on-underrun") failOnUnderrun = true;
+    else if (arg == "--memory") memoryReport = true;
+    else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (!scriptPath.empty()) {
+    std::string error;
+    if (!sim::loadScript(scriptPath, host.script, error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 2;
+    }
+  }
+
+  sim::WavWriter wav;
+  if (!wavPath.empty()) {
+    if (!wav.open(wavPath, 44100)) {
+      fprintf(stderr, "cannot write %s\n", wavPath.c_str());
+      return 2;
+    }
+    host.i2s.sinks.push_back([&wav](const int16_t* frames, size_t count, uint64_t) { wav.write(frames, count * 2); });
+  }
+
+  sim::Runner runner;
+  runner.boot();
+  if (memoryReport) return printMemoryReport() ? 0 : 1;
+  bool dualCore = runner.isDualCore();
+  const uint64_t endNs = (uint64_t)(durationMs * 1e6);
+  runner.runUntil(endNs);
+
+  // --- Report ---
+  const sim::I2SModel& i2s = host.i2s;
+  const sim::Stats& s = host.stats;
+  double bufferMs = i2s.capacity * 1000.0 / i2s.sampleRate;
+  printf("mode               %s\n", dualCore ? "DUAL_CORE" : "single core");
+  printf("simulated          %.0f ms\n", durationMs);
+  printf("loop passes        core0 %llu, core1 %llu\n", (unsigned long long)s.loopPasses[0],
+         (unsigned long long)s.loopPasses[1]);
+  printf("max loop() pass    %.3f ms\n", s.maxLoopGapNs / 1e6);
+  printf("i2s buffer         %zu frames (%.1f ms)\n", i2s.capacity, bufferMs);
+  printf("i2s min fill       %zu frames\n", i2s.minFill == SIZE_MAX ? (size_t)0 : i2s.minFill);
+  printf("block interval     min %.1f avg %.1f max %.1f stddev %.2f us (%llu writes)\n",
+         i2s.intervals ? i2s.minIntervalNs / 1e3 : 0.0, i2s.intervalMeanNs / 1e3, i2s.maxIntervalNs / 1e3,
+         i2s.intervalStddevNs() / 1e3, (unsigned long long)i2s.intervals);
+  printf("underruns          %llu (%llu frames)\n", (unsigned long long)i2s.underrunEvents,
+         (unsigned long long)i2s.underrunFrames);
+  printf("midi in/out        %llu / %llu (%llu sysex, %llu bytes)\n", (unsigned long long)s.midiIn,
+         (unsigned long long)s.midiOut, (unsigned long long)s.sysexOut, (unsigned long long)s.sysexOutBytes);
+  printf("display bytes      %llu (blocking %.1f ms)\n", (unsigned long long)s.displayBytes, s.blockingI2cNs / 1e6);
+
+  if (!tracePath.empty()) {
+    // Ask for the dump like the web controller would, and keep running until it is sent
+    FILE* f = fopen(tracePath.c_str(), "wb");
+    if (!f) {
+      fprintf(stderr, "cannot write %s\n", tracePath.c_str());
+      return 2;
+    }
+    host.midiOutHook = [f](const std::vector<uint8_t>& msg, uint64_t) {
+      if (msg.size() > 5 && msg[0] == 0xF0 && (msg[4] == SYSEX_TRACE_HEADER || msg[4] == SYSEX_TRACE_EVENTS))
+        fwrite(msg.data(), 1, msg.size(), f);
+    };
+    host.midiInbox.push_back({0xF0, SYSEX_MANUFACTURER_ID, SYSEX_DEVICE_ID_0, SYSEX_DEVICE_ID_1, SYSEX_TRACE_REQUEST, 0xF7});
+    runner.runUntil(endNs + 1000000000ULL);
+    fclose(f);
+  }
+  wav.close();
+
+  return (failOnUnderrun && i2s.underrunEvents > 0) ? 1 : 0;
+}
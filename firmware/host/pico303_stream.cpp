@@ -0,0 +1,349 @@
+/**
+ * @file pico303_stream.cpp
+ * @brief Real-time streaming renderer: MIDI on stdin, raw PCM on stdout.
+ *
+ * Reads a live MIDI byte stream (or, with --timed, lines of timestamped
+ * events) from stdin and writes interleaved 16-bit stereo PCM at 44.1 kHz to
+ * stdout, rendered by Pico303Engine like fillAudioBlock() on the device:
+ *
+ *   cat /dev/snd/midiC1D0 | pico303_stream | aplay -f S16_LE -c 2 -r 44100 -B 20000
+ *   pico303_stream --timed --freerun < song.txt | ffmpeg -f s16le -ac 2 -ar 44100 -i - song.flac
+ *
+ * Three threads, connected by the firmware's SpscQueue:
+ *   reader  stdin -> event queue (may block on read)
+ *   render  event queue -> engine -> PCM queue (never blocks or allocates)
+ *   writer  PCM queue -> stdout (may block on write)
+ *
+ * The render thread stays at most --latency ahead of the wall clock. If the
+ * writer falls behind and the PCM queue is full, the block is dropped and
+ * counted as an overrun instead of stalling the render. With --freerun
+ * there is no pacing and the render waits for the writer (offline use).
+ *
+ * --timed lines use the simulator script syntax, times in milliseconds:
+ *   <ms> note_on <ch> <note> <vel> | note_off <ch> <note> | cc <ch> <cc> <value> | tempo <bpm>
+ *
+ * Every --report seconds a status line goes to stderr: real-time factor of
+ * the render (audio time per render time), worst block time against the
+ * block budget, queued output and overruns.
+ */
+
+#include "batch/MidiStream.h"
+#include "Pico303Engine.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int kSampleRate = 44100;
+const int kMaxBlock = 1024;
+const int kPcmSlots = 64;
+
+struct StreamEvent {
+  uint64_t sample;  ///< Apply at the first block starting at or after this frame
+  SynthEvent event;
+};
+
+struct PcmBlock {
+  int frames;
+  int16_t samples[kMaxBlock * 2];
+};
+
+// Queues are globals so their storage is reserved before anything runs
+SpscQueue<StreamEvent, 1024> eventQueue;
+SpscQueue<PcmBlock, kPcmSlots> pcmQueue;
+
+std::atomic<bool> inputDone{false};
+std::atomic<bool> renderDone{false};
+std::atomic<bool> outputClosed{false};
+std::atomic<uint64_t> inputHorizon{0};  // --timed: latest timestamp read so far
+
+// Render statistics, written by the render thread and read by the reporter
+std::atomic<uint64_t> framesRendered{0};
+std::atomic<uint64_t> framesWritten{0};
+std::atomic<uint64_t> renderNanos{0};
+std::atomic<uint64_t> worstBlockNanos{0};
+std::atomic<uint32_t> overruns{0};
+
+struct Options {
+  int blockFrames = 256;        // Same block size as the firmware default
+  double latencyMs = 50.0;
+  double tailSeconds = 2.0;
+  double reportSeconds = 1.0;
+  bool timed = false;
+  bool freerun = false;
+};
+
+void pushEvent(const StreamEvent& ev) {
+  // The reader may wait; only the render side must not
+  while (!eventQueue.push(ev)) {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+}
+
+/**
+ * @brief Reads raw MIDI from stdin. Clock pulses become TEMPO events, measured
+ * per quarter note like handleClock() on the device.
+ */
+void readMidi() {
+  batch::MidiStreamParser parser;
+  uint32_t clockTicks = 0;
+  Clock::time_point lastQuarter = Clock::now();
+  uint8_t buf[256];
+  for (;;) {
+    ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    for (ssize_t i = 0; i < n; i++) {
+      SynthEvent ev;
+      batch::MidiStreamParser::Result r = parser.feed(buf[i], ev);
+      if (r == batch::MidiStreamParser::EVENT) {
+        pushEvent({0, ev});
+      } else if (r == batch::MidiStreamParser::CLOCK && ++clockTicks % 24 == 0) {
+        Clock::time_point now = Clock::now();
+        double seconds = std::chrono::duration<double>(now - lastQuarter).count();
+        lastQuarter = now;
+        if (seconds > 0.0) pushEvent({0, {SynthEvent::TEMPO, 0, 0, 0, (float)(60.0 / seconds)}});
+      }
+    }
+  }
+  inputDone = true;
+}
+
+/**
+ * @brief Reads timestamped event lines from stdin.
+ */
+void readTimed() {
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(std::cin, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream ss(line);
+    double ms;
+    std::string cmd;
+    if (!(ss >> ms)) continue;  // Blank line
+    ss >> cmd;
+    StreamEvent ev;
+    ev.sample = (uint64_t)(std::max(0.0, ms) * kSampleRate / 1000.0);
+    int ch = 0, a = 0, b = 0;
+    float bpm = 0.0f;
+    bool ok = true;
+    if (cmd == "note_on" && (ss >> ch >> a >> b)) {
+      ev.event = {b > 0 ? SynthEvent::NOTE_ON : SynthEvent::NOTE_OFF, (uint8_t)ch, (uint8_t)(a & 0x7F), (uint8_t)(b & 0x7F), 0.0f};
+    } else if (cmd == "note_off" && (ss >> ch >> a)) {
+      ev.event = {SynthEvent::NOTE_OFF, (uint8_t)ch, (uint8_t)(a & 0x7F), 0, 0.0f};
+    } else if (cmd == "cc" && (ss >> ch >> a >> b)) {
+      ev.event = {SynthEvent::CONTROL_CHANGE, (uint8_t)ch, (uint8_t)(a & 0x7F), (uint8_t)(b & 0x7F), 0.0f};
+    } else if (cmd == "tempo" && (ss >> bpm)) {
+      ev.event = {SynthEvent::TEMPO, 0, 0, 0, bpm};
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      fprintf(stderr, "stdin:%d: cannot parse '%s'\n", lineNo, line.c_str());
+      continue;
+    }
+    pushEvent(ev);
+    inputHorizon = std::max(inputHorizon.load(), ev.sample);
+  }
+  inputDone = true;
+}
+
+/**
+ * @brief The render loop. Everything it touches is allocated before it starts.
+ */
+void renderLoop(Pico303Engine& engine, const Options& opt) {
+  const uint64_t latencyFrames = (uint64_t)(opt.latencyMs * kSampleRate / 1000.0);
+  const uint64_t tailFrames = (uint64_t)(opt.tailSeconds * kSampleRate);
+  const Clock::time_point start = Clock::now();
+  static PcmBlock block;
+  StreamEvent pending;
+  bool havePending = false;
+  uint64_t pos = 0;
+  uint64_t endPos = UINT64_MAX;
+
+  while (pos < endPos && !outputClosed) {
+    if (!opt.freerun && pos > latencyFrames) {
+      // Stay at most latencyFrames ahead of real time
+      std::this_thread::sleep_until(start + std::chrono::nanoseconds((pos - latencyFrames) * 1000000000ull / kSampleRate));
+    }
+    if (opt.freerun && opt.timed) {
+      // Offline: only render once the input covers this block
+      while (!inputDone && inputHorizon <= pos) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    // Events take effect at the block boundary, like on the device
+    bool done = inputDone;
+    for (;;) {
+      if (!havePending) havePending = eventQueue.pop(pending);
+      if (!havePending || pending.sample > pos) break;
+      engine.apply(pending.event);
+      havePending = false;
+    }
+    if (done && !havePending && endPos == UINT64_MAX) endPos = pos + tailFrames;
+
+    Clock::time_point t0 = Clock::now();
+    engine.render(block.samples, opt.blockFrames);
+    uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+    block.frames = opt.blockFrames;
+    renderNanos += nanos;
+    if (nanos > worstBlockNanos) worstBlockNanos = nanos;
+
+    if (opt.freerun) {
+      while (!pcmQueue.push(block) && !outputClosed) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    } else if (!pcmQueue.push(block)) {
+      overruns++;
+    }
+    pos += opt.blockFrames;
+    framesRendered = pos;
+  }
+  renderDone = true;
+}
+
+/**
+ * @brief Drains the PCM queue to stdout.
+ */
+void writeLoop() {
+  static PcmBlock block;
+  for (;;) {
+    bool done = renderDone;
+    if (!pcmQueue.pop(block)) {
+      if (done) break;
+      std::this_thread::sleep_for(std::chrono::microseconds(250));
+      continue;
+    }
+    const char* p = (const char*)block.samples;
+    size_t left = (size_t)block.frames * 4;
+    while (left > 0) {
+      ssize_t n = write(STDOUT_FILENO, p, left);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        outputClosed = true;  // Reader went away (EPIPE)
+        return;
+      }
+      p += n;
+      left -= (size_t)n;
+    }
+    framesWritten += block.frames;
+  }
+}
+
+/**
+ * @brief Keeps the stdout pipe from adding more latency than asked for.
+ * @return Pipe capacity in bytes, or 0 if stdout is not a pipe
+ */
+int limitPipeBuffer(uint64_t latencyFrames) {
+  struct stat st;
+  if (fstat(STDOUT_FILENO, &st) != 0 || !S_ISFIFO(st.st_mode)) return 0;
+#ifdef F_SETPIPE_SZ
+  fcntl(STDOUT_FILENO, F_SETPIPE_SZ, (int)std::max<uint64_t>(4096, latencyFrames * 4));
+#endif
+#ifdef F_GETPIPE_SZ
+  return fcntl(STDOUT_FILENO, F_GETPIPE_SZ);
+#else
+  return 0;
+#endif
+}
+
+void usage(const char* argv0) {
+  fprintf(stderr,
+          "Usage: %s [options] < midi > pcm\n"
+          "  --timed        stdin holds timestamped event lines, not raw MIDI\n"
+          "  --freerun      render as fast as the output takes it (no pacing)\n"
+          "  --latency MS   how far the render may run ahead of real time (default 50)\n"
+          "  --block N      frames per block, up to %d (default 256)\n"
+          "  --tail SEC     keep rendering after stdin ends (default 2)\n"
+          "  --report SEC   status interval on stderr, 0 = off (default 1)\n"
+          "Output: signed 16-bit little-endian stereo, %d Hz\n",
+          argv0, kMaxBlock, kSampleRate);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--timed") opt.timed = true;
+    else if (arg == "--freerun") opt.freerun = true;
+    else if (arg == "--latency" && hasValue) opt.latencyMs = std::max(0.0, atof(argv[++i]));
+    else if (arg == "--block" && hasValue) opt.blockFrames = std::min(kMaxBlock, std::max(16, atoi(argv[++i])));
+    else if (arg == "--tail" && hasValue) opt.tailSeconds = std::max(0.0, atof(argv[++i]));
+    else if (arg == "--report" && hasValue) opt.reportSeconds = std::max(0.0, atof(argv[++i]));
+    else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (isatty(STDOUT_FILENO)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  // The PCM queue bounds how much audio can wait for the writer
+  double maxLatencyMs = 1000.0 * kPcmSlots * opt.blockFrames / kSampleRate;
+  if (opt.latencyMs > maxLatencyMs) {
+    fprintf(stderr, "latency limited to %.0f ms at this block size\n", maxLatencyMs);
+    opt.latencyMs = maxLatencyMs;
+  }
+  uint64_t latencyFrames = (uint64_t)(opt.latencyMs * kSampleRate / 1000.0);
+  int pipeBytes = limitPipeBuffer(latencyFrames);
+
+  signal(SIGPIPE, SIG_IGN);
+  static Pico303Engine engine;
+  if (!engine.begin(kSampleRate)) {
+    fprintf(stderr, "delay buffer allocation failed\n");
+    return 1;
+  }
+  fprintf(stderr, "streaming: block %d frames (%.2f ms), latency %.1f ms, pipe %d bytes%s\n",
+          opt.blockFrames, 1000.0 * opt.blockFrames / kSampleRate, opt.latencyMs, pipeBytes,
+          opt.freerun ? ", free-running" : "");
+
+  // Nobody waits for the reader: it can sit in read() after the output closes
+  std::thread(opt.timed ? readTimed : readMidi).detach();
+  std::thread render(renderLoop, std::ref(engine), std::cref(opt));
+  std::thread writer(writeLoop);
+
+  const double budgetMs = 1000.0 * opt.blockFrames / kSampleRate;
+  uint64_t lastFrames = 0;
+  uint64_t lastNanos = 0;
+  while (!renderDone) {
+    if (opt.reportSeconds <= 0.0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      continue;
+    }
+    Clock::time_point wake = Clock::now() + std::chrono::microseconds((int64_t)(opt.reportSeconds * 1e6));
+    while (!renderDone && Clock::now() < wake) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    uint64_t frames = framesRendered;
+    uint64_t nanos = renderNanos;
+    uint64_t written = framesWritten;
+    double audio = (double)(frames - lastFrames) / kSampleRate;
+    double busy = (nanos - lastNanos) * 1e-9;
+    fprintf(stderr, "%8.1f s  RTF %7.1f  worst block %6.3f / %.3f ms  queued %6.1f ms  overruns %u\n",
+            (double)frames / kSampleRate, busy > 0.0 ? audio / busy : 0.0, worstBlockNanos.exchange(0) * 1e-6,
+            budgetMs, 1000.0 * (frames - std::min(frames, written)) / kSampleRate, overruns.load());
+    lastFrames = frames;
+    lastNanos = nanos;
+  }
+  render.join();
+  writer.join();
+  return outputClosed ? 1 : 0;
+}
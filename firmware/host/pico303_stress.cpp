@@ -0,0 +1,109 @@
+/**
+ * @file pico303_stress.cpp
+ * @brief Runs the stress scenarios (StressScenarios.h) through the sketch's
+ * render path on the host and reports the worst-case block render time.
+ *
+ * Each scenario is played several times. For every block the fastest of the
+ * repeats is kept, which removes most OS scheduling noise; the worst of those
+ * is the scenario's worst case. With --max-us the run fails if any scenario
+ * exceeds the limit, so it can serve as a release gate.
+ */
+
+#include "sim/SimRunner.h"
+#include "SketchHooks.h"
+#include "StressScenarios.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+  std::string only;
+  int repeats = 5;
+  double maxUs = 0.0;
+  bool csv = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--scenario" && hasValue) only = argv[++i];
+    else if (arg == "--repeats" && hasValue) repeats = std::max(1, atoi(argv[++i]));
+    else if (arg == "--max-us" && hasValue) maxUs = atof(argv[++i]);
+    else if (arg == "--csv") csv = true;
+    else if (arg == "--list") {
+      for (int s = 0; s < kStressScenarioCount; s++) printf("%s\n", kStressScenarios[s].name);
+      return 0;
+    } else {
+      fprintf(stderr, "Usage: %s [--scenario NAME] [--repeats N] [--max-us US] [--csv] [--list]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  sim::Runner runner;
+  runner.boot();
+
+  // Block period from the build's block size
+  uint32_t before = samplesRendered;
+  renderBlock();
+  const uint32_t blockSize = samplesRendered - before;
+  const double budgetUs = blockSize * 1e6 / 44100.0;
+
+  if (csv) printf("scenario,blocks,mean_us,worst_us,worst_block,budget_pct\n");
+  else printf("%-16s %7s %10s %10s %8s %8s\n", "scenario", "blocks", "mean us", "worst us", "@block", "budget");
+
+  bool failed = false;
+  int ran = 0;
+  double suiteWorst = 0.0;
+  for (int s = 0; s < kStressScenarioCount; s++) {
+    if (!only.empty() && only != kStressScenarios[s].name) continue;
+    ran++;
+
+    std::vector<uint64_t> best;
+    StressPlayer player;
+    for (int r = 0; r < repeats; r++) {
+      player.start(s, 44100);
+      for (size_t block = 0;; block++) {
+        bool playing = player.advance(blockSize, applyEvent);
+        auto t0 = std::chrono::steady_clock::now();
+        renderBlock();
+        auto t1 = std::chrono::steady_clock::now();
+        if (!playing) break;
+        uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        if (block >= best.size()) best.push_back(ns);
+        else best[block] = std::min(best[block], ns);
+      }
+    }
+
+    uint64_t worst = 0, total = 0;
+    size_t worstBlock = 0;
+    for (size_t b = 0; b < best.size(); b++) {
+      total += best[b];
+      if (best[b] > worst) {
+        worst = best[b];
+        worstBlock = b;
+      }
+    }
+    double worstUs = worst / 1e3;
+    double meanUs = best.empty() ? 0.0 : total / 1e3 / best.size();
+    suiteWorst = std::max(suiteWorst, worstUs);
+    bool over = maxUs > 0.0 && worstUs > maxUs;
+    failed |= over;
+
+    if (csv) {
+      printf("%s,%zu,%.2f,%.2f,%zu,%.2f\n", kStressScenarios[s].name, best.size(), meanUs, worstUs, worstBlock,
+             100.0 * worstUs / budgetUs);
+    } else {
+      printf("%-16s %7zu %10.1f %10.1f %8zu %7.1f%%%s\n", kStressScenarios[s].name, best.size(), meanUs, worstUs,
+             worstBlock, 100.0 * worstUs / budgetUs, over ? "  OVER LIMIT" : "");
+    }
+  }
+
+  if (!ran) {
+    fprintf(stderr, "unknown scenario '%s' (see --list)\n", only.c_str());
+    return 2;
+  }
+  if (!csv) printf("worst case %.1f us of %.1f us block period (%u samples)\n", suiteWorst, budgetUs, blockSize);
+  return failed ? 1 : 0;
+}
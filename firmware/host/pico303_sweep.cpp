@@ -0,0 +1,351 @@
+/**
+ * @file pico303_sweep.cpp
+ * @brief Renders a parameter sweep over a fixed pattern into a dataset:
+ * chunked WAV files plus a CSV manifest with the controller values of every
+ * point.
+ *
+ * Spec file, one directive per line, '#' starts a comment:
+ *
+ *   pattern <scenario>             stress scenario (StressScenarios.h) as the pattern
+ *   midi <file.mid>                or a MIDI file
+ *   seconds <s>                    rendered per point (default 4)
+ *   mode grid                      every combination of the param steps (default)
+ *   mode random <count> [seed]     count points, each param uniform in [min, max]
+ *   chunk <points>                 points per WAV file (default 256)
+ *   param <name> <cc> <min> <max> [steps]   up to 32 params
+ *   set <cc> <value>               fixed controller for every point
+ *
+ * Points are generated from their index (mixed-radix grid or a seeded hash),
+ * so nothing scales with the sweep size: a chunk's points are rendered in
+ * parallel and written straight into their place in the chunk file, then the
+ * next chunk starts. Each job renders a group of points in SIMD lanes
+ * (LaneRenderer), all jobs share the work-stealing pool.
+ */
+
+#include "batch/ChunkedWav.h"
+#include "batch/LaneRenderer.h"
+#include "batch/MidiFile.h"
+#include "batch/ThreadPool.h"
+#include "Pico303Engine.h"
+#include "StressScenarios.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBlockSize = 256;
+const int kMaxLanes = 8;
+
+struct Param {
+  std::string name;
+  uint8_t cc;
+  uint8_t min;
+  uint8_t max;
+  uint32_t steps;
+};
+
+struct Sweep {
+  int scenario = -1;
+  std::vector<batch::TimedEvent> midi;
+  double seconds = 4.0;
+  bool random = false;
+  uint64_t randomCount = 0;
+  uint64_t seed = 1;
+  uint32_t chunkPoints = 256;
+  std::vector<Param> params;
+  std::vector<StressCC> fixed;
+
+  uint32_t framesPerPoint() const {
+    uint32_t frames = (uint32_t)(seconds * kSampleRate);
+    return (frames + kBlockSize - 1) / kBlockSize * kBlockSize;
+  }
+
+  uint64_t pointCount() const {
+    if (random) return randomCount;
+    uint64_t n = 1;
+    for (const Param& p : params) n *= p.steps;
+    return n;
+  }
+};
+
+uint64_t splitMix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief Controller values of one point, in param order.
+ */
+void pointValues(const Sweep& sweep, uint64_t index, uint8_t* values) {
+  for (size_t i = 0; i < sweep.params.size(); i++) {
+    const Param& p = sweep.params[i];
+    uint32_t range = p.max - p.min;
+    if (sweep.random) {
+      uint64_t r = splitMix64(sweep.seed ^ splitMix64(index * sweep.params.size() + i));
+      values[i] = (uint8_t)(p.min + r % (range + 1));
+    } else {
+      // Mixed radix, first param changes fastest
+      uint32_t step = (uint32_t)(index % p.steps);
+      index /= p.steps;
+      values[i] = (uint8_t)(p.steps > 1 ? p.min + (range * step + (p.steps - 1) / 2) / (p.steps - 1) : p.min);
+    }
+  }
+}
+
+bool loadSweep(const std::string& path, Sweep& sweep, std::string& error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream ss(line);
+    std::string cmd;
+    if (!(ss >> cmd)) continue;  // Blank line
+
+    std::string where = path + ":" + std::to_string(lineNo) + ": ";
+    bool ok = true;
+    if (cmd == "pattern") {
+      std::string name;
+      ok = (bool)(ss >> name);
+      for (int s = 0; ok && s < kStressScenarioCount; s++) {
+        if (name == kStressScenarios[s].name) sweep.scenario = s;
+      }
+      if (ok && sweep.scenario < 0) {
+        error = where + "unknown scenario " + name;
+        return false;
+      }
+    } else if (cmd == "midi") {
+      std::string file;
+      ok = (bool)(ss >> file);
+      if (ok && !batch::loadMidiFile(file, sweep.midi, error)) return false;
+    } else if (cmd == "seconds") {
+      ok = (ss >> sweep.seconds) && sweep.seconds > 0.0;
+    } else if (cmd == "mode") {
+      std::string mode;
+      ok = (bool)(ss >> mode);
+      if (ok && mode == "random") {
+        sweep.random = true;
+        ok = (ss >> sweep.randomCount) && sweep.randomCount > 0;
+        if (ok && !(ss >> sweep.seed)) sweep.seed = 1;
+      } else {
+        ok = ok && mode == "grid";
+      }
+    } else if (cmd == "chunk") {
+      ok = (ss >> sweep.chunkPoints) && sweep.chunkPoints > 0;
+    } else if (cmd == "param") {
+      Param p;
+      int cc, min, max, steps = 2;
+      ok = (bool)(ss >> p.name >> cc >> min >> max);
+      if (ok && !(ss >> steps)) steps = 2;
+      ok = ok && cc >= 0 && cc < 128 && min >= 0 && max < 128 && min <= max && steps >= 1;
+      p.cc = cc;
+      p.min = min;
+      p.max = max;
+      p.steps = steps;
+      ok = ok && sweep.params.size() < 32;
+      if (ok) sweep.params.push_back(p);
+    } else if (cmd == "set") {
+      int cc, value;
+      ok = (ss >> cc >> value) && cc >= 0 && cc < 128 && value >= 0 && value < 128;
+      if (ok) sweep.fixed.push_back({(uint8_t)cc, (uint8_t)value});
+    } else {
+      error = where + "unknown directive " + cmd;
+      return false;
+    }
+    if (!ok) {
+      error = where + "bad " + cmd + " line";
+      return false;
+    }
+  }
+  if (sweep.scenario < 0 && sweep.midi.empty()) {
+    error = path + ": needs a pattern or midi line";
+    return false;
+  }
+  return true;
+}
+
+// StressPlayer emits through a plain function pointer; each worker renders one
+// group at a time, so the group's engines are thread-local
+thread_local Pico303Engine** emitTargets = nullptr;
+thread_local int emitCount = 0;
+
+void emitToGroup(const SynthEvent& ev) {
+  for (int i = 0; i < emitCount; i++) emitTargets[i]->apply(ev);
+}
+
+/**
+ * @brief Renders points [first, first + count) with one engine per lane and
+ * writes them into the chunk file.
+ */
+template <int N>
+void renderGroup(const Sweep& sweep, uint64_t first, int count, uint64_t chunkFirst,
+                 batch::ChunkedWav& wav, std::atomic<int>& failures) {
+  std::unique_ptr<Pico303Engine> engines[N];
+  Pico303Engine* lanes[N];
+  static thread_local int16_t buffers[kMaxLanes][kBlockSize * 2];
+  int16_t* out[N];
+  for (int l = 0; l < N; l++) {
+    engines[l].reset(new Pico303Engine);
+    engines[l]->begin(kSampleRate);
+    lanes[l] = engines[l].get();
+    out[l] = buffers[l];
+  }
+
+  // Sweep values go on top of the pattern's own setup controllers
+  auto applyPoint = [&] {
+    uint8_t values[32];
+    for (int l = 0; l < count; l++) {
+      pointValues(sweep, first + l, values);
+      for (const StressCC& c : sweep.fixed) lanes[l]->controlChange(1, c.cc, c.value);
+      for (size_t i = 0; i < sweep.params.size(); i++) {
+        lanes[l]->controlChange(1, sweep.params[i].cc, values[i]);
+      }
+    }
+  };
+
+  const uint32_t frames = sweep.framesPerPoint();
+  StressPlayer player;
+  bool playing = false;
+  size_t nextEvent = 0;
+  if (sweep.scenario >= 0) {
+    player.start(sweep.scenario, kSampleRate);
+    emitTargets = lanes;
+    emitCount = N;
+    playing = player.advance(0, emitToGroup);  // Setup controllers only
+  }
+  applyPoint();
+
+  for (uint32_t pos = 0; pos < frames; pos += kBlockSize) {
+    if (sweep.scenario >= 0) {
+      if (playing) playing = player.advance(kBlockSize, emitToGroup);
+    } else {
+      while (nextEvent < sweep.midi.size() &&
+             (uint64_t)(sweep.midi[nextEvent].seconds * kSampleRate) <= pos) {
+        for (int l = 0; l < N; l++) lanes[l]->apply(sweep.midi[nextEvent].event);
+        nextEvent++;
+      }
+    }
+    LaneRenderer::render<N>(lanes, out, kBlockSize);
+    for (int l = 0; l < count; l++) {
+      uint32_t offset = (uint32_t)(first + l - chunkFirst) * frames + pos;
+      if (!wav.write(offset, out[l], kBlockSize)) failures++;
+    }
+  }
+  emitTargets = nullptr;
+  emitCount = 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string specPath;
+  std::string outDir = ".";
+  unsigned threads = 0;
+  int lanes = 4;
+  bool dryRun = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--out" && hasValue) outDir = argv[++i];
+    else if (arg == "--threads" && hasValue) threads = (unsigned)std::max(0, atoi(argv[++i]));
+    else if (arg == "--lanes" && hasValue) lanes = atoi(argv[++i]);
+    else if (arg == "--dry-run") dryRun = true;
+    else if (specPath.empty() && !arg.empty() && arg[0] != '-') specPath = arg;
+    else {
+      specPath.clear();
+      break;
+    }
+  }
+  if (specPath.empty() || (lanes != 4 && lanes != kMaxLanes)) {
+    fprintf(stderr, "Usage: %s spec.txt [--out DIR] [--threads N] [--lanes 4|8] [--dry-run]\n", argv[0]);
+    return 2;
+  }
+
+  Sweep sweep;
+  std::string error;
+  if (!loadSweep(specPath, sweep, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  const uint64_t points = sweep.pointCount();
+  const uint32_t frames = sweep.framesPerPoint();
+  const uint64_t chunks = (points + sweep.chunkPoints - 1) / sweep.chunkPoints;
+  printf("%llu points x %.2f s in %llu chunks (%.1f MB of audio)\n", (unsigned long long)points,
+         (double)frames / kSampleRate, (unsigned long long)chunks, points * frames * 4.0 / 1e6);
+  if (dryRun) return 0;
+  if ((uint64_t)sweep.chunkPoints * frames * 4 > 0xFFFFFFF0ull - 44) {
+    fprintf(stderr, "chunk exceeds the 4 GB WAV limit, lower 'chunk'\n");
+    return 1;
+  }
+
+  FILE* manifest = fopen((outDir + "/manifest.csv").c_str(), "w");
+  if (!manifest) {
+    fprintf(stderr, "cannot write %s/manifest.csv\n", outDir.c_str());
+    return 1;
+  }
+  fprintf(manifest, "index,file,start_frame,frames");
+  for (const Param& p : sweep.params) fprintf(manifest, ",%s", p.name.c_str());
+  fprintf(manifest, "\n");
+
+  batch::ThreadPool pool(threads);
+  std::atomic<int> failures(0);
+  auto t0 = std::chrono::steady_clock::now();
+
+  for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+    uint64_t chunkFirst = chunk * sweep.chunkPoints;
+    uint32_t chunkCount = (uint32_t)std::min<uint64_t>(sweep.chunkPoints, points - chunkFirst);
+    char name[32];
+    snprintf(name, sizeof(name), "sweep_%05llu.wav", (unsigned long long)chunk);
+
+    batch::ChunkedWav wav;
+    if (!wav.open(outDir + "/" + name, chunkCount * frames, kSampleRate)) {
+      fprintf(stderr, "cannot write %s/%s\n", outDir.c_str(), name);
+      return 1;
+    }
+    for (uint32_t g = 0; g < chunkCount; g += lanes) {
+      uint64_t first = chunkFirst + g;
+      int count = (int)std::min<uint32_t>(lanes, chunkCount - g);
+      pool.submit([&, first, count] {
+        if (lanes == 4) renderGroup<4>(sweep, first, count, chunkFirst, wav, failures);
+        else renderGroup<8>(sweep, first, count, chunkFirst, wav, failures);
+      });
+    }
+
+    // Manifest rows while the chunk renders
+    uint8_t values[32];
+    for (uint32_t i = 0; i < chunkCount; i++) {
+      pointValues(sweep, chunkFirst + i, values);
+      fprintf(manifest, "%llu,%s,%u,%u", (unsigned long long)(chunkFirst + i), name, i * frames, frames);
+      for (size_t p = 0; p < sweep.params.size(); p++) fprintf(manifest, ",%u", values[p]);
+      fprintf(manifest, "\n");
+    }
+    pool.wait();
+    wav.close();
+  }
+  fclose(manifest);
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  double audio = (double)points * frames / kSampleRate;
+  printf("rendered %.1f s of audio in %.2f s on %u threads: RTF %.1f\n", audio, wall, pool.size(), audio / wall);
+  if (failures) {
+    fprintf(stderr, "%d block writes failed\n", failures.load());
+    return 1;
+  }
+  return 0;
+}
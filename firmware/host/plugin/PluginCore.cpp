@@ -0,0 +1,126 @@
+/**
+ * @file PluginCore.cpp
+ * @brief Implementation of the PluginCore class.
+ */
+
+#include "PluginCore.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace plugin {
+
+static_assert(kParameterCount <= 32, "Dirty mask holds one bit per parameter");
+
+PluginCore::PluginCore() {
+  for (int i = 0; i < kParameterCount; i++) values[i].store(kParameterMap[i].value);
+  memset(heldNotes, 0, sizeof(heldNotes));
+}
+
+bool PluginCore::activate(double sampleRate) {
+  engine = Pico303Engine();
+  memset(heldNotes, 0, sizeof(heldNotes));
+  lastTempo = 0.0;
+  if (!engine.begin((int)(sampleRate + 0.5))) return false;
+  for (int i = 0; i < kParameterCount; i++) {
+    engine.controlChange(1, kParameterMap[i].cc, values[i].load());
+  }
+  dirty.store(0);
+  return true;
+}
+
+int PluginCore::indexOfCC(uint8_t cc) {
+  for (int i = 0; i < kParameterCount; i++) {
+    if (kParameterMap[i].cc == cc) return i;
+  }
+  return -1;
+}
+
+void PluginCore::setParameter(int index, uint8_t value) {
+  if (index < 0 || index >= kParameterCount) return;
+  value = std::min(std::max(value, kParameterMap[index].minVal), kParameterMap[index].maxVal);
+  values[index].store(value, std::memory_order_relaxed);
+  dirty.fetch_or(1u << index, std::memory_order_release);
+}
+
+uint8_t PluginCore::getParameter(int index) const {
+  if (index < 0 || index >= kParameterCount) return 0;
+  return values[index].load(std::memory_order_relaxed);
+}
+
+std::string PluginCore::saveState() const {
+  std::ostringstream out;
+  out << "# pico-303 patch\n";
+  for (int i = 0; i < kParameterCount; i++) {
+    out << (int)kParameterMap[i].cc << " " << (int)getParameter(i) << "  # " << kParameterMap[i].name << "\n";
+  }
+  return out.str();
+}
+
+bool PluginCore::loadState(const std::string& text) {
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream ss(line);
+    int cc, value;
+    if (!(ss >> cc)) continue;  // Blank line
+    if (!(ss >> value) || cc < 0 || cc > 127 || value < 0 || value > 127) return false;
+    setParameter(indexOfCC((uint8_t)cc), (uint8_t)value);  // Unmapped CCs are ignored
+  }
+  return true;
+}
+
+void PluginCore::applyEvent(const SynthEvent& ev) {
+  if (ev.type == SynthEvent::CONTROL_CHANGE) {
+    // Keep the main thread's view in step with automation and MIDI CCs
+    int index = indexOfCC(ev.data1);
+    if (index >= 0) values[index].store(ev.data2, std::memory_order_relaxed);
+  } else if (ev.type == SynthEvent::NOTE_ON) {
+    if (heldNotes[ev.data1 & 0x7F] < 255) heldNotes[ev.data1 & 0x7F]++;
+  } else if (ev.type == SynthEvent::NOTE_OFF) {
+    if (heldNotes[ev.data1 & 0x7F] > 0) heldNotes[ev.data1 & 0x7F]--;
+  }
+  engine.apply(ev);
+}
+
+void PluginCore::process(const Event* events, int eventCount, double tempo, float* outL, float* outR, int frames) {
+  uint32_t changed = dirty.exchange(0, std::memory_order_acquire);
+  while (changed) {
+    int index = __builtin_ctz(changed);
+    changed &= changed - 1;
+    engine.controlChange(1, kParameterMap[index].cc, values[index].load(std::memory_order_relaxed));
+  }
+  if (tempo > 0.0 && tempo != lastTempo) {
+    lastTempo = tempo;
+    engine.apply({SynthEvent::TEMPO, 0, 0, 0, (float)tempo});
+  }
+
+  int next = 0;
+  int pos = 0;
+  while (pos < frames) {
+    while (next < eventCount && (int)events[next].frame <= pos) applyEvent(events[next++].event);
+
+    // Render up to the next event, in chunks that fit the scratch buffer
+    int end = next < eventCount ? std::min<int>(events[next].frame, frames) : frames;
+    int n = std::min(end - pos, kChunkFrames);
+    engine.render(scratch, n);
+    for (int i = 0; i < n; i++) {
+      outL[pos + i] = scratch[i * 2] * (1.0f / 32768.0f);
+      outR[pos + i] = scratch[i * 2 + 1] * (1.0f / 32768.0f);
+    }
+    pos += n;
+  }
+  // Events stamped at or past the end of the buffer
+  while (next < eventCount) applyEvent(events[next++].event);
+}
+
+void PluginCore::reset() {
+  for (int note = 0; note < 128; note++) {
+    while (heldNotes[note] > 0) applyEvent({SynthEvent::NOTE_OFF, 1, (uint8_t)note, 0, 0.0f});
+  }
+}
+
+}  // namespace plugin
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include "Pico303Engine.h"
+#include "ParameterMap.h"
+
+/**
+ * @file PluginCore.h
+ * @brief Format-independent part of the pico-303 audio plugin.
+ */
+
+namespace plugin {
+
+/**
+ * @class PluginCore
+ * @brief A Pico303Engine behind the threading rules of a plugin host.
+ *
+ * Audio thread: process() renders float stereo and applies each event at its
+ * exact frame within the host buffer, by splitting the render at event
+ * times. It takes no locks and allocates nothing; output passes through the
+ * engine's 16-bit stage, so it matches the hardware DAC data sample for
+ * sample.
+ *
+ * Main thread: setParameter() publishes a value through an atomic slot and
+ * a dirty mask, picked up at the start of the next process() call.
+ * Parameters are the hardware CC map (kParameterMap), so a patch is the set
+ * of CC values that reproduces it on the device.
+ */
+class PluginCore {
+public:
+  static const int kMaxEvents = 512;   ///< Per process() call; callers with more split the buffer
+  static const int kChunkFrames = 256;
+
+  struct Event {
+    uint32_t frame;       ///< Offset in the host buffer
+    SynthEvent event;
+  };
+
+  PluginCore();
+
+  /**
+   * @brief Prepares the engine for a sample rate (main thread, may allocate).
+   * Starts from the power-on state and applies every parameter value.
+   */
+  bool activate(double sampleRate);
+
+  // ---- Main thread ----
+
+  void setParameter(int index, uint8_t value);
+  uint8_t getParameter(int index) const;
+
+  /**
+   * @brief Parameter index for a CC number, -1 if the CC is not mapped.
+   */
+  static int indexOfCC(uint8_t cc);
+
+  /**
+   * @brief Patch text: one "<cc> <value>" line per parameter (patch file format).
+   */
+  std::string saveState() const;
+  bool loadState(const std::string& text);
+
+  // ---- Audio thread ----
+
+  /**
+   * @brief Renders frames of audio.
+   * @param events Sorted by frame
+   * @param tempo Host tempo in BPM, 0 if unknown (drives the synced delay)
+   */
+  void process(const Event* events, int eventCount, double tempo, float* outL, float* outR, int frames);
+
+  /**
+   * @brief All notes off, e.g. when the transport stops.
+   */
+  void reset();
+
+private:
+  void applyEvent(const SynthEvent& ev);
+
+  Pico303Engine engine;
+  std::atomic<uint8_t> values[kParameterCount];
+  std::atomic<uint32_t> dirty{0};
+  double lastTempo = 0.0;
+  int16_t scratch[kChunkFrames * 2];
+  uint8_t heldNotes[128];
+};
+
+}  // namespace plugin
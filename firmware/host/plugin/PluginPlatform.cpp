@@ -0,0 +1,14 @@
+/**
+ * @file PluginPlatform.cpp
+ * @brief The one Arduino call the engine sources need outside the simulator.
+ *
+ * DeferredLog stamps messages with micros(); the plugin never attaches a
+ * log, but the engine code still references it.
+ */
+
+#include <chrono>
+
+unsigned long micros() {
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,351 @@
+/**
+ * @file pico303_clap.cpp
+ * @brief CLAP wrapper around PluginCore: one stereo output, one note input
+ * (CLAP notes and MIDI 1.0), the CC map as stepped parameters, patch text as
+ * plugin state.
+ *
+ * Threading follows the CLAP rules: parameter changes from the GUI/host main
+ * thread go through PluginCore::setParameter(); automation and notes arrive
+ * as timed events in process() and are applied at their frame. The event
+ * list is copied into a fixed array owned by the plugin, nothing on the
+ * audio thread allocates.
+ */
+
+#include <clap/clap.h>
+#include "PluginCore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+const char* const kFeatures[] = {CLAP_PLUGIN_FEATURE_INSTRUMENT, CLAP_PLUGIN_FEATURE_SYNTHESIZER,
+                                 CLAP_PLUGIN_FEATURE_MONO, nullptr};
+
+const clap_plugin_descriptor_t kDescriptor = {
+  CLAP_VERSION_INIT,
+  "com.pico303.synth",
+  "pico-303",
+  "pico-303",
+  "https://github.com/Cinezaster/pico-303",
+  "",
+  "",
+  "1.0.0",
+  "TB-303 style bass synth, the pico-303 firmware engine",
+  kFeatures,
+};
+
+struct Plugin {
+  clap_plugin_t clap;
+  const clap_host_t* host;
+  plugin::PluginCore core;
+  plugin::PluginCore::Event events[plugin::PluginCore::kMaxEvents];
+};
+
+Plugin* self(const clap_plugin_t* p) {
+  return (Plugin*)p->plugin_data;
+}
+
+/**
+ * @brief Converts one CLAP event. Parameter ids are CC numbers.
+ * @return false if the event does not concern the engine
+ */
+bool translate(const clap_event_header_t* hdr, SynthEvent& ev) {
+  if (hdr->space_id != CLAP_CORE_EVENT_SPACE_ID) return false;
+  switch (hdr->type) {
+    case CLAP_EVENT_NOTE_ON:
+    case CLAP_EVENT_NOTE_OFF: {
+      const clap_event_note_t* n = (const clap_event_note_t*)hdr;
+      if (n->key < 0 || n->key > 127) return false;
+      uint8_t velocity = (uint8_t)std::lround(std::fmin(std::fmax(n->velocity, 0.0), 1.0) * 127.0);
+      if (hdr->type == CLAP_EVENT_NOTE_ON && velocity > 0) {
+        ev = {SynthEvent::NOTE_ON, (uint8_t)(std::max<int16_t>(n->channel, 0) + 1), (uint8_t)n->key, velocity, 0.0f};
+      } else {
+        ev = {SynthEvent::NOTE_OFF, (uint8_t)(std::max<int16_t>(n->channel, 0) + 1), (uint8_t)n->key, 0, 0.0f};
+      }
+      return true;
+    }
+    case CLAP_EVENT_PARAM_VALUE: {
+      const clap_event_param_value_t* v = (const clap_event_param_value_t*)hdr;
+      if (plugin::PluginCore::indexOfCC((uint8_t)v->param_id) < 0 || v->param_id > 127) return false;
+      ev = {SynthEvent::CONTROL_CHANGE, 1, (uint8_t)v->param_id, (uint8_t)std::lround(v->value), 0.0f};
+      return true;
+    }
+    case CLAP_EVENT_MIDI: {
+      const clap_event_midi_t* m = (const clap_event_midi_t*)hdr;
+      uint8_t kind = m->data[0] & 0xF0;
+      uint8_t channel = (m->data[0] & 0x0F) + 1;
+      uint8_t d1 = m->data[1] & 0x7F;
+      uint8_t d2 = m->data[2] & 0x7F;
+      if (kind == 0x90 && d2 > 0) ev = {SynthEvent::NOTE_ON, channel, d1, d2, 0.0f};
+      else if (kind == 0x80 || kind == 0x90) ev = {SynthEvent::NOTE_OFF, channel, d1, d2, 0.0f};
+      else if (kind == 0xB0) ev = {SynthEvent::CONTROL_CHANGE, channel, d1, d2, 0.0f};
+      else return false;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Copies host events into the plugin's fixed array, starting at input
+ * index `index` and stopping when the array is full; `index` is left at the
+ * first event not taken. Frames are made relative to `offset`. MIDI CCs that
+ * move a parameter are echoed as parameter events, so the host's view of the
+ * patch stays current.
+ */
+int collectEvents(Plugin* p, const clap_input_events_t* in, const clap_output_events_t* out, uint32_t& index,
+                  uint32_t offset) {
+  int count = 0;
+  uint32_t size = in ? in->size(in) : 0;
+  for (; index < size && count < plugin::PluginCore::kMaxEvents; index++) {
+    const clap_event_header_t* hdr = in->get(in, index);
+    SynthEvent ev;
+    if (!translate(hdr, ev)) continue;
+    p->events[count++] = {hdr->time > offset ? hdr->time - offset : 0, ev};
+    if (out && hdr->type == CLAP_EVENT_MIDI && ev.type == SynthEvent::CONTROL_CHANGE &&
+        plugin::PluginCore::indexOfCC(ev.data1) >= 0) {
+      clap_event_param_value_t echo;
+      memset(&echo, 0, sizeof(echo));
+      echo.header.size = sizeof(echo);
+      echo.header.time = hdr->time;
+      echo.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+      echo.header.type = CLAP_EVENT_PARAM_VALUE;
+      echo.param_id = ev.data1;
+      echo.note_id = -1;
+      echo.port_index = -1;
+      echo.channel = -1;
+      echo.key = -1;
+      echo.value = ev.data2;
+      out->try_push(out, &echo.header);
+    }
+  }
+  return count;
+}
+
+// ---- Extensions ----
+
+uint32_t audioPortsCount(const clap_plugin_t*, bool isInput) {
+  return isInput ? 0 : 1;
+}
+
+bool audioPortsGet(const clap_plugin_t*, uint32_t index, bool isInput, clap_audio_port_info_t* info) {
+  if (isInput || index != 0) return false;
+  info->id = 0;
+  snprintf(info->name, sizeof(info->name), "Output");
+  info->flags = CLAP_AUDIO_PORT_IS_MAIN;
+  info->channel_count = 2;
+  info->port_type = CLAP_PORT_STEREO;
+  info->in_place_pair = CLAP_INVALID_ID;
+  return true;
+}
+
+const clap_plugin_audio_ports_t kAudioPorts = {audioPortsCount, audioPortsGet};
+
+uint32_t notePortsCount(const clap_plugin_t*, bool isInput) {
+  return isInput ? 1 : 0;
+}
+
+bool notePortsGet(const clap_plugin_t*, uint32_t index, bool isInput, clap_note_port_info_t* info) {
+  if (!isInput || index != 0) return false;
+  info->id = 0;
+  info->supported_dialects = CLAP_NOTE_DIALECT_CLAP | CLAP_NOTE_DIALECT_MIDI;
+  info->preferred_dialect = CLAP_NOTE_DIALECT_MIDI;
+  snprintf(info->name, sizeof(info->name), "MIDI In");
+  return true;
+}
+
+const clap_plugin_note_ports_t kNotePorts = {notePortsCount, notePortsGet};
+
+uint32_t paramsCount(const clap_plugin_t*) {
+  return kParameterCount;
+}
+
+bool paramsGetInfo(const clap_plugin_t*, uint32_t index, clap_param_info_t* info) {
+  if (index >= kParameterCount) return false;
+  const Parameter& p = kParameterMap[index];
+  memset(info, 0, sizeof(*info));
+  info->id = p.cc;
+  info->flags = CLAP_PARAM_IS_STEPPED | CLAP_PARAM_IS_AUTOMATABLE;
+  snprintf(info->name, sizeof(info->name), "%s", p.name);
+  snprintf(info->module, sizeof(info->module), "CC %d", p.cc);
+  info->min_value = p.minVal;
+  info->max_value = p.maxVal;
+  info->default_value = p.value;
+  return true;
+}
+
+bool paramsGetValue(const clap_plugin_t* plugin, clap_id id, double* value) {
+  int index = id <= 127 ? plugin::PluginCore::indexOfCC((uint8_t)id) : -1;
+  if (index < 0) return false;
+  *value = self(plugin)->core.getParameter(index);
+  return true;
+}
+
+bool paramsValueToText(const clap_plugin_t*, clap_id id, double value, char* out, uint32_t capacity) {
+  if (id > 127 || plugin::PluginCore::indexOfCC((uint8_t)id) < 0) return false;
+  snprintf(out, capacity, "%d", (int)std::lround(value));
+  return true;
+}
+
+bool paramsTextToValue(const clap_plugin_t*, clap_id id, const char* text, double* value) {
+  if (id > 127 || plugin::PluginCore::indexOfCC((uint8_t)id) < 0) return false;
+  *value = atof(text);
+  return true;
+}
+
+void paramsFlush(const clap_plugin_t* plugin, const clap_input_events_t* in, const clap_output_events_t*) {
+  // Not processing: apply parameter events through the main-thread path
+  uint32_t size = in ? in->size(in) : 0;
+  for (uint32_t i = 0; i < size; i++) {
+    const clap_event_header_t* hdr = in->get(in, i);
+    SynthEvent ev;
+    if (translate(hdr, ev) && ev.type == SynthEvent::CONTROL_CHANGE) {
+      self(plugin)->core.setParameter(plugin::PluginCore::indexOfCC(ev.data1), ev.data2);
+    }
+  }
+}
+
+const clap_plugin_params_t kParams = {paramsCount, paramsGetInfo, paramsGetValue, paramsValueToText,
+                                      paramsTextToValue, paramsFlush};
+
+bool stateSave(const clap_plugin_t* plugin, const clap_ostream_t* stream) {
+  std::string text = self(plugin)->core.saveState();
+  const char* p = text.data();
+  uint64_t left = text.size();
+  while (left > 0) {
+    int64_t n = stream->write(stream, p, left);
+    if (n <= 0) return false;
+    p += n;
+    left -= (uint64_t)n;
+  }
+  return true;
+}
+
+bool stateLoad(const clap_plugin_t* plugin, const clap_istream_t* stream) {
+  std::string text;
+  char buf[1024];
+  for (;;) {
+    int64_t n = stream->read(stream, buf, sizeof(buf));
+    if (n < 0) return false;
+    if (n == 0) break;
+    text.append(buf, (size_t)n);
+  }
+  return self(plugin)->core.loadState(text);
+}
+
+const clap_plugin_state_t kState = {stateSave, stateLoad};
+
+// ---- Plugin ----
+
+bool pluginInit(const clap_plugin_t*) {
+  return true;
+}
+
+void pluginDestroy(const clap_plugin_t* plugin) {
+  delete self(plugin);
+}
+
+bool pluginActivate(const clap_plugin_t* plugin, double sampleRate, uint32_t, uint32_t) {
+  return self(plugin)->core.activate(sampleRate);
+}
+
+void pluginDeactivate(const clap_plugin_t*) {}
+
+bool pluginStartProcessing(const clap_plugin_t*) {
+  return true;
+}
+
+void pluginStopProcessing(const clap_plugin_t*) {}
+
+void pluginReset(const clap_plugin_t* plugin) {
+  self(plugin)->core.reset();
+}
+
+clap_process_status pluginProcess(const clap_plugin_t* plugin, const clap_process_t* process) {
+  Plugin* p = self(plugin);
+  if (process->audio_outputs_count < 1 || process->audio_outputs[0].channel_count < 2) return CLAP_PROCESS_ERROR;
+  float** out = process->audio_outputs[0].data32;
+  double tempo = 0.0;
+  if (process->transport && (process->transport->flags & CLAP_TRANSPORT_HAS_TEMPO)) {
+    tempo = process->transport->tempo;
+  }
+  // More events than the array holds are taken in passes: each pass renders
+  // up to the first event it could not take, so every event keeps its frame
+  const clap_input_events_t* in = process->in_events;
+  uint32_t size = in ? in->size(in) : 0;
+  uint32_t frames = process->frames_count;
+  uint32_t index = 0;
+  uint32_t pos = 0;
+  do {
+    int count = collectEvents(p, in, process->out_events, index, pos);
+    uint32_t end = index < size ? std::min(std::max(in->get(in, index)->time, pos), frames) : frames;
+    p->core.process(p->events, count, tempo, out[0] + pos, out[1] + pos, (int)(end - pos));
+    pos = end;
+  } while (index < size);
+  return CLAP_PROCESS_CONTINUE;
+}
+
+const void* pluginGetExtension(const clap_plugin_t*, const char* id) {
+  if (!strcmp(id, CLAP_EXT_AUDIO_PORTS)) return &kAudioPorts;
+  if (!strcmp(id, CLAP_EXT_NOTE_PORTS)) return &kNotePorts;
+  if (!strcmp(id, CLAP_EXT_PARAMS)) return &kParams;
+  if (!strcmp(id, CLAP_EXT_STATE)) return &kState;
+  return nullptr;
+}
+
+void pluginOnMainThread(const clap_plugin_t*) {}
+
+// ---- Factory and entry ----
+
+uint32_t factoryCount(const clap_plugin_factory_t*) {
+  return 1;
+}
+
+const clap_plugin_descriptor_t* factoryDescriptor(const clap_plugin_factory_t*, uint32_t index) {
+  return index == 0 ? &kDescriptor : nullptr;
+}
+
+const clap_plugin_t* factoryCreate(const clap_plugin_factory_t*, const clap_host_t* host, const char* id) {
+  if (!clap_version_is_compatible(host->clap_version) || strcmp(id, kDescriptor.id) != 0) return nullptr;
+  Plugin* p = new Plugin;
+  p->host = host;
+  p->clap.desc = &kDescriptor;
+  p->clap.plugin_data = p;
+  p->clap.init = pluginInit;
+  p->clap.destroy = pluginDestroy;
+  p->clap.activate = pluginActivate;
+  p->clap.deactivate = pluginDeactivate;
+  p->clap.start_processing = pluginStartProcessing;
+  p->clap.stop_processing = pluginStopProcessing;
+  p->clap.reset = pluginReset;
+  p->clap.process = pluginProcess;
+  p->clap.get_extension = pluginGetExtension;
+  p->clap.on_main_thread = pluginOnMainThread;
+  return &p->clap;
+}
+
+const clap_plugin_factory_t kFactory = {factoryCount, factoryDescriptor, factoryCreate};
+
+bool entryInit(const char*) {
+  return true;
+}
+
+void entryDeinit() {}
+
+const void* entryGetFactory(const char* id) {
+  return !strcmp(id, CLAP_PLUGIN_FACTORY_ID) ? &kFactory : nullptr;
+}
+
+}  // namespace
+
+extern "C" CLAP_EXPORT const clap_plugin_entry_t clap_entry = {
+  CLAP_VERSION_INIT,
+  entryInit,
+  entryDeinit,
+  entryGetFactory,
+};
@@ -0,0 +1,40 @@
+#pragma once
+/**
+ * @file Adafruit_GFX.h
+ * @brief Host stand-in for the Adafruit GFX drawing primitives used by the sketch.
+ * Text is drawn as solid 5x7 cells so the framebuffer changes like the real one.
+ */
+
+#include <Arduino.h>
+
+class Adafruit_GFX {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : width(w), height(h) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { fillRect(x, y, w, 1, color); }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { fillRect(x, y, 1, h, color); }
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color);
+
+  void setTextColor(uint16_t c) { textColor = c; }
+  void setTextSize(uint8_t s) { textSize = s ? s : 1; }
+  void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+
+  size_t print(const char* s);
+  size_t print(int v);
+  size_t print(unsigned v) { return print((int)v); }
+
+protected:
+  int16_t width;
+  int16_t height;
+  int16_t cursorX = 0;
+  int16_t cursorY = 0;
+  uint16_t textColor = 1;
+  uint8_t textSize = 1;
+};
@@ -0,0 +1,34 @@
+#pragma once
+/**
+ * @file Adafruit_SSD1306.h
+ * @brief Host stand-in for the SSD1306 driver.
+ * Keeps a real page-major framebuffer; display() charges the blocking I2C
+ * transfer time of a full frame to the calling core.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "Adafruit_GFX.h"
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rstPin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+  ~Adafruit_SSD1306();
+
+  bool begin(uint8_t vcs = SSD1306_SWITCHCAPVCC, uint8_t addr = 0, bool reset = true, bool periphBegin = true);
+  void display();
+  void clearDisplay();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  uint8_t* getBuffer() { return buffer; }
+
+private:
+  uint8_t* buffer;
+  uint32_t clkDuring;
+};
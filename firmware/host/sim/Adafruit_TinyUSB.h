@@ -0,0 +1,19 @@
+#pragma once
+/**
+ * @file Adafruit_TinyUSB.h
+ * @brief Host stand-in for the TinyUSB device stack (always mounted).
+ */
+
+class Adafruit_USBD_Device {
+public:
+  void setManufacturerDescriptor(const char*) {}
+  void setProductDescriptor(const char*) {}
+  bool mounted() const { return true; }
+};
+
+extern Adafruit_USBD_Device TinyUSBDevice;
+
+class Adafruit_USBD_MIDI {
+public:
+  bool begin() { return true; }
+};
@@ -0,0 +1,95 @@
+#pragma once
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core (arduino-pico flavour).
+ * Time and GPIO are backed by the simulated board in SimHost.h.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#ifndef F_CPU
+#define F_CPU 250000000UL
+#endif
+
+typedef uint8_t byte;
+
+// ArduinoCore-API declares these as enums, so sketch code may reuse the names in its own scopes
+typedef enum { LOW = 0, HIGH = 1, CHANGE = 2, FALLING = 3, RISING = 4 } PinStatus;
+typedef enum { INPUT = 0, OUTPUT = 1, INPUT_PULLUP = 2, INPUT_PULLDOWN = 3 } PinMode;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, int mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ArduinoCore-API style min/max (mixed argument types allowed)
+template <class T, class L>
+auto min(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (b < a) ? b : a; }
+template <class T, class L>
+auto max(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (a < b) ? b : a; }
+
+// pico-sdk helpers that arduino-pico exposes globally
+inline void tight_loop_contents() {}
+unsigned get_core_num();
+
+/**
+ * @brief Minimal Print interface.
+ */
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+  }
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v) { return printf("%.2f", v); }
+  size_t println() { return print("\n"); }
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, format);
+    int n = vsnprintf(buf, sizeof(buf), format, ap);
+    va_end(ap);
+    return write((const uint8_t*)buf, std::min<size_t>(n, sizeof(buf) - 1));
+  }
+};
+
+/**
+ * @brief Serial port, printed to stderr so stdout stays free for tool output.
+ */
+class SerialPort : public Print {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { return fputc(c, stderr) == EOF ? 0 : 1; }
+  size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stderr); }
+  operator bool() const { return true; }
+};
+
+extern SerialPort Serial;
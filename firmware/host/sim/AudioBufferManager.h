@@ -0,0 +1,5 @@
+#pragma once
+/**
+ * @file AudioBufferManager.h
+ * @brief Host stand-in (the sketch only needs the header to exist).
+ */
@@ -0,0 +1,31 @@
+#pragma once
+/**
+ * @file I2S.h
+ * @brief Host stand-in for the arduino-pico I2S output.
+ * Frames go into the simulated DMA FIFO (sim::I2SModel), which drains at the
+ * sample rate in virtual time and records underruns.
+ */
+
+#include <Arduino.h>
+
+class I2S {
+public:
+  I2S(PinMode direction = OUTPUT, int bclk = 26, int data = 28) { (void)direction; (void)bclk; (void)data; }
+
+  bool setBitsPerSample(int bits) { return bits == 16; }
+  bool setBuffers(size_t buffers, size_t bufferWords, int32_t silenceSample = 0);
+  void onTransmit(void (*fn)()) { transmitCallback = fn; }
+  bool begin(long sampleRate);
+  void end() {}
+
+  /**
+   * @brief Free space in bytes (16-bit stereo = 4 bytes per frame).
+   */
+  int availableForWrite();
+  size_t write(const uint8_t* buffer, size_t size);
+
+private:
+  size_t bufferCount = 6;
+  size_t bufferWords = 16;
+  void (*transmitCallback)() = nullptr;
+};
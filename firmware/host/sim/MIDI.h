@@ -0,0 +1,63 @@
+#pragma once
+/**
+ * @file MIDI.h
+ * @brief Host stand-in for the FortySevenEffects MIDI library.
+ * read() dispatches one due message from the simulation script per call,
+ * sends are recorded by the simulated board.
+ */
+
+#include <Arduino.h>
+#include <vector>
+
+#define MIDI_CHANNEL_OMNI 0
+
+namespace midi {
+
+class SimMidiInterface {
+public:
+  typedef void (*NoteFn)(byte channel, byte note, byte velocity);
+  typedef void (*ControlChangeFn)(byte channel, byte number, byte value);
+  typedef void (*VoidFn)();
+  typedef void (*SysExFn)(byte* data, unsigned size);
+
+  void begin(int channel = 1) { (void)channel; }
+
+  void setHandleNoteOn(NoteFn fn) { noteOn = fn; }
+  void setHandleNoteOff(NoteFn fn) { noteOff = fn; }
+  void setHandleControlChange(ControlChangeFn fn) { controlChange = fn; }
+  void setHandleClock(VoidFn fn) { clock = fn; }
+  void setHandleStart(VoidFn fn) { start = fn; }
+  void setHandleStop(VoidFn fn) { stop = fn; }
+  void setHandleSystemExclusive(SysExFn fn) { sysex = fn; }
+
+  /**
+   * @brief Parses and dispatches at most one pending message.
+   * @return true if a message was handled
+   */
+  bool read();
+
+  void sendNoteOn(byte note, byte velocity, byte channel);
+  void sendNoteOff(byte note, byte velocity, byte channel);
+  void sendControlChange(byte number, byte value, byte channel);
+  void sendSysEx(unsigned length, const byte* data, bool containsBoundaries = false);
+
+  /**
+   * @brief Dispatches a raw message to the registered handlers.
+   */
+  void dispatch(std::vector<uint8_t>& msg);
+
+private:
+  NoteFn noteOn = nullptr;
+  NoteFn noteOff = nullptr;
+  ControlChangeFn controlChange = nullptr;
+  VoidFn clock = nullptr;
+  VoidFn start = nullptr;
+  VoidFn stop = nullptr;
+  SysExFn sysex = nullptr;
+
+  void send(std::vector<uint8_t> msg);
+};
+
+}  // namespace midi
+
+#define MIDI_CREATE_INSTANCE(Type, SerialPort, Name) midi::SimMidiInterface Name;
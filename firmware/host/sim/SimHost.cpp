@@ -0,0 +1,191 @@
+/**
+ * @file SimHost.cpp
+ * @brief Simulated board: virtual clock, GPIO, I2S FIFO and WAV output.
+ */
+
+#include "SimHost.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+Host host;
+
+// ============================================================================
+// I2S FIFO
+// ============================================================================
+
+void I2SModel::configure(uint32_t rate, size_t frames) {
+  sampleRate = rate;
+  capacity = frames;
+  fifo.assign(frames * 2, 0);
+  readPos = 0;
+  fill = 0;
+}
+
+uint64_t I2SModel::frameTimeNs(uint64_t frameIndex) const {
+  return startNs + frameIndex * 1000000000ULL / sampleRate;
+}
+
+double I2SModel::intervalStddevNs() const {
+  return intervals > 1 ? std::sqrt(intervalM2 / (intervals - 1)) : 0.0;
+}
+
+void I2SModel::update(uint64_t nowNs) {
+  if (!running || nowNs < startNs) return;
+  uint64_t due = (nowNs - startNs) * sampleRate / 1000000000ULL;
+
+  static int16_t silence[512] = {};
+  bool starved = false;
+  while (playedFrames < due) {
+    uint64_t want = due - playedFrames;
+    if (fill > 0) {
+      // Play a contiguous run out of the ring
+      size_t run = std::min<uint64_t>({want, (uint64_t)fill, (uint64_t)(capacity - readPos)});
+      for (auto& sink : sinks) sink(&fifo[readPos * 2], run, frameTimeNs(playedFrames));
+      readPos = (readPos + run) % capacity;
+      fill -= run;
+      playedFrames += run;
+      starved = false;
+    } else {
+      // FIFO empty: the DMA replays silence
+      if (!starved) underrunEvents++;
+      starved = true;
+      size_t run = std::min<uint64_t>(want, 256);
+      for (auto& sink : sinks) sink(silence, run, frameTimeNs(playedFrames));
+      underrunFrames += run;
+      playedFrames += run;
+    }
+    if (fill < minFill) minFill = fill;
+  }
+}
+
+void I2SModel::write(const int16_t* frames, size_t count, uint64_t nowNs) {
+  if (!running) {
+    running = true;
+    startNs = nowNs;
+  }
+  update(nowNs);
+  if (primed) {
+    // Welford, as RenderStats on the device
+    uint64_t interval = nowNs - lastWriteNs;
+    intervals++;
+    minIntervalNs = std::min(minIntervalNs, interval);
+    maxIntervalNs = std::max(maxIntervalNs, interval);
+    double delta = interval - intervalMeanNs;
+    intervalMeanNs += delta / intervals;
+    intervalM2 += delta * (interval - intervalMeanNs);
+  }
+  lastWriteNs = nowNs;
+  size_t n = std::min(count, freeFrames());
+  size_t writePos = (readPos + fill) % capacity;
+  for (size_t i = 0; i < n; i++) {
+    fifo[writePos * 2] = frames[i * 2];
+    fifo[writePos * 2 + 1] = frames[i * 2 + 1];
+    writePos = (writePos + 1) % capacity;
+  }
+  fill += n;
+  writtenFrames += n;
+  if (freeFrames() < count) primed = true;   // No room for another block
+}
+
+// ============================================================================
+// Board
+// ============================================================================
+
+Host::Host() {
+  // Inputs idle high (pull-ups), so the encoder rests at 11 and the button is released
+  for (auto& level : pinLevel) level = HIGH;
+}
+
+void Host::setPin(uint8_t pin, uint8_t level) {
+  if (pin >= 32 || pinLevel[pin] == level) return;
+  pinLevel[pin] = level;
+  if (pinIsr[pin]) pinIsr[pin]();
+}
+
+void Host::turnEncoder(int detents) {
+  // Gray sequence that the UIManager quadrature table counts as +1 per step
+  static const uint8_t kSequence[4] = {0b00, 0b01, 0b11, 0b10};
+  static int phase = 2;  // 11 = resting detent
+  int step = detents > 0 ? 1 : -1;
+  for (int i = 0; i < 2 * std::abs(detents); i++) {
+    phase = (phase + step + 4) % 4;
+    uint8_t state = kSequence[phase];
+    // Quadrature changes one pin per step
+    if (((state >> 1) & 1) != pinLevel[kEncoderA]) setPin(kEncoderA, (state >> 1) & 1);
+    if ((state & 1) != pinLevel[kEncoderB]) setPin(kEncoderB, state & 1);
+  }
+}
+
+void Host::pollScript() {
+  uint64_t now = clock.now();
+  while (scriptPos < script.size() && script[scriptPos].timeNs <= now) {
+    const ScriptEvent& ev = script[scriptPos++];
+    switch (ev.type) {
+      case ScriptEvent::MIDI:
+        midiInbox.push_back(ev.bytes);
+        stats.midiIn++;
+        break;
+      case ScriptEvent::ENCODER:
+        turnEncoder(ev.delta);
+        break;
+      case ScriptEvent::BUTTON_DOWN:
+        setPin(kEncoderSW, LOW);
+        break;
+      case ScriptEvent::BUTTON_UP:
+        setPin(kEncoderSW, HIGH);
+        break;
+    }
+    if (inputHook) inputHook(ev, now);
+  }
+}
+
+// ============================================================================
+// WAV output
+// ============================================================================
+
+static void putLE(FILE* f, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) fputc((v >> (8 * i)) & 0xFF, f);
+}
+
+bool WavWriter::open(const std::string& path, uint32_t rate, uint16_t ch) {
+  close();
+  file = fopen(path.c_str(), "wb");
+  if (!file) return false;
+  sampleRate = rate;
+  channels = ch;
+  dataBytes = 0;
+  // Header is rewritten with the real sizes in close()
+  uint8_t header[44] = {};
+  fwrite(header, 1, sizeof(header), file);
+  return true;
+}
+
+void WavWriter::write(const int16_t* samples, size_t count) {
+  if (!file) return;
+  for (size_t i = 0; i < count; i++) putLE(file, (uint16_t)samples[i], 2);
+  dataBytes += count * 2;
+}
+
+void WavWriter::close() {
+  if (!file) return;
+  fseek(file, 0, SEEK_SET);
+  fwrite("RIFF", 1, 4, file);
+  putLE(file, 36 + dataBytes, 4);
+  fwrite("WAVEfmt ", 1, 8, file);
+  putLE(file, 16, 4);
+  putLE(file, 1, 2);                          // PCM
+  putLE(file, channels, 2);
+  putLE(file, sampleRate, 4);
+  putLE(file, sampleRate * channels * 2, 4);  // Byte rate
+  putLE(file, channels * 2, 2);               // Block align
+  putLE(file, 16, 2);
+  fwrite("data", 1, 4, file);
+  putLE(file, dataBytes, 4);
+  fclose(file);
+  file = nullptr;
+}
+
+}  // namespace sim
@@ -0,0 +1,169 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file SimHost.h
+ * @brief Virtual-time hardware model behind the Arduino/Pico stand-ins.
+ *
+ * Every core has its own time cursor. The scheduler always runs the core
+ * that is furthest behind, and blocking operations (I2C, rendering) advance
+ * the cursor of the core that performs them. Nothing depends on host wall
+ * time, so a run is fully deterministic.
+ */
+
+namespace sim {
+
+/**
+ * @brief Virtual clock with one cursor per core.
+ */
+struct Clock {
+  uint64_t coreNs[2] = {0, 0};
+  int core = 0;
+
+  uint64_t now() const { return coreNs[core]; }
+  void advance(uint64_t ns) { coreNs[core] += ns; }
+};
+
+/**
+ * @brief Cost model, all values in nanoseconds of virtual time.
+ */
+struct CostModel {
+  uint64_t loopOverheadNs = 2000;      ///< Charged after every loop()/loop1() pass
+  uint64_t renderNsPerFrame = 6000;    ///< Charged per stereo frame passed to I2S::write()
+  uint32_t i2cHz = 400000;             ///< Display bus speed
+  // Housekeeping, charged to the core that does it. Estimates for a 150 MHz
+  // M33, not measurements; they make UI and USB work compete with audio on
+  // core 0 in single-core builds, as on the device.
+  uint64_t usbPollNs = 4000;           ///< Per MIDI.read() call (TinyUSB task and FIFO check)
+  uint64_t midiMessageNs = 3000;       ///< Per dispatched MIDI message (parser and callback)
+  uint64_t pixelNs = 100;              ///< Per framebuffer pixel drawn (GFX primitives)
+  uint64_t dmaStartNs = 2000;          ///< Per display DMA transfer programmed
+};
+
+/**
+ * @brief I2S output: a FIFO of stereo frames drained at the sample rate.
+ * Underruns insert silence into the played stream, like the real DMA ring.
+ */
+struct I2SModel {
+  using Sink = std::function<void(const int16_t* frames, size_t count, uint64_t startNs)>;
+
+  uint32_t sampleRate = 44100;
+  size_t capacity = 2048;          ///< Frames (buffers x words)
+  bool running = false;            ///< Starts with the first write
+  uint64_t startNs = 0;
+  uint64_t playedFrames = 0;       ///< Frames that left the FIFO (including silence)
+  uint64_t writtenFrames = 0;
+  uint64_t underrunEvents = 0;
+  uint64_t underrunFrames = 0;
+  size_t minFill = SIZE_MAX;       ///< Lowest FIFO level seen after start
+  // Spacing of writes once the FIFO has first been topped up: how evenly the
+  // render loop is serviced (its spread is the jitter housekeeping adds)
+  bool primed = false;
+  uint64_t lastWriteNs = 0;
+  uint64_t intervals = 0;
+  uint64_t minIntervalNs = UINT64_MAX;
+  uint64_t maxIntervalNs = 0;
+  double intervalMeanNs = 0.0;
+  double intervalM2 = 0.0;
+  std::vector<int16_t> fifo;       ///< Interleaved L/R ring
+  size_t readPos = 0;
+  size_t fill = 0;
+  std::vector<Sink> sinks;
+
+  void configure(uint32_t rate, size_t frames);
+  void update(uint64_t nowNs);
+  size_t freeFrames() const { return capacity - fill; }
+  void write(const int16_t* frames, size_t count, uint64_t nowNs);
+  uint64_t frameTimeNs(uint64_t frameIndex) const;
+  double intervalStddevNs() const;
+};
+
+/**
+ * @brief Scripted input event (see SimScript.cpp for the text format).
+ */
+struct ScriptEvent {
+  enum Type { MIDI, ENCODER, BUTTON_DOWN, BUTTON_UP };
+  uint64_t timeNs;
+  Type type;
+  std::vector<uint8_t> bytes;      ///< MIDI message (including F0/F7 for SysEx)
+  int delta = 0;                   ///< Encoder detents
+};
+
+/**
+ * @brief Counters reported at the end of a run.
+ */
+struct Stats {
+  uint64_t loopPasses[2] = {0, 0};
+  uint64_t maxLoopGapNs = 0;       ///< Longest core 0 loop() pass
+  uint64_t midiIn = 0;
+  uint64_t midiOut = 0;
+  uint64_t sysexOut = 0;
+  uint64_t sysexOutBytes = 0;
+  uint64_t displayBytes = 0;       ///< Bytes sent to the OLED (blocking + DMA)
+  uint64_t blockingI2cNs = 0;      ///< Time spent in blocking display transfers
+};
+
+/**
+ * @brief The simulated board.
+ */
+struct Host {
+  Clock clock;
+  CostModel cost;
+  I2SModel i2s;
+  Stats stats;
+  uint64_t endNs = UINT64_MAX;     ///< End of the run; I2S stops asking for data after it
+
+  // GPIO
+  uint8_t pinLevel[32];
+  void (*pinIsr[32])() = {};
+
+  // Scripted input
+  std::vector<ScriptEvent> script;
+  size_t scriptPos = 0;
+  std::vector<std::vector<uint8_t>> midiInbox;   ///< Due MIDI messages, consumed by MIDI.read()
+  std::vector<std::vector<uint8_t>> midiOutbox;  ///< Everything the sketch sent
+  std::function<void(const std::vector<uint8_t>&, uint64_t)> midiOutHook;
+  std::function<void(const ScriptEvent&, uint64_t)> inputHook;  ///< Called when an event is injected
+
+  Host();
+  void pollScript();
+  void turnEncoder(int detents);
+  void setPin(uint8_t pin, uint8_t level);
+};
+
+extern Host host;
+
+// Encoder pins as wired in pico-303.ino
+const uint8_t kEncoderA = 6;
+const uint8_t kEncoderB = 7;
+const uint8_t kEncoderSW = 8;
+
+/**
+ * @brief Parses a script file into events, sorted by time.
+ * @return false (with a message in error) on a syntax error
+ */
+bool loadScript(const std::string& path, std::vector<ScriptEvent>& events, std::string& error);
+
+/**
+ * @brief Writes a 16-bit stereo WAV file.
+ */
+class WavWriter {
+public:
+  bool open(const std::string& path, uint32_t sampleRate, uint16_t channels = 2);
+  void write(const int16_t* samples, size_t count);
+  void close();
+  ~WavWriter() { close(); }
+
+private:
+  FILE* file = nullptr;
+  uint32_t dataBytes = 0;
+  uint32_t sampleRate = 44100;
+  uint16_t channels = 2;
+};
+
+}  // namespace sim
@@ -0,0 +1,324 @@
+/**
+ * @file SimMocks.cpp
+ * @brief Implementations of the Arduino/Pico stand-ins on top of sim::Host.
+ */
+
+#include "SimHost.h"
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include <Adafruit_SSD1306.h>
+#include <I2S.h>
+#include <MIDI.h>
+#include <Wire.h>
+#include <hardware/dma.h>
+#include <hardware/i2c.h>
+
+using sim::host;
+
+// ============================================================================
+// Arduino core
+// ============================================================================
+
+SerialPort Serial;
+TwoWire Wire;
+TwoWire Wire1;
+Adafruit_USBD_Device TinyUSBDevice;
+
+unsigned long millis() { return (unsigned long)(host.clock.now() / 1000000ULL); }
+unsigned long micros() { return (unsigned long)(host.clock.now() / 1000ULL); }
+void delay(unsigned long ms) { host.clock.advance(ms * 1000000ULL); }
+void delayMicroseconds(unsigned int us) { host.clock.advance(us * 1000ULL); }
+unsigned get_core_num() { return (unsigned)host.clock.core; }
+
+void pinMode(uint8_t pin, int mode) { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  if (pin < 32) host.pinLevel[pin] = level ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) { return pin < 32 ? (int)host.pinLevel[pin] : (int)LOW; }
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode) {
+  (void)mode;  // Only CHANGE is used by the sketch
+  if (interrupt < 32) host.pinIsr[interrupt] = isr;
+}
+
+// ============================================================================
+// I2S
+// ============================================================================
+
+bool I2S::setBuffers(size_t buffers, size_t words, int32_t silenceSample) {
+  (void)silenceSample;
+  bufferCount = buffers;
+  bufferWords = words;
+  return true;
+}
+
+bool I2S::begin(long sampleRate) {
+  // One 32-bit word holds one 16-bit stereo frame
+  host.i2s.configure((uint32_t)sampleRate, bufferCount * bufferWords);
+  return true;
+}
+
+int I2S::availableForWrite() {
+  // Past the end of the run, so a render loop that never catches up still returns
+  if (host.clock.now() >= host.endNs) return 0;
+  host.i2s.update(host.clock.now());
+  return (int)(host.i2s.freeFrames() * 4);
+}
+
+size_t I2S::write(const uint8_t* buffer, size_t size) {
+  size_t frames = size / 4;
+  // The block was rendered just before this call; charge its cost here
+  host.clock.advance(frames * host.cost.renderNsPerFrame);
+  host.i2s.write((const int16_t*)buffer, frames, host.clock.now());
+  if (transmitCallback) transmitCallback();
+  return size;
+}
+
+// ============================================================================
+// MIDI
+// ============================================================================
+
+namespace midi {
+
+bool SimMidiInterface::read() {
+  host.pollScript();
+  host.clock.advance(host.cost.usbPollNs);
+  if (host.midiInbox.empty()) return false;
+  host.clock.advance(host.cost.midiMessageNs);
+  std::vector<uint8_t> msg = host.midiInbox.front();
+  host.midiInbox.erase(host.midiInbox.begin());
+  dispatch(msg);
+  return true;
+}
+
+void SimMidiInterface::dispatch(std::vector<uint8_t>& msg) {
+  if (msg.empty()) return;
+  uint8_t status = msg[0];
+  byte channel = (status & 0x0F) + 1;
+  switch (status & 0xF0) {
+    case 0x90:
+      // Velocity 0 is a note off, as in the real library
+      if (msg[2] == 0) {
+        if (noteOff) noteOff(channel, msg[1], 0);
+      } else if (noteOn) {
+        noteOn(channel, msg[1], msg[2]);
+      }
+      return;
+    case 0x80:
+      if (noteOff) noteOff(channel, msg[1], msg[2]);
+      return;
+    case 0xB0:
+      if (controlChange) controlChange(channel, msg[1], msg[2]);
+      return;
+  }
+  switch (status) {
+    case 0xF0:
+      if (sysex) sysex(msg.data(), (unsigned)msg.size());
+      break;
+    case 0xF8:
+      if (clock) clock();
+      break;
+    case 0xFA:
+      if (start) start();
+      break;
+    case 0xFC:
+      if (stop) stop();
+      break;
+  }
+}
+
+void SimMidiInterface::send(std::vector<uint8_t> msg) {
+  host.stats.midiOut++;
+  if (msg[0] == 0xF0) {
+    host.stats.sysexOut++;
+    host.stats.sysexOutBytes += msg.size();
+  }
+  if (host.midiOutHook) host.midiOutHook(msg, host.clock.now());
+  host.midiOutbox.push_back(std::move(msg));
+}
+
+void SimMidiInterface::sendNoteOn(byte note, byte velocity, byte channel) {
+  send({(uint8_t)(0x90 | ((channel - 1) & 0x0F)), note, velocity});
+}
+
+void SimMidiInterface::sendNoteOff(byte note, byte velocity, byte channel) {
+  send({(uint8_t)(0x80 | ((channel - 1) & 0x0F)), note, velocity});
+}
+
+void SimMidiInterface::sendControlChange(byte number, byte value, byte channel) {
+  send({(uint8_t)(0xB0 | ((channel - 1) & 0x0F)), number, value});
+}
+
+void SimMidiInterface::sendSysEx(unsigned length, const byte* data, bool containsBoundaries) {
+  std::vector<uint8_t> msg;
+  if (!containsBoundaries) msg.push_back(0xF0);
+  msg.insert(msg.end(), data, data + length);
+  if (!containsBoundaries) msg.push_back(0xF7);
+  send(std::move(msg));
+}
+
+}  // namespace midi
+
+// ============================================================================
+// Graphics
+// ============================================================================
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+  while (true) {
+    drawPixel(x0, y0, color);
+    if (x0 == x1 && y0 == y1) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+  drawFastHLine(x + r, y, w - 2 * r, color);
+  drawFastHLine(x + r, y + h - 1, w - 2 * r, color);
+  drawFastVLine(x, y + r, h - 2 * r, color);
+  drawFastVLine(x + w - 1, y + r, h - 2 * r, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t j = y; j < y + h; j++)
+    for (int16_t i = x; i < x + w; i++) drawPixel(i, j, color);
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+  int16_t byteWidth = (w + 7) / 8;
+  for (int16_t j = 0; j < h; j++)
+    for (int16_t i = 0; i < w; i++)
+      if (bitmap[j * byteWidth + i / 8] & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+}
+
+size_t Adafruit_GFX::print(const char* s) {
+  // No font data on the host: every glyph becomes a 5x7 pattern derived from
+  // its code, so changing text still changes the same framebuffer area.
+  size_t n = 0;
+  for (; *s; s++, n++) {
+    uint8_t c = (uint8_t)*s;
+    for (int i = 0; i < 5; i++) {
+      uint8_t column = (uint8_t)((c * 37 + i * 11) & 0x7F);
+      for (int j = 0; j < 7; j++)
+        if (column & (1 << j)) fillRect(cursorX + i * textSize, cursorY + j * textSize, textSize, textSize, textColor);
+    }
+    cursorX += 6 * textSize;
+  }
+  return n;
+}
+
+size_t Adafruit_GFX::print(int v) {
+  char buf[12];
+  snprintf(buf, sizeof(buf), "%d", v);
+  return print(buf);
+}
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rstPin,
+                                   uint32_t clkDuring, uint32_t clkAfter)
+  : Adafruit_GFX(w, h), buffer(new uint8_t[w * ((h + 7) / 8)]()), clkDuring(clkDuring) {
+  (void)twi;
+  (void)rstPin;
+  (void)clkAfter;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() { delete[] buffer; }
+
+bool Adafruit_SSD1306::begin(uint8_t vcs, uint8_t addr, bool reset, bool periphBegin) {
+  (void)vcs;
+  (void)addr;
+  (void)reset;
+  (void)periphBegin;
+  return true;
+}
+
+void Adafruit_SSD1306::clearDisplay() { memset(buffer, 0, width * ((height + 7) / 8)); }
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  host.clock.advance(host.cost.pixelNs);
+  if (x < 0 || y < 0 || x >= width || y >= height) return;
+  uint8_t& b = buffer[x + (y / 8) * width];
+  if (color) b |= (1 << (y & 7));
+  else b &= ~(1 << (y & 7));
+}
+
+void Adafruit_SSD1306::display() {
+  // Address commands plus the frame, sent in 32-byte Wire transactions that
+  // each carry a slave address and control byte. 9 bus clocks per byte.
+  size_t data = width * ((height + 7) / 8);
+  size_t bytes = 12 + data + 2 * ((data + 31) / 32);
+  uint64_t ns = bytes * 9ULL * 1000000000ULL / clkDuring;
+  host.clock.advance(ns);
+  host.stats.blockingI2cNs += ns;
+  host.stats.displayBytes += bytes;
+}
+
+// ============================================================================
+// I2C / DMA
+// ============================================================================
+
+static i2c_hw_t i2c0Hw = {};
+static i2c_hw_t i2c1Hw = {};
+i2c_inst_t i2c0_inst = {&i2c0Hw};
+i2c_inst_t i2c1_inst = {&i2c1Hw};
+
+namespace {
+struct DmaChannel {
+  bool claimed = false;
+  uint64_t busyUntilNs = 0;
+};
+DmaChannel dmaChannels[12];
+}
+
+int dma_claim_unused_channel(bool required) {
+  (void)required;
+  for (int i = 0; i < 12; i++) {
+    if (!dmaChannels[i].claimed) {
+      dmaChannels[i].claimed = true;
+      return i;
+    }
+  }
+  return -1;
+}
+
+dma_channel_config dma_channel_get_default_config(unsigned channel) {
+  (void)channel;
+  dma_channel_config c = {};
+  c.size = DMA_SIZE_32;
+  c.readIncrement = true;
+  return c;
+}
+
+void dma_channel_configure(unsigned channel, const dma_channel_config* config, volatile void* writeAddr,
+                           const volatile void* readAddr, unsigned transferCount, bool trigger) {
+  (void)config;
+  (void)writeAddr;
+  if (trigger) dma_channel_transfer_from_buffer_now(channel, readAddr, transferCount);
+}
+
+void dma_channel_transfer_from_buffer_now(unsigned channel, const volatile void* readAddr, uint32_t transferCount) {
+  (void)readAddr;
+  // Every word is one byte on the display bus (plus an address byte per STOP,
+  // approximated as one per transfer); the DREQ paces the channel at 9 clocks per byte.
+  host.clock.advance(host.cost.dmaStartNs);
+  uint32_t bytes = transferCount + 2;
+  uint64_t ns = bytes * 9ULL * 1000000000ULL / host.cost.i2cHz;
+  dmaChannels[channel].busyUntilNs = host.clock.now() + ns;
+  host.stats.displayBytes += transferCount;
+}
+
+bool dma_channel_is_busy(unsigned channel) {
+  return host.clock.now() < dmaChannels[channel].busyUntilNs;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file SimRunner.cpp
+ * @brief Core scheduler for the host simulator.
+ */
+
+#include "SimRunner.h"
+#include "SimHost.h"
+#include <algorithm>
+
+void setup();
+void loop();
+// Only present when the sketch is built with DUAL_CORE
+void setup1() __attribute__((weak));
+void loop1() __attribute__((weak));
+
+namespace sim {
+
+void Runner::boot() {
+  host.clock.core = 0;
+  setup();
+  dualCore = loop1 != nullptr;
+  if (dualCore) {
+    host.clock.core = 1;
+    host.clock.coreNs[1] = host.clock.coreNs[0];
+    if (setup1) setup1();
+  }
+}
+
+void Runner::runUntil(uint64_t endNs) {
+  host.endNs = endNs;
+  while (true) {
+    int core = (dualCore && host.clock.coreNs[1] < host.clock.coreNs[0]) ? 1 : 0;
+    if (host.clock.coreNs[core] >= endNs) break;
+    host.clock.core = core;
+    uint64_t start = host.clock.now();
+    host.pollScript();
+    if (core == 0) loop();
+    else loop1();
+    host.clock.advance(host.cost.loopOverheadNs);
+    host.stats.loopPasses[core]++;
+    if (core == 0) host.stats.maxLoopGapNs = std::max(host.stats.maxLoopGapNs, host.clock.now() - start);
+  }
+  host.i2s.update(endNs);
+}
+
+}  // namespace sim
@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @file SimRunner.h
+ * @brief Boots the sketch and interleaves loop()/loop1() in virtual time.
+ */
+
+namespace sim {
+
+class Runner {
+public:
+  /**
+   * @brief Runs setup(), and setup1() when the sketch was built with DUAL_CORE.
+   */
+  void boot();
+
+  /**
+   * @brief Runs loop passes, always on the core that is furthest behind,
+   * until both cores reach endNs. Then drains the I2S FIFO up to endNs.
+   */
+  void runUntil(uint64_t endNs);
+
+  bool isDualCore() const { return dualCore; }
+
+private:
+  bool dualCore = false;
+};
+
+}  // namespace sim
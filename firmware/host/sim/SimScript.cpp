@@ -0,0 +1,105 @@
+/**
+ * @file SimScript.cpp
+ * @brief Parser for simulation input scripts.
+ *
+ * One event per line, '#' starts a comment. Times are in milliseconds:
+ *
+ *   <ms> note_on <ch> <note> <vel>
+ *   <ms> note_off <ch> <note> [vel]
+ *   <ms> cc <ch> <number> <value>
+ *   <ms> clock [count] [bpm]       count pulses at 24 PPQN (default 1 pulse)
+ *   <ms> sysex <hex bytes>         payload without F0/F7
+ *   <ms> enc <detents>             negative turns counter-clockwise
+ *   <ms> button                    press and release after 150 ms
+ */
+
+#include "SimHost.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace sim {
+
+static ScriptEvent midiEvent(double ms, std::vector<uint8_t> bytes) {
+  ScriptEvent ev;
+  ev.timeNs = (uint64_t)(ms * 1e6);
+  ev.type = ScriptEvent::MIDI;
+  ev.bytes = std::move(bytes);
+  return ev;
+}
+
+bool loadScript(const std::string& path, std::vector<ScriptEvent>& events, std::string& error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream ss(line);
+    double ms;
+    std::string cmd;
+    if (!(ss >> ms)) continue;  // Blank line
+    if (!(ss >> cmd)) {
+      error = path + ":" + std::to_string(lineNo) + ": missing command";
+      return false;
+    }
+
+    bool ok = true;
+    if (cmd == "note_on" || cmd == "note_off" || cmd == "cc") {
+      int ch, a, b = 0;
+      ok = (bool)(ss >> ch >> a);
+      if (ok && !(ss >> b)) {
+        ok = (cmd == "note_off");
+        b = 0;
+      }
+      uint8_t status = cmd == "note_on" ? 0x90 : cmd == "note_off" ? 0x80 : 0xB0;
+      if (ok) events.push_back(midiEvent(ms, {(uint8_t)(status | ((ch - 1) & 0x0F)), (uint8_t)(a & 0x7F), (uint8_t)(b & 0x7F)}));
+    } else if (cmd == "clock") {
+      int count = 1;
+      double bpm = 120.0;
+      ss >> count >> bpm;
+      double intervalMs = 60000.0 / (bpm * 24.0);
+      for (int i = 0; i < count; i++) events.push_back(midiEvent(ms + i * intervalMs, {0xF8}));
+    } else if (cmd == "sysex") {
+      std::vector<uint8_t> bytes = {0xF0};
+      std::string hex;
+      while (ss >> hex) bytes.push_back((uint8_t)std::stoul(hex, nullptr, 16));
+      bytes.push_back(0xF7);
+      events.push_back(midiEvent(ms, bytes));
+    } else if (cmd == "enc") {
+      ScriptEvent ev;
+      ev.timeNs = (uint64_t)(ms * 1e6);
+      ev.type = ScriptEvent::ENCODER;
+      ok = (bool)(ss >> ev.delta);
+      if (ok) events.push_back(ev);
+    } else if (cmd == "button") {
+      ScriptEvent ev;
+      ev.timeNs = (uint64_t)(ms * 1e6);
+      ev.type = ScriptEvent::BUTTON_DOWN;
+      events.push_back(ev);
+      ev.timeNs += 150000000ULL;
+      ev.type = ScriptEvent::BUTTON_UP;
+      events.push_back(ev);
+    } else {
+      error = path + ":" + std::to_string(lineNo) + ": unknown command '" + cmd + "'";
+      return false;
+    }
+
+    if (!ok) {
+      error = path + ":" + std::to_string(lineNo) + ": bad arguments for '" + cmd + "'";
+      return false;
+    }
+  }
+
+  std::stable_sort(events.begin(), events.end(),
+                   [](const ScriptEvent& a, const ScriptEvent& b) { return a.timeNs < b.timeNs; });
+  return true;
+}
+
+}  // namespace sim
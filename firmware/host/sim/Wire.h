@@ -0,0 +1,22 @@
+#pragma once
+/**
+ * @file Wire.h
+ * @brief Host stand-in for the arduino-pico TwoWire class.
+ */
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  bool setSDA(int) { return true; }
+  bool setSCL(int) { return true; }
+  void begin() {}
+  void setClock(uint32_t hz) { clockHz = hz; }
+  uint32_t getClock() const { return clockHz; }
+
+private:
+  uint32_t clockHz = 100000;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
@@ -0,0 +1,30 @@
+#pragma once
+/**
+ * @file hardware/dma.h
+ * @brief Host stand-in for the pico-sdk DMA API.
+ * Transfers into an I2C DATA_CMD register complete after the bus time of the
+ * transferred bytes has passed in virtual time.
+ */
+
+#include <stdint.h>
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+typedef struct {
+  uint32_t ctrl;
+  unsigned dreq;
+  bool readIncrement;
+  bool writeIncrement;
+  dma_channel_transfer_size size;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(unsigned channel);
+inline void channel_config_set_transfer_data_size(dma_channel_config* c, dma_channel_transfer_size size) { c->size = size; }
+inline void channel_config_set_read_increment(dma_channel_config* c, bool incr) { c->readIncrement = incr; }
+inline void channel_config_set_write_increment(dma_channel_config* c, bool incr) { c->writeIncrement = incr; }
+inline void channel_config_set_dreq(dma_channel_config* c, unsigned dreq) { c->dreq = dreq; }
+void dma_channel_configure(unsigned channel, const dma_channel_config* config, volatile void* writeAddr,
+                           const volatile void* readAddr, unsigned transferCount, bool trigger);
+void dma_channel_transfer_from_buffer_now(unsigned channel, const volatile void* readAddr, uint32_t transferCount);
+bool dma_channel_is_busy(unsigned channel);
@@ -0,0 +1,30 @@
+#pragma once
+/**
+ * @file hardware/i2c.h
+ * @brief Host stand-in for the pico-sdk I2C register block.
+ */
+
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t enable;
+  volatile uint32_t tar;
+  volatile uint32_t data_cmd;
+  volatile uint32_t tx_abrt_source;
+  volatile uint32_t clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+  i2c_hw_t* hw;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+
+inline i2c_hw_t* i2c_get_hw(i2c_inst_t* i2c) { return i2c->hw; }
+inline unsigned i2c_get_dreq(i2c_inst_t* i2c, bool isTx) { return (i2c == i2c1 ? 34 : 32) + (isTx ? 0 : 1); }
@@ -0,0 +1,23 @@
+#pragma once
+/**
+ * @file pico/mutex.h
+ * @brief Host stand-in for pico-sdk mutexes (cores are interleaved, never parallel).
+ */
+
+#include <stdint.h>
+
+typedef struct {
+  bool locked;
+} mutex_t;
+
+#define auto_init_mutex(name) mutex_t name = {false}
+
+inline bool mutex_try_enter(mutex_t* m, uint32_t* owner) {
+  (void)owner;
+  if (m->locked) return false;
+  m->locked = true;
+  return true;
+}
+
+inline void mutex_enter_blocking(mutex_t* m) { m->locked = true; }
+inline void mutex_exit(mutex_t* m) { m->locked = false; }
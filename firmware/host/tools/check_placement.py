@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""
+Checks that the audio hot path of a firmware build runs from SRAM.
+
+Reads the symbol table of the linked ELF with nm and fails if any hot
+function (see HotPath.h) is missing or was linked anywhere but SRAM. That
+happens when a new DSP function loses its DSP_HOT_FUNC, or when the render
+loop is not inlined into fillAudioBlock and gets its own copy in flash.
+C library routines that the hot path calls are only reported, as they come
+precompiled with the core and are placed by its linker script. Calls to the
+double-precision helpers (__aeabi_d*, __aeabi_f2d, ...) are errors: the M33
+FPU is single precision, so any double arithmetic in a hot function becomes
+a soft-float call into flash. The disassembly of each hot function is
+searched for them.
+
+Usage: check_placement.py [--nm arm-none-eabi-nm] [--objdump arm-none-eabi-objdump] <firmware.elf>
+
+The ELF is in the build directory printed by
+'arduino-cli compile --build-path <dir> ...'. A build with -DDSP_IN_RAM=0
+is expected to fail the check.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+SRAM = (0x20000000, 0x20082000)   # RP2350 SRAM0-9 (covers RP2040's 264 KB too)
+XIP = (0x10000000, 0x14000000)    # Flash, through the XIP cache
+
+# Functions that must exist and be in SRAM (demangled names, without arguments)
+HOT_FUNCTIONS = [
+    'fillAudioBlock',
+    'Oscillator::tick',
+    'Oscillator::polyBLEP',
+    'Oscillator::process',
+    'Filter303::process',
+    'Filter303::processFeedbackHPF',
+    'Filter303::processZDF',
+    'DCBlocker::process',
+    'DCBlocker::processHPF',
+    'Distortion::process',
+    'Distortion::processSoftClip',
+    'Distortion::processHardClip',
+    'Distortion::processWavefolder',
+    'Distortion::processDiode',
+    'Distortion::processWaveNet',
+    'AnalogEnvelope::process',
+    'DecayEnvelope::process',
+    'LeakyIntegrator::process',
+    'StereoDelay::processL',
+    'StereoDelay::processR',
+    'StereoDelay::tick',
+]
+
+# Header code that is meant to be inlined into fillAudioBlock: an
+# out-of-line copy of any of these must at least be in SRAM too
+# (templates demangle with their return type first)
+INLINED = re.compile(r'(?:^|\s)(?:Pico303Engine::render<|Pico303Engine::\w+Stage::process<|Chain<)')
+
+# C library routines called on every sample (output clipper, oscillator wrap)
+LIBRARY = ['tanhf', 'fmodf', 'floorf']
+
+# Soft-float double helpers, also behind __wrap_ prefixes and linker veneers
+DOUBLE_CALL = re.compile(r'<(\w*__aeabi_(?:d\w+|\w*2d)\w*)>')
+
+SYMBOL_RE = re.compile(r'^([0-9a-fA-F]+)\s+(?:([0-9a-fA-F]+)\s+)?([A-Za-z])\s+(.+)$')
+
+
+def region(addr):
+    if SRAM[0] <= addr < SRAM[1]:
+        return 'SRAM'
+    if XIP[0] <= addr < XIP[1]:
+        return 'flash'
+    return 'other'
+
+
+def read_symbols(nm, elf):
+    out = subprocess.run([nm, '-C', '-S', '--defined-only', elf],
+                         check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in out.splitlines():
+        m = SYMBOL_RE.match(line.strip())
+        if not m or m.group(3) not in 'tTwW':
+            continue
+        size = int(m.group(2), 16) if m.group(2) else 0
+        symbols.append((m.group(4), int(m.group(1), 16) & ~1, size))   # & ~1: Thumb bit
+    return symbols
+
+
+def double_calls(objdump, elf, addr, size):
+    """Double-precision helpers called from the code at [addr, addr + size)."""
+    out = subprocess.run([objdump, '-d', '--start-address=0x%x' % addr,
+                          '--stop-address=0x%x' % (addr + size), elf],
+                         check=True, capture_output=True, text=True).stdout
+    return sorted(set(DOUBLE_CALL.findall(out)))
+
+
+def base_name(name):
+    # 'Filter303::process(float, float, float, float)' -> 'Filter303::process'
+    depth = 0
+    for i, c in enumerate(name):
+        if c == '<':
+            depth += 1
+        elif c == '>':
+            depth -= 1
+        elif c == '(' and depth == 0:
+            return name[:i]
+    return name
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Check that the audio hot path is linked into SRAM.')
+    ap.add_argument('elf')
+    ap.add_argument('--nm', default='arm-none-eabi-nm', help='nm of the firmware toolchain')
+    ap.add_argument('--objdump', default='arm-none-eabi-objdump', help='objdump of the firmware toolchain')
+    args = ap.parse_args()
+
+    try:
+        symbols = read_symbols(args.nm, args.elf)
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit('check_placement: cannot read symbols: %s' % e)
+
+    errors = 0
+    hot_bytes = 0
+    by_name = {}
+    for name, addr, size in symbols:
+        by_name.setdefault(base_name(name), []).append((name, addr, size))
+
+    for fn in HOT_FUNCTIONS:
+        found = by_name.get(fn)
+        if not found:
+            print('MISSING  %s' % fn)
+            errors += 1
+            continue
+        for name, addr, size in found:
+            where = region(addr)
+            print('%-8s %08x %6d  %s' % (where, addr, size, name))
+            if where == 'SRAM':
+                hot_bytes += size
+            else:
+                errors += 1
+            try:
+                calls = double_calls(args.objdump, args.elf, addr, size) if size else []
+            except (OSError, subprocess.CalledProcessError) as e:
+                sys.exit('check_placement: cannot disassemble: %s' % e)
+            for call in calls:
+                print('double   %08x %6s  %s calls %s' % (addr, '', name, call))
+                errors += 1
+
+    for name, addr, size in symbols:
+        if INLINED.search(name):
+            where = region(addr)
+            print('%-8s %08x %6d  %s (not inlined)' % (where, addr, size, name))
+            if where != 'SRAM':
+                errors += 1
+
+    for fn in LIBRARY:
+        for name in (fn, '__wrap_' + fn):
+            for _, addr, size in by_name.get(name, []):
+                print('note     %08x %6d  %s is in %s' % (addr, size, name, region(addr)))
+
+    print('%d bytes of hot code in SRAM, %d placement error(s)' % (hot_bytes, errors))
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
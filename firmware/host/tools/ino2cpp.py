@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""
+Turns an Arduino sketch (.ino) into a compilable C++ file, the way the
+Arduino builder does: prepend '#include <Arduino.h>' and insert prototypes
+of all top-level functions just before the first function definition.
+
+Usage: ino2cpp.py <sketch.ino> <output.cpp>
+"""
+
+import re
+import sys
+
+# Top-level function definition: starts at column 0, ends with '{' on the same line
+FUNC_RE = re.compile(
+    r'^(?P<ret>[A-Za-z_][\w:<>\*&\s]*?[\s\*&])(?P<name>[A-Za-z_]\w*)\s*\((?P<args>[^;{}()]*)\)\s*\{',
+    re.MULTILINE)
+KEYWORDS = {'if', 'for', 'while', 'switch', 'return', 'else', 'do'}
+
+
+def main():
+    src_path, out_path = sys.argv[1], sys.argv[2]
+    with open(src_path) as f:
+        src = f.read()
+
+    prototypes = []
+    first = None
+    for m in FUNC_RE.finditer(src):
+        ret = m.group('ret').strip()
+        name = m.group('name')
+        if name in KEYWORDS or ret.split()[0] in KEYWORDS or ret.startswith(('struct', 'class', 'enum')):
+            continue
+        if first is None:
+            first = m.start()
+        prototypes.append('%s %s(%s);' % (ret, name, ' '.join(m.group('args').split())))
+
+    if first is None:
+        first = len(src)
+    line = src.count('\n', 0, first) + 1
+
+    with open(out_path, 'w') as f:
+        f.write('#include <Arduino.h>\n')
+        f.write('#line 1 "%s"\n' % src_path)
+        f.write(src[:first])
+        f.write('\n'.join(prototypes) + '\n')
+        f.write('#line %d "%s"\n' % (line, src_path))
+        f.write(src[first:])
+
+
+if __name__ == '__main__':
+    main()
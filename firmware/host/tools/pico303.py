@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+"""ctypes binding for libpico303 (firmware/host/lib/pico303.h).
+
+    from pico303 import Engine
+    with Engine("build-host/libpico303.so", 44100) as synth:
+        synth.note_on(0, 36, 100)
+        synth.set_cc(11025, 74, 90)
+        pcm = array.array("h", bytes(4 * 44100))   # 1 s of interleaved stereo
+        synth.render(pcm)                           # written in place, no copy
+
+render() accepts any writable buffer of int16 samples (array.array("h"),
+bytearray, a numpy int16 array, ...) and renders len // 2 frames into it.
+
+Run directly, it checks the library: rendering in random chunk sizes must
+match one long render, a snapshot restored mid-song must reproduce the
+rest of the song exactly, and a note must decay in the same time at 44.1
+and 48 kHz.
+
+    python3 tools/pico303.py build-host/libpico303.so
+"""
+
+import array
+import ctypes
+import random
+import struct
+import sys
+
+API_VERSION = 1
+
+OK = 0
+ERR_ARGUMENT = -1
+ERR_QUEUE_FULL = -2
+ERR_STATE = -3
+
+
+class ParamInfo(ctypes.Structure):
+    _fields_ = [("name", ctypes.c_char_p), ("cc", ctypes.c_uint8), ("min_value", ctypes.c_uint8),
+                ("max_value", ctypes.c_uint8), ("default_value", ctypes.c_uint8)]
+
+
+def load(path):
+    """Opens the library and declares the C signatures."""
+    lib = ctypes.CDLL(path)
+    engine = ctypes.c_void_p
+    u8, u32, i32 = ctypes.c_uint8, ctypes.c_uint32, ctypes.c_int32
+    signatures = {
+        "pico303_api_version": (u32, []),
+        "pico303_render_version": (u32, []),
+        "pico303_create": (engine, [u32]),
+        "pico303_destroy": (None, [engine]),
+        "pico303_param_count": (u32, []),
+        "pico303_param_info_get": (i32, [u32, ctypes.POINTER(ParamInfo)]),
+        "pico303_param_id": (i32, [u8]),
+        "pico303_set_cc": (i32, [engine, u32, u8, u8]),
+        "pico303_set_param": (i32, [engine, u32, u32, u8]),
+        "pico303_note_on": (i32, [engine, u32, u8, u8]),
+        "pico303_note_off": (i32, [engine, u32, u8]),
+        "pico303_set_tempo": (i32, [engine, u32, ctypes.c_float]),
+        "pico303_pending_events": (u32, [engine]),
+        "pico303_render": (i32, [engine, ctypes.c_void_p, u32]),
+        "pico303_position": (ctypes.c_uint64, [engine]),
+        "pico303_snapshot": (ctypes.c_size_t, [engine, ctypes.c_void_p, ctypes.c_size_t]),
+        "pico303_restore": (i32, [engine, ctypes.c_void_p, ctypes.c_size_t]),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        fn = getattr(lib, name)
+        fn.restype = restype
+        fn.argtypes = argtypes
+    if lib.pico303_api_version() != API_VERSION:
+        raise OSError("%s: API version %d, expected %d" % (path, lib.pico303_api_version(), API_VERSION))
+    return lib
+
+
+def _check(status, what):
+    if status != OK:
+        raise ValueError("%s failed (%d)" % (what, status))
+
+
+class Engine:
+    """One engine. Event offsets count frames from the start of the next render()."""
+
+    def __init__(self, library, sample_rate=44100):
+        self.lib = load(library) if isinstance(library, str) else library
+        self.handle = self.lib.pico303_create(sample_rate)
+        if not self.handle:
+            raise ValueError("cannot create an engine at %d Hz" % sample_rate)
+        self.sample_rate = sample_rate
+
+    def close(self):
+        if self.handle:
+            self.lib.pico303_destroy(self.handle)
+            self.handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+    def params(self):
+        """The CC map as (name, cc, min, max, default) tuples; the index is the parameter ID."""
+        info = ParamInfo()
+        result = []
+        for i in range(self.lib.pico303_param_count()):
+            _check(self.lib.pico303_param_info_get(i, ctypes.byref(info)), "param_info_get")
+            result.append((info.name.decode(), info.cc, info.min_value, info.max_value, info.default_value))
+        return result
+
+    def set_cc(self, offset, cc, value):
+        _check(self.lib.pico303_set_cc(self.handle, offset, cc, value), "set_cc")
+
+    def set_param(self, offset, param_id, value):
+        _check(self.lib.pico303_set_param(self.handle, offset, param_id, value), "set_param")
+
+    def note_on(self, offset, note, velocity=100):
+        _check(self.lib.pico303_note_on(self.handle, offset, note, velocity), "note_on")
+
+    def note_off(self, offset, note):
+        _check(self.lib.pico303_note_off(self.handle, offset, note), "note_off")
+
+    def set_tempo(self, offset, bpm):
+        _check(self.lib.pico303_set_tempo(self.handle, offset, bpm), "set_tempo")
+
+    def render(self, out):
+        """Renders len(out) // 2 stereo frames into a writable int16 buffer."""
+        view = memoryview(out).cast("B")
+        frames = len(view) // 4
+        if frames:
+            pointer = ctypes.addressof(ctypes.c_char.from_buffer(view))
+            _check(self.lib.pico303_render(self.handle, pointer, frames), "render")
+        return frames
+
+    @property
+    def position(self):
+        return self.lib.pico303_position(self.handle)
+
+    def snapshot(self):
+        """The engine state as bytes (the .p3sn file layout)."""
+        size = self.lib.pico303_snapshot(self.handle, None, 0)
+        buffer = ctypes.create_string_buffer(size)
+        self.lib.pico303_snapshot(self.handle, buffer, size)
+        return buffer.raw
+
+    def restore(self, data):
+        _check(self.lib.pico303_restore(self.handle, data, len(data)), "restore")
+
+
+def _queue_pattern(synth, rng, start, frames):
+    """A 1/16 acid line at 130 BPM with random cutoff moves. Only events at or
+    after frame start are queued, with offsets relative to start."""
+    step = synth.sample_rate * 60 // 130 // 4
+    events = []
+    note = None
+    for t in range(0, frames, step):
+        at = t + rng.randrange(step // 4)
+        pitch = 36 + rng.randrange(24)
+        events.append((at, synth.note_on, pitch, 127 if rng.randrange(3) == 0 else 80))
+        if note is not None:
+            events.append((at + (1 if rng.randrange(4) == 0 else 0), synth.note_off, note))
+        note = pitch
+        if rng.randrange(2):
+            events.append((at + rng.randrange(step), synth.set_cc, 74, rng.randrange(128)))
+    for at, method, *args in events:
+        if at >= start:
+            method(at - start, *args)
+
+
+def _decay_seconds(lib, rate):
+    """Time for a held note to fall below 10% of its peak RMS, in 10 ms windows."""
+    with Engine(lib, rate) as synth:
+        synth.set_cc(0, 83, 0)   # delay mix off, so only the voice is measured
+        synth.note_on(0, 45, 100)
+        pcm = array.array("h", bytes(rate * 4))
+        synth.render(pcm)
+    window = rate // 100
+    energy = [sum(x * x for x in pcm[i * 2:(i + window) * 2:2]) for i in range(0, rate - window + 1, window)]
+    peak = energy.index(max(energy))
+    for i in range(peak, len(energy)):
+        if energy[i] < 0.01 * energy[peak]:   # 10% in RMS
+            return i / 100.0
+    return None
+
+
+def _self_check(library):
+    lib = load(library)
+    rate = 44100
+    frames = rate * 6
+    ok = True
+
+    def report(name, passed, detail):
+        print("%-24s %s  %s" % (name, "PASS" if passed else "FAIL", detail))
+        return passed
+
+    def setup(synth):
+        synth.set_param(0, synth.lib.pico303_param_id(83), 60)   # delay mix
+        synth.set_tempo(0, 130.0)
+        _queue_pattern(synth, random.Random(303), 0, frames)
+
+    with Engine(lib, rate) as synth:
+        setup(synth)
+        reference = array.array("h", bytes(frames * 4))
+        synth.render(reference)
+
+    with Engine(lib, rate) as synth:
+        setup(synth)
+        chunked = array.array("h", bytes(frames * 4))
+        view = memoryview(chunked)
+        rng = random.Random(1)
+        pos = 0
+        snap, snap_at = None, frames // 2
+        while pos < frames:
+            n = min(1 + rng.randrange(4096), frames - pos)
+            if pos <= snap_at < pos + n:
+                n = snap_at - pos or n
+            synth.render(view[pos * 2:(pos + n) * 2])
+            pos += n
+            if pos == snap_at:
+                snap = synth.snapshot()
+        differ = sum(1 for a, b in zip(reference, chunked) if a != b)
+        ok &= report("chunked render", differ == 0, "%d samples differ from one long render" % differ)
+
+        # Damaged snapshots are offered after a good restore; the tail below
+        # then shows that the rejected ones left the engine unchanged
+        synth.restore(snap)
+        rejected = []
+        damaged = [("truncated snapshot", snap[:-1])]
+        # The delay's write index (1 s line) is followed by its sample rate,
+        # and nine values on by the length of its left buffer
+        key = struct.pack("<if", snap_at % 44100, float(rate))
+        at = snap.find(key)
+        while at >= 0 and snap[at + 36:at + 40] != struct.pack("<I", 44100):
+            at = snap.find(key, at + 1)
+        if at >= 0:
+            for name, offset, value in (("write index", at, struct.pack("<i", 1 << 20)),
+                                        ("delay time", at + 8, struct.pack("<f", float("nan")))):
+                data = bytearray(snap)
+                data[offset:offset + 4] = value
+                damaged.append(("tampered " + name, bytes(data)))
+        else:
+            ok &= report("tampered snapshot", False, "delay write index not found")
+        # The filter's model byte follows the oscillator's 57 bytes of state
+        # (after the 24-byte header) and precedes the filter's sample rate
+        model = 24 + 57
+        if snap[model] in (0, 1) and snap[model + 1:model + 5] == struct.pack("<f", float(rate)):
+            data = bytearray(snap)
+            data[model] = 2
+            damaged.append(("tampered filter model", bytes(data)))
+        else:
+            ok &= report("tampered snapshot", False, "filter model not found")
+        for name, data in damaged:
+            try:
+                synth.restore(data)
+                ok &= report(name, False, "accepted")
+            except ValueError:
+                rejected.append(name)
+
+        # Re-queue the second half of the song from the snapshot point
+        _queue_pattern(synth, random.Random(303), snap_at, frames)
+        tail = array.array("h", bytes((frames - snap_at) * 4))
+        synth.render(tail)
+        differ = sum(1 for a, b in zip(reference[snap_at * 2:], tail) if a != b)
+        ok &= report("snapshot restore", differ == 0 and synth.position == frames,
+                     "%d bytes, %d samples of the tail differ" % (len(snap), differ))
+        for name in rejected:
+            ok &= report(name, differ == 0, "rejected, engine unchanged")
+
+        ok &= report("parameters", len(synth.params()) == lib.pico303_param_count(),
+                     "%d, render version %d" % (len(synth.params()), lib.pico303_render_version()))
+
+    decay = {r: _decay_seconds(lib, r) for r in (44100, 48000)}
+    ok &= report("sample rate", None not in decay.values() and abs(decay[44100] - decay[48000]) <= 0.01,
+                 "decay to 10%% RMS: %s s at 44.1 kHz, %s s at 48 kHz" % (decay[44100], decay[48000]))
+    return ok
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("Usage: %s path/to/libpico303.so" % sys.argv[0])
+    sys.exit(0 if _self_check(sys.argv[1]) else 1)
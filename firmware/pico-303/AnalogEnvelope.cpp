@@ -4,25 +4,31 @@
  */
 
 #include "AnalogEnvelope.h"
+#include "HotPath.h"
+#include "CoefficientTables.h"
 
 void AnalogEnvelope::setSampleRate(float sr) {
+  if (sr == sampleRate) return;
   sampleRate = sr;
-  calculateCoeffs();
+  dirty = true;
 }
 
 void AnalogEnvelope::setDecay(float ms) {
+  if (ms == decayTime) return;
   decayTime = ms;
-  calculateCoeffs();
+  dirty = true;
 }
 
 void AnalogEnvelope::setRelease(float ms) {
+  if (ms == releaseTime) return;
   releaseTime = ms;
-  calculateCoeffs();
+  dirty = true;
 }
 
 void AnalogEnvelope::setAttack(float ms) {
+  if (ms == attackTime) return;
   attackTime = ms;
-  calculateCoeffs();
+  dirty = true;
 }
 
 void AnalogEnvelope::noteOn() {
@@ -39,7 +45,7 @@ void AnalogEnvelope::noteOff() {
   state = RELEASE;
 }
 
-float AnalogEnvelope::process() {
+float DSP_HOT_FUNC(AnalogEnvelope::process)() {
   if (state == ATTACK) {
     currentLevel += attackCoeff;
     if (currentLevel >= 1.0f) {
@@ -68,10 +74,11 @@ bool AnalogEnvelope::isActive() const {
 }
 
 void AnalogEnvelope::calculateCoeffs() {
-  decayCoeff = std::exp(-1.0f / (0.001f * decayTime * sampleRate));
-  releaseCoeff = std::exp(-1.0f / (0.001f * releaseTime * sampleRate));
+  decayCoeff = 1.0f - onePoleForTime(decayTime, sampleRate);
+  releaseCoeff = 1.0f - onePoleForTime(releaseTime, sampleRate);
   // Linear attack: increment per sample = 1.0 / (samples)
   float attackSamples = 0.001f * attackTime * sampleRate;
   if (attackSamples < 1.0f) attackSamples = 1.0f;
   attackCoeff = 1.0f / attackSamples;
+  dirty = false;
 }
@@ -37,6 +37,12 @@ public:
    * @param ms Attack time in milliseconds
    */
   void setAttack(float ms);
+
+  /**
+   * @brief Applies changed times to the per-sample coefficients. The setters
+   * above only record the new time; call this before the next process().
+   */
+  void update() { if (dirty) calculateCoeffs(); }
   
   /**
    * @brief Triggers the Note On event (starts Attack phase).
@@ -60,21 +66,42 @@ public:
    */
   bool isActive() const;
 
+  /**
+   * @brief Visits stage, level and coefficients (engine snapshots).
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.value(state, IDLE, RELEASE);
+    ar.value(isNoteOn, false, true);
+    ar.value(sampleRate);
+    ar.value(decayTime);
+    ar.value(releaseTime);
+    ar.value(attackTime);
+    ar.value(decayCoeff);
+    ar.value(releaseCoeff);
+    ar.value(attackCoeff);
+    ar.value(currentLevel);
+  }
+
 private:
+  friend struct LaneRenderer;  // Host SIMD renderer (firmware/host/batch/LaneRenderer.h)
+
   enum State { IDLE, ATTACK, DECAY, RELEASE };
+
+  // Per-sample: process() and the engine's isActive() check
   State state = IDLE;
+  float currentLevel = 0.0f;
+  float attackCoeff = 0.1f;
+  float decayCoeff = 0.99f;
+  float releaseCoeff = 0.9f;
   bool isNoteOn = false;
-  
+
+  // Settings the coefficients are computed from
   float sampleRate = 44100.0f;
   float decayTime = 1000.0f;
   float releaseTime = 10.0f;
   float attackTime = 3.0f; // Default 3ms attack
-  
-  float decayCoeff = 0.99f;
-  float releaseCoeff = 0.9f;
-  float attackCoeff = 0.1f;
-  
-  float currentLevel = 0.0f;
+  bool dirty = true;
   
   void calculateCoeffs();
 };
@@ -0,0 +1,36 @@
+/**
+ * @file Arena.cpp
+ * @brief Implementation of the Arena class.
+ */
+
+#include "Arena.h"
+#include <stdio.h>
+
+Arena::Arena(void* storage, size_t capacity, const char* name)
+  : base(static_cast<uint8_t*>(storage)), size(capacity), label(name) {
+  // Storage that is not itself aligned loses its first few bytes
+  size_t skew = (size_t)(-(uintptr_t)base & (ARENA_ALIGN - 1));
+  if (skew > size) skew = size;
+  top = skew;
+  wanted = skew;
+}
+
+void* Arena::allocateBytes(size_t bytes, const char* owner) {
+  wanted += bytes;
+  if (bytes > size - top) return nullptr;
+  void* p = base + top;
+  if (entries < kMaxEntries) {
+    table[entries++] = {owner, (uint32_t)top, (uint32_t)bytes};
+  }
+  top += bytes;
+  return p;
+}
+
+void Arena::formatEntry(char* line, size_t n, const Entry& e) const {
+  snprintf(line, n, "%-6s +%06lx %8lu  %s", label, (unsigned long)e.offset, (unsigned long)e.bytes, e.owner);
+}
+
+void Arena::formatTotal(char* line, size_t n) const {
+  snprintf(line, n, "%-6s used %lu of %lu bytes%s", label, (unsigned long)top, (unsigned long)size,
+           overflowed() ? " - OVERFLOW, requests did not fit" : "");
+}
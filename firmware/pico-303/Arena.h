@@ -0,0 +1,97 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file Arena.h
+ * @brief Init-time allocator that hands out DSP buffers from one static block.
+ */
+
+#ifndef ARENA_ALIGN
+#define ARENA_ALIGN 32  ///< Every buffer starts on this boundary (DMA bursts, 256-bit SIMD)
+#endif
+
+// Places arena storage in a linker section (device only; the host keeps it in .bss)
+#if defined(ARDUINO_ARCH_RP2040)
+#define ARENA_SECTION(name) __attribute__((section(name)))
+#else
+#define ARENA_SECTION(name)
+#endif
+
+/**
+ * @class Arena
+ * @brief Bump allocator over caller-provided storage.
+ *
+ * Modules request their buffers in begin(), through allocate<T>(), and keep
+ * them for the life of the program; there is no free. The arena records
+ * each request under its owner's name, so report() prints the memory map.
+ * A request that does not fit returns nullptr, which the module turns into
+ * a begin() failure, and is still counted, so the report shows the
+ * shortfall.
+ */
+class Arena {
+public:
+  struct Entry {
+    const char* owner;
+    uint32_t offset;
+    uint32_t bytes;
+  };
+  static const int kMaxEntries = 16;
+
+  Arena(void* storage, size_t capacity, const char* name);
+
+  /**
+   * @brief Size of a buffer of count T's, rounded up to the arena alignment.
+   * Use it to size arena storage at compile time.
+   */
+  template <typename T>
+  static constexpr size_t bytesFor(size_t count) {
+    return (count * sizeof(T) + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+  }
+
+  /**
+   * @brief Returns uninitialized, ARENA_ALIGN-aligned space for count T's,
+   * or nullptr if the arena is full.
+   */
+  template <typename T>
+  T* allocate(size_t count, const char* owner) {
+    static_assert(alignof(T) <= ARENA_ALIGN, "Type needs more than ARENA_ALIGN");
+    return static_cast<T*>(allocateBytes(bytesFor<T>(count), owner));
+  }
+
+  size_t used() const { return top; }
+  size_t capacity() const { return size; }
+  size_t requested() const { return wanted; }   ///< Including requests that failed
+  bool overflowed() const { return wanted > size; }
+  const char* name() const { return label; }
+  int entryCount() const { return entries; }
+  const Entry& entry(int i) const { return table[i]; }
+
+  /**
+   * @brief Writes the memory map, one line per buffer plus a total.
+   * @param print Called with each line (no trailing newline)
+   */
+  template <class Print>
+  void report(Print print) const {
+    char line[80];
+    for (int i = 0; i < entries; i++) {
+      formatEntry(line, sizeof(line), table[i]);
+      print(line);
+    }
+    formatTotal(line, sizeof(line));
+    print(line);
+  }
+
+private:
+  void* allocateBytes(size_t bytes, const char* owner);
+  void formatEntry(char* line, size_t n, const Entry& e) const;
+  void formatTotal(char* line, size_t n) const;
+
+  uint8_t* base;
+  size_t size;
+  size_t top = 0;
+  size_t wanted = 0;
+  const char* label;
+  Entry table[kMaxEntries];
+  int entries = 0;
+};
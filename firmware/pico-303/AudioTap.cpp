@@ -0,0 +1,21 @@
+/**
+ * @file AudioTap.cpp
+ * @brief Implementation of the AudioTap class.
+ */
+
+#include "AudioTap.h"
+
+bool AudioTap::snapshot(Channel ch, float* dest, int n) const {
+  if (n > kSize / 2) n = kSize / 2;
+
+  uint32_t end = writePos.load(std::memory_order_acquire);
+  uint32_t start = end - n;
+  for (int i = 0; i < n; i++) {
+    dest[i] = buffer[ch][(start + i) & (kSize - 1)];
+  }
+
+  // Slots [start, end) stay valid until the writer wraps into them. The writer
+  // may already be up to one block past the published position, so keep a margin.
+  uint32_t now = writePos.load(std::memory_order_acquire);
+  return (now - start) <= (uint32_t)(kSize - kSize / 4);
+}
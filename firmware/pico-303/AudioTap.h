@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * @file AudioTap.h
+ * @brief Decimated, wait-free copy of the audio signal for scope/spectrum views.
+ */
+
+/**
+ * @class AudioTap
+ * @brief Ring buffer written by the audio thread and read by the UI.
+ * The writer never waits: it fills slots and publishes the write position
+ * once per block. The reader copies the most recent samples and detects
+ * (instead of preventing) being overtaken by the writer.
+ * When not armed the audio thread skips it entirely.
+ */
+class AudioTap {
+public:
+  enum Channel {
+    POST_VCA,   ///< Filter output after the VCA, before distortion
+    OUTPUT,     ///< Final left output after soft clipping, normalized to [-1, 1]
+    NUM_CHANNELS
+  };
+
+  static const int kDecimation = 4;  ///< 44.1kHz -> 11.025kHz
+  static const int kSize = 512;      ///< Samples per channel (power of two)
+
+  /**
+   * @brief Enables or disables the tap (UI side).
+   */
+  void arm(bool on) { armed.store(on, std::memory_order_relaxed); }
+
+  /**
+   * @brief Checks whether the audio thread should feed the tap.
+   * Read once per block.
+   */
+  bool isArmed() const { return armed.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Accumulates one full-rate sample pair (audio side).
+   * Every kDecimation samples the boxcar average is stored.
+   */
+  inline void write(float postVca, float output) {
+    accVca += postVca;
+    accOut += output;
+    if (++phase == kDecimation) {
+      uint32_t slot = pending & (kSize - 1);
+      buffer[POST_VCA][slot] = accVca * (1.0f / kDecimation);
+      buffer[OUTPUT][slot] = accOut * (1.0f / kDecimation);
+      pending++;
+      accVca = accOut = 0.0f;
+      phase = 0;
+    }
+  }
+
+  /**
+   * @brief Makes the samples written so far visible to the reader (audio side).
+   * Call once at the end of each block.
+   */
+  void publish() { writePos.store(pending, std::memory_order_release); }
+
+  /**
+   * @brief Copies the most recent samples of one channel (UI side).
+   * @param ch Channel to read
+   * @param dest Destination buffer
+   * @param n Number of samples (at most kSize / 2)
+   * @return false if the writer overtook the copy; discard the result
+   */
+  bool snapshot(Channel ch, float* dest, int n) const;
+
+private:
+  std::atomic<bool> armed{false};
+  std::atomic<uint32_t> writePos{0};
+
+  // Audio-side state
+  uint32_t pending = 0;
+  int phase = 0;
+  float accVca = 0.0f;
+  float accOut = 0.0f;
+
+  float buffer[NUM_CHANNELS][kSize];
+};
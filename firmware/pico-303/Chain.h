@@ -0,0 +1,44 @@
+#pragma once
+#include <type_traits>
+
+/**
+ * @file Chain.h
+ * @brief Processing chains composed at compile time.
+ */
+
+/**
+ * @struct Chain
+ * @brief Runs a fixed list of stages, in order, on one sample.
+ *
+ * A stage is a type with a static
+ * `process(Context&, Signals&, Probe&)` that reads and writes the signals
+ * of the current sample. The chain is a type rather than a list of
+ * objects. Each build therefore gets its own loop body with every stage
+ * call inlined, and a stage left out of the list costs nothing, not even
+ * a branch.
+ */
+template <typename... Stages>
+struct Chain {
+  template <class Context, class Signals, class Probe>
+  static inline __attribute__((always_inline)) void process(Context& context, Signals& signals, Probe& probe) {
+    (Stages::process(context, signals, probe), ...);
+  }
+
+  /**
+   * @brief True if Stage is part of this chain.
+   */
+  template <typename Stage>
+  static constexpr bool has() {
+    return (std::is_same<Stage, Stages>::value || ...);
+  }
+
+  /**
+   * @brief True if Stage is the last stage of this chain.
+   */
+  template <typename Stage>
+  static constexpr bool endsWith() {
+    bool last = false;
+    ((last = std::is_same<Stage, Stages>::value), ...);
+    return last;
+  }
+};
@@ -0,0 +1,27 @@
+/**
+ * @file CoefficientTables.cpp
+ * @brief Tables for the supported sample rates and the runtime fallback.
+ */
+
+#include "CoefficientTables.h"
+#include <cmath>
+
+namespace {
+
+// constexpr forces both to be computed at compile time; they live in flash
+constexpr CoefficientTables<44100> kTables44100;
+constexpr CoefficientTables<48000> kTables48000;
+
+}  // namespace
+
+float onePoleForTime(float ms, float sampleRate) {
+  if (sampleRate == 44100.0f) return TimeGrid::lookup(kTables44100.timeStep, ms);
+  if (sampleRate == 48000.0f) return TimeGrid::lookup(kTables48000.timeStep, ms);
+  return 1.0f - std::exp(-1.0f / (0.001f * ms * sampleRate));
+}
+
+float onePoleForCutoff(float hz, float sampleRate) {
+  if (sampleRate == 44100.0f) return CutoffGrid::lookup(kTables44100.cutoffStep, hz);
+  if (sampleRate == 48000.0f) return CutoffGrid::lookup(kTables48000.cutoffStep, hz);
+  return 1.0f - std::exp(-2.0f * (float)M_PI * hz / sampleRate);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @file CoefficientTables.h
+ * @brief One-pole filter coefficients read from tables built at compile time.
+ *
+ * Every smoother, envelope and DC filter in the engine derives its
+ * coefficient from one of two formulas:
+ *
+ *   time constant:  1 - exp(-1 / (0.001 * ms * fs))
+ *   cutoff:         1 - exp(-2 pi hz / fs)
+ *
+ * For the sample rates listed in CoefficientTables.cpp both are tabulated by
+ * the compiler, so a setter costs a table read and startup runs no exp().
+ * Other rates (host tools may pick any) fall back to std::exp.
+ */
+
+/**
+ * @brief 1 - exp(-1 / (0.001 * ms * sampleRate)): the per-sample step of a
+ * one-pole smoother with time constant ms. Decay factor = 1 - step.
+ */
+float onePoleForTime(float ms, float sampleRate);
+
+/**
+ * @brief 1 - exp(-2 pi hz / sampleRate): the step of a one-pole lowpass
+ * with cutoff hz.
+ */
+float onePoleForCutoff(float hz, float sampleRate);
+
+/**
+ * @brief Compile-time e^x in double precision, for building tables.
+ */
+constexpr double constExp(double x) {
+  // e^x = 2^n * e^r with |r| <= ln(2)/2, then a Taylor series for e^r
+  int n = (int)(x * 1.4426950408889634 + (x < 0 ? -0.5 : 0.5));
+  double r = x - n * 0.6931471805599453;
+  double term = 1.0, sum = 1.0;
+  for (int k = 1; k < 20; k++) {
+    term *= r / k;
+    sum += term;
+  }
+  for (; n > 0; n--) sum *= 2.0;
+  for (; n < 0; n++) sum *= 0.5;
+  return sum;
+}
+
+/**
+ * @struct OctaveGrid
+ * @brief Table points 2^e * (1 + j/32) for octaves e = MinOctave ...
+ * MinOctave + Octaves - 1: logarithmic from octave to octave, linear within
+ * one. A float's exponent and top five mantissa bits are then its row and
+ * the remaining bits the position between two rows, so a lookup needs no
+ * log(). Linear interpolation keeps the relative error of the time
+ * constant or cutoff below 3e-4.
+ */
+template <int MinOctave, int Octaves>
+struct OctaveGrid {
+  static constexpr int kStepsPerOctave = 32;
+  static constexpr int kSize = Octaves * kStepsPerOctave + 1;
+
+  static constexpr double scale(int octave) {
+    double s = 1.0;
+    for (; octave > 0; octave--) s *= 2.0;
+    for (; octave < 0; octave++) s *= 0.5;
+    return s;
+  }
+
+  /// Grid value of row i
+  static constexpr double point(int i) {
+    return scale(MinOctave + i / kStepsPerOctave) * (1.0 + (double)(i % kStepsPerOctave) / kStepsPerOctave);
+  }
+
+  /// Interpolated table value at x; clamps to the first and last row
+  static float lookup(const float* table, float x) {
+    if (!(x > (float)scale(MinOctave))) return table[0];
+    if (x >= (float)scale(MinOctave + Octaves)) return table[kSize - 1];
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    uint32_t row = ((bits >> 23) - (127 + MinOctave)) * kStepsPerOctave + ((bits >> 18) & 31);
+    float frac = (float)(bits & 0x3FFFF) * (1.0f / 0x40000);
+    return table[row] + frac * (table[row + 1] - table[row]);
+  }
+};
+
+using TimeGrid = OctaveGrid<-4, 19>;    ///< 1/16 ms to 32.8 s
+using CutoffGrid = OctaveGrid<0, 15>;   ///< 1 Hz to 32.8 kHz
+
+/**
+ * @struct CoefficientTables
+ * @brief Both tables for one sample rate, filled by the compiler.
+ */
+template <int SampleRate>
+struct CoefficientTables {
+  float timeStep[TimeGrid::kSize];
+  float cutoffStep[CutoffGrid::kSize];
+
+  constexpr CoefficientTables() : timeStep(), cutoffStep() {
+    for (int i = 0; i < TimeGrid::kSize; i++) {
+      timeStep[i] = (float)(1.0 - constExp(-1.0 / (0.001 * TimeGrid::point(i) * SampleRate)));
+    }
+    for (int i = 0; i < CutoffGrid::kSize; i++) {
+      cutoffStep[i] = (float)(1.0 - constExp(-6.283185307179586 * CutoffGrid::point(i) / SampleRate));
+    }
+  }
+};
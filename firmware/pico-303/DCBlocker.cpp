@@ -4,18 +4,22 @@
  */
 
 #include "DCBlocker.h"
+#include "HotPath.h"
+#include "CoefficientTables.h"
 
 void DCBlocker::setSampleRate(float sr) {
+  if (sr == sampleRate) return;
   sampleRate = sr;
-  calculateCoeff();
+  dirty = true;
 }
 
 void DCBlocker::setCutoff(float hz) {
+  if (hz == cutoff) return;
   cutoff = hz;
-  calculateCoeff();
+  dirty = true;
 }
 
-float DCBlocker::process(float input) {
+float DSP_HOT_FUNC(DCBlocker::process)(float input) {
   // y[n] = x[n] - x[n-1] + R * y[n-1]
   // Simple DC blocker algorithm
   float output = input - lastInput + R * lastOutput;
@@ -26,7 +30,7 @@ float DCBlocker::process(float input) {
 
 // Alternative 1-pole HPF: y = x - lpf(x)
 // This is often more stable for simple HPF use
-float DCBlocker::processHPF(float input) {
+float DSP_HOT_FUNC(DCBlocker::processHPF)(float input) {
   lpfState += (input - lpfState) * alpha;
   return input - lpfState;
 }
@@ -37,5 +41,6 @@ void DCBlocker::calculateCoeff() {
   
   // For 1-pole HPF via LPF subtraction:
   // alpha = 1 - exp(-2*pi*fc/fs)
-  alpha = 1.0f - std::exp(-2.0f * M_PI * cutoff / sampleRate);
+  alpha = onePoleForCutoff(cutoff, sampleRate);
+  dirty = false;
 }
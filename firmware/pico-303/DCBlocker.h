@@ -25,6 +25,12 @@ public:
    */
   void setCutoff(float hz);
 
+  /**
+   * @brief Brings R and alpha up to date with the sample rate and cutoff.
+   * The setters defer this work; call it before processing.
+   */
+  void update() { if (dirty) calculateCoeff(); }
+
   /**
    * @brief Processes a sample using the standard DC blocker algorithm.
    * @param input Audio input sample
@@ -40,15 +46,33 @@ public:
    */
   float processHPF(float input);
 
+  /**
+   * @brief Visits filter state and coefficients (engine snapshots).
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.value(sampleRate);
+    ar.value(cutoff);
+    ar.value(R);
+    ar.value(lastInput);
+    ar.value(lastOutput);
+    ar.value(lpfState);
+    ar.value(alpha);
+  }
+
 private:
-  float sampleRate = 44100.0f;
-  float cutoff = 25.0f;
-  float R = 0.995f;
-  float lastInput = 0.0f;
-  float lastOutput = 0.0f;
-  
+  friend struct LaneRenderer;  // Host SIMD renderer (firmware/host/batch/LaneRenderer.h)
+
+  // processHPF() (the engine's choice), then process()
   float lpfState = 0.0f;
   float alpha = 0.1f;
+  float lastInput = 0.0f;
+  float R = 0.995f;
+  float lastOutput = 0.0f;
+
+  float sampleRate = 44100.0f;
+  float cutoff = 25.0f;
+  bool dirty = true;
 
   void calculateCoeff();
 };
@@ -4,22 +4,26 @@
  */
 
 #include "DecayEnvelope.h"
+#include "HotPath.h"
+#include "CoefficientTables.h"
 
 void DecayEnvelope::setSampleRate(float sr) {
+  if (sr == sampleRate) return;
   sampleRate = sr;
-  calculateCoeff();
+  dirty = true;
 }
 
 void DecayEnvelope::setDecayTime(float ms) {
+  if (ms == decayTime) return;
   decayTime = ms;
-  calculateCoeff();
+  dirty = true;
 }
 
 void DecayEnvelope::trigger() {
   y = 1.0f;
 }
 
-float DecayEnvelope::process() {
+float DSP_HOT_FUNC(DecayEnvelope::process)() {
   y *= coeff;
   return y;
 }
@@ -33,5 +37,6 @@ void DecayEnvelope::calculateCoeff() {
   // y *= c  =>  y(t) = y(0) * c^(t*fs)
   // We want y(tau) = 1/e * y(0) ? Or just standard time constant?
   // Rosic: c = exp( -1.0 / (0.001*tau*fs) )
-  coeff = std::exp(-1.0f / (0.001f * decayTime * sampleRate));
+  coeff = 1.0f - onePoleForTime(decayTime, sampleRate);
+  dirty = false;
 }
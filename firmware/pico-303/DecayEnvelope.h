@@ -21,10 +21,15 @@ public:
   void setSampleRate(float sr);
   
   /**
-   * @brief Sets the decay time.
+   * @brief Sets the decay time. Takes effect at the next update().
    * @param ms Decay time in milliseconds
    */
   void setDecayTime(float ms);
+
+  /**
+   * @brief Recomputes the decay coefficient if a setting changed.
+   */
+  void update() { if (dirty) calculateCoeff(); }
   
   /**
    * @brief Triggers the envelope (resets level to 1.0).
@@ -43,11 +48,26 @@ public:
    */
   float getCurrentValue() const;
 
+  /**
+   * @brief Visits level and coefficient (engine snapshots).
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.value(sampleRate);
+    ar.value(decayTime);
+    ar.value(coeff);
+    ar.value(y);
+  }
+
 private:
+  friend struct LaneRenderer;  // Host SIMD renderer (firmware/host/batch/LaneRenderer.h)
+
+  float y = 0.0f;
+  float coeff = 0.99f;
+
   float sampleRate = 44100.0f;
   float decayTime = 200.0f;
-  float coeff = 0.99f;
-  float y = 0.0f;
+  bool dirty = true;  // coeff does not match the settings yet
   
   void calculateCoeff();
 };
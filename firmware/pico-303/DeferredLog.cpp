@@ -0,0 +1,97 @@
+/**
+ * @file DeferredLog.cpp
+ * @brief Implementation of the DeferredLog class.
+ */
+
+#include "DeferredLog.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* const kCategoryNames[LOG_CATEGORY_COUNT] = {
+  "note", "cc", "clock", "sysex", "audio"
+};
+
+uint8_t DeferredLog::coreIndex() {
+#if defined(ARDUINO_ARCH_RP2040)
+  return get_core_num();
+#else
+  return 0;
+#endif
+}
+
+int DeferredLog::drain(Print& out, int maxEntries) {
+  char line[160];
+  int printed = 0;
+
+  for (Ring& ring : rings) {
+    uint32_t dropped = ring.dropped;
+    if (dropped != ring.reportedDropped) {
+      snprintf(line, sizeof(line), "[log] %lu messages dropped\n",
+               (unsigned long)(dropped - ring.reportedDropped));
+      out.print(line);
+      ring.reportedDropped = dropped;
+    }
+
+    Entry e;
+    while (printed < maxEntries && ring.queue.pop(e)) {
+      int len = snprintf(line, sizeof(line), "%10lu %-5s ",
+                         (unsigned long)e.timestamp, kCategoryNames[e.category]);
+      format(line + len, sizeof(line) - len, e);
+      out.print(line);
+      printed++;
+    }
+  }
+  return printed;
+}
+
+int DeferredLog::format(char* buf, int size, const Entry& e) {
+  // Walk the format string and print one conversion at a time, so each
+  // argument is passed to snprintf with the type its conversion expects.
+  const char* p = e.format;
+  int len = 0;
+  int arg = 0;
+
+  while (*p && len < size - 1) {
+    if (*p != '%') {
+      buf[len++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      buf[len++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // Copy the spec (flags, width, precision) without length modifiers
+    char spec[16];
+    int n = 0;
+    spec[n++] = *p++;
+    while (*p && !strchr("diouxXcfFeEgGs", *p)) {
+      if (!strchr("lhzjt", *p) && n < (int)sizeof(spec) - 2) spec[n++] = *p;
+      p++;
+    }
+    if (!*p) break;
+    char conv = *p++;
+    spec[n++] = conv;
+    spec[n] = '\0';
+
+    Arg a = (arg < e.argc) ? e.args[arg] : Arg{0};
+    arg++;
+
+    int room = size - len;
+    int w;
+    if (strchr("fFeEgG", conv)) {
+      w = snprintf(buf + len, room, spec, (double)a.f);
+    } else if (conv == 's') {
+      w = snprintf(buf + len, room, spec, a.s ? a.s : "(null)");
+    } else if (strchr("ouxX", conv)) {
+      w = snprintf(buf + len, room, spec, (unsigned)a.u);
+    } else {
+      w = snprintf(buf + len, room, spec, (int)a.i);
+    }
+    len += (w < room) ? w : room - 1;
+  }
+
+  buf[len] = '\0';
+  return len;
+}
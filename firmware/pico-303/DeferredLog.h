@@ -0,0 +1,112 @@
+#pragma once
+#include <Arduino.h>
+#include "SpscQueue.h"
+
+/**
+ * @file DeferredLog.h
+ * @brief Binary log ring: cheap to write from time-critical code, formatted later.
+ */
+
+/**
+ * @brief Log categories, each can be enabled separately via the mask.
+ */
+enum LogCategory : uint8_t {
+  LOG_NOTE,     ///< Note on/off
+  LOG_CC,       ///< Control changes
+  LOG_CLOCK,    ///< MIDI clock / tempo
+  LOG_SYSEX,    ///< SysEx commands
+  LOG_AUDIO,    ///< Audio engine
+  LOG_CATEGORY_COUNT
+};
+
+/**
+ * @class DeferredLog
+ * @brief Records a format string pointer (its ID, the literal lives in flash)
+ * plus up to kMaxArgs raw 32-bit arguments. Writing is a queue push; printf
+ * formatting happens in drain(), on the idle path or core 1.
+ * There is one ring per core so each stays single-producer. Do not log from ISRs.
+ */
+class DeferredLog {
+public:
+  static const int kMaxArgs = 6;
+  static const uint32_t kCapacity = 64;  ///< Entries per core
+
+  /**
+   * @brief Sets which categories are recorded (bit n = LogCategory n).
+   */
+  void setMask(uint32_t m) { mask = m; }
+  uint32_t getMask() const { return mask; }
+
+  /**
+   * @brief Checks whether a category is recorded.
+   */
+  bool isEnabled(LogCategory category) const { return mask & (1u << category); }
+
+  /**
+   * @brief Records a message. Costs a mask test and a queue push.
+   * @param category Message category
+   * @param format printf-style format string literal (must outlive the entry)
+   * @param args Up to kMaxArgs integer, float or string-literal arguments
+   */
+  template <typename... Args>
+  void write(LogCategory category, const char* format, Args... args) {
+    static_assert(sizeof...(Args) <= kMaxArgs, "Too many log arguments");
+    if (!isEnabled(category)) return;
+
+    Entry e;
+    e.format = format;
+    e.timestamp = micros();
+    e.category = category;
+    e.argc = 0;
+    int unused[] = {0, (store(e, args), 0)...};
+    (void)unused;
+
+    Ring& ring = rings[coreIndex()];
+    if (!ring.queue.push(e)) {
+      ring.dropped++;
+    }
+  }
+
+  /**
+   * @brief Formats and prints pending messages.
+   * @param out Destination (e.g. Serial)
+   * @param maxEntries Upper bound of messages printed per call
+   * @return Number of messages printed
+   */
+  int drain(Print& out, int maxEntries);
+
+private:
+  union Arg {
+    int32_t i;
+    uint32_t u;
+    float f;
+    const char* s;
+  };
+
+  struct Entry {
+    const char* format;
+    uint32_t timestamp;
+    uint8_t category;
+    uint8_t argc;
+    Arg args[kMaxArgs];
+  };
+
+  struct Ring {
+    SpscQueue<Entry, kCapacity> queue;
+    volatile uint32_t dropped = 0;
+    uint32_t reportedDropped = 0;
+  };
+
+  uint32_t mask = 0xFFFFFFFF;
+  Ring rings[2];
+
+  static void store(Entry& e, int v) { e.args[e.argc++].i = v; }
+  static void store(Entry& e, unsigned v) { e.args[e.argc++].u = v; }
+  static void store(Entry& e, long v) { e.args[e.argc++].i = (int32_t)v; }
+  static void store(Entry& e, unsigned long v) { e.args[e.argc++].u = (uint32_t)v; }
+  static void store(Entry& e, double v) { e.args[e.argc++].f = (float)v; }
+  static void store(Entry& e, const char* v) { e.args[e.argc++].s = v; }
+
+  static uint8_t coreIndex();
+  static int format(char* buf, int size, const Entry& e);
+};
@@ -4,6 +4,10 @@
  */
 
 #include "DisplayManager.h"
+#include <algorithm>
+#include <cmath>
+#include <hardware/dma.h>
+#include <hardware/i2c.h>
 
 const unsigned char DisplayManager::image_ButtonLeft_bits[] = {0x10,0x30,0x70,0xf0,0x70,0x30,0x10};
 
@@ -12,7 +16,7 @@ const unsigned char DisplayManager::image_ButtonUp_bits[] = {0x10,0x38,0x7c,0xfe
 const unsigned char DisplayManager::image_SmallArrowDown_bits[] = {0xfe,0x7c,0x38,0x10};
 
 DisplayManager::DisplayManager()
-  : display(DISPLAY_W, DISPLAY_H, &Wire1, -1)
+  : display(DISPLAY_W, DISPLAY_H, &Wire1, -1, 400000UL, 400000UL)
 {
 }
 
@@ -32,13 +36,106 @@ bool DisplayManager::begin(uint8_t sda, uint8_t scl) {
   display.setTextColor(SSD1306_WHITE);
   display.setTextSize(1);
   display.display();
+  memset(shadow, 0, sizeof(shadow));
+
+  // From here on the panel is fed by DMA straight into the I2C TX FIFO.
+  // Wire1 is only used by the display, so we own the bus and its target address.
+  i2c_hw_t* hw = i2c_get_hw(i2c1);
+  hw->enable = 0;
+  hw->tar = DISPLAY_I2C_ADDR;
+  hw->enable = 1;
+
+  dmaChannel = dma_claim_unused_channel(false);
+  if (dmaChannel >= 0) {
+    dma_channel_config c = dma_channel_get_default_config(dmaChannel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c1, true));
+    dma_channel_configure(dmaChannel, &c, &hw->data_cmd, txWords, 0, false);
+  }
   
   return true;
 }
 
 void DisplayManager::clear() {
   display.clearDisplay();
-  display.display();
+}
+
+void DisplayManager::invalidate() {
+  // Make every byte differ from the framebuffer so all pages get resent
+  const uint8_t* fb = display.getBuffer();
+  for (size_t i = 0; i < sizeof(shadow); i++) {
+    shadow[i] = ~fb[i];
+  }
+}
+
+bool DisplayManager::service() {
+  if (dmaChannel < 0) {
+    // No DMA channel available: fall back to a blocking full update
+    const uint8_t* fb = display.getBuffer();
+    if (memcmp(shadow, fb, sizeof(shadow)) == 0) return false;
+    display.display();
+    memcpy(shadow, fb, sizeof(shadow));
+    return false;
+  }
+
+  if (dma_channel_is_busy(dmaChannel)) return true;
+
+  // A NACK or arbitration loss drops the rest of the FIFO; resend everything
+  i2c_hw_t* hw = i2c_get_hw(i2c1);
+  if (hw->tx_abrt_source) {
+    (void)hw->clr_tx_abrt;
+    invalidate();
+  }
+
+  const uint8_t* fb = display.getBuffer();
+
+  // Round-robin over pages so a constantly changing page can't starve the others
+  for (uint8_t n = 0; n < DISPLAY_PAGES; n++) {
+    uint8_t page = (nextPage + n) % DISPLAY_PAGES;
+    const uint8_t* row = fb + page * DISPLAY_W;
+    const uint8_t* sent = shadow + page * DISPLAY_W;
+
+    int first = 0;
+    while (first < DISPLAY_W && row[first] == sent[first]) first++;
+    if (first == DISPLAY_W) continue;
+
+    int last = DISPLAY_W - 1;
+    while (row[last] == sent[last]) last--;
+    last = std::min(last, first + DISPLAY_CHUNK_BYTES - 1);
+
+    nextPage = (page + 1) % DISPLAY_PAGES;
+    return startChunk(page, first, last);
+  }
+
+  return false;
+}
+
+bool DisplayManager::startChunk(uint8_t page, uint8_t colStart, uint8_t colEnd) {
+  const uint8_t* fb = display.getBuffer() + page * DISPLAY_W;
+  uint8_t* sent = shadow + page * DISPLAY_W;
+  uint16_t n = 0;
+
+  // Transaction 1: set the column/page window (horizontal addressing mode)
+  txWords[n++] = 0x00;  // Co=0, D/C=0: command stream
+  txWords[n++] = SSD1306_COLUMNADDR;
+  txWords[n++] = colStart;
+  txWords[n++] = colEnd;
+  txWords[n++] = SSD1306_PAGEADDR;
+  txWords[n++] = page;
+  txWords[n++] = page | I2C_IC_DATA_CMD_STOP_BITS;
+
+  // Transaction 2: pixel data for the window
+  txWords[n++] = 0x40;  // Co=0, D/C=1: data stream
+  for (uint8_t col = colStart; col <= colEnd; col++) {
+    txWords[n++] = fb[col];
+    sent[col] = fb[col];
+  }
+  txWords[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  dma_channel_transfer_from_buffer_now(dmaChannel, txWords, n);
+  return true;
 }
 
 void DisplayManager::renderMenu(const Parameter& param) {
@@ -60,10 +157,6 @@ void DisplayManager::renderMenu(const Parameter& param) {
   display.drawBitmap(3, 0, image_ButtonUp_bits, 7, 4, 1);
 
   display.drawBitmap(3, 28, image_SmallArrowDown_bits, 7, 4, 1);
-
-
-  
-  display.display();
 }
 
 void DisplayManager::renderEdit(const Parameter& param) {
@@ -86,6 +179,47 @@ void DisplayManager::renderEdit(const Parameter& param) {
   
   display.setCursor(65, 3);
   display.print(param.value);
-  
-  display.display();
-}
\ No newline at end of file
+}
+
+void DisplayManager::renderScope(const float* samples, int n, const char* label) {
+  display.clearDisplay();
+  n = std::min(n, DISPLAY_W);
+
+  // Auto-scale to the peak so quiet signals stay readable
+  float peak = 0.05f;
+  for (int i = 0; i < n; i++) {
+    peak = std::max(peak, std::fabs(samples[i]));
+  }
+  const float mid = (DISPLAY_H - 1) * 0.5f;
+  const float scale = mid / peak;
+
+  int prevY = (int)(mid - samples[0] * scale);
+  for (int x = 1; x < n; x++) {
+    int y = (int)(mid - samples[x] * scale);
+    display.drawLine(x - 1, prevY, x, y, 1);
+    prevY = y;
+  }
+
+  display.setTextSize(1);
+  display.setCursor(0, 0);
+  display.print(label);
+}
+
+void DisplayManager::renderSpectrum(const uint16_t* mags, int bins, const char* label) {
+  display.clearDisplay();
+  bins = std::min(bins, DISPLAY_W / 2);
+
+  // 0 dB (full scale) .. -60 dB mapped onto the display height
+  for (int i = 0; i < bins; i++) {
+    float db = 20.0f * std::log10(std::max<float>(mags[i], 1.0f) / 32767.0f);
+    int h = (int)((db + 60.0f) * (DISPLAY_H / 60.0f));
+    h = std::max(0, std::min(h, DISPLAY_H));
+    if (h > 0) {
+      display.fillRect(i * 2, DISPLAY_H - h, 2, h, 1);
+    }
+  }
+
+  display.setTextSize(1);
+  display.setCursor(DISPLAY_W - 6 * (int)strlen(label), 0);
+  display.print(label);
+}
@@ -3,6 +3,8 @@
  * @brief OLED display management for pico-303 UI
  * 
  * Handles SSD1306 OLED display initialization and rendering of menu and edit screens.
+ * Rendering only touches the RAM framebuffer; service() streams the changed
+ * regions to the panel with DMA so I2C never blocks the audio loop.
  */
 
 #ifndef DISPLAYMANAGER_H
@@ -21,6 +23,11 @@
 #define DISPLAY_I2C_ADDR 0x3C
 #define DISPLAY_W 128
 #define DISPLAY_H 32
+#define DISPLAY_PAGES (DISPLAY_H / 8)
+
+// Largest run of framebuffer bytes pushed per DMA chunk.
+// Keeps each I2C burst short (~1.5ms at 400kHz) so updates interleave with audio.
+#define DISPLAY_CHUNK_BYTES 64
 
 class DisplayManager {
 public:
@@ -46,13 +53,54 @@ public:
    */
   void renderEdit(const Parameter& param);
   
+  /**
+   * @brief Render oscilloscope page (auto-scaled waveform)
+   * @param samples Samples to draw, one per column
+   * @param n Number of samples (at most DISPLAY_W)
+   * @param label Short caption drawn in the top-left corner
+   */
+  void renderScope(const float* samples, int n, const char* label);
+
+  /**
+   * @brief Render spectrum page (one bar per bin, log magnitude)
+   * @param mags Linear magnitudes, Q15 full scale
+   * @param bins Number of bins (at most DISPLAY_W / 2)
+   * @param label Short caption drawn in the top-right corner
+   */
+  void renderSpectrum(const uint16_t* mags, int bins, const char* label);
+  
   /**
    * @brief Clear the display
    */
   void clear();
 
+  /**
+   * @brief Pushes the next changed region of the framebuffer to the panel.
+   * Render functions only draw into RAM; this diffs the framebuffer against
+   * what the panel already shows and sends one dirty column run (at most
+   * DISPLAY_CHUNK_BYTES) via DMA-driven I2C. Never waits for the bus.
+   * Call once per loop() iteration.
+   * @return true if a transfer is in flight or more regions are pending
+   */
+  bool service();
+
+  /**
+   * @brief Forces a full resend of the framebuffer on the next service() calls.
+   */
+  void invalidate();
+
 private:
   Adafruit_SSD1306 display;
+
+  // Copy of what the panel currently shows (same page-major layout as the GFX buffer)
+  uint8_t shadow[DISPLAY_W * DISPLAY_PAGES];
+
+  // DMA source: two I2C transactions (address window + data) as DATA_CMD words
+  uint16_t txWords[8 + DISPLAY_CHUNK_BYTES + 1];
+  int dmaChannel = -1;
+  uint8_t nextPage = 0;
+
+  bool startChunk(uint8_t page, uint8_t colStart, uint8_t colEnd);
   
   // Arrow bitmaps (5x7 pixels)
   static const unsigned char image_ButtonLeft_bits[];
@@ -4,8 +4,9 @@
  */
 
 #include "Distortion.h"
+#include "HotPath.h"
 
-float Distortion::process(float input) {
+float DSP_HOT_FUNC(Distortion::process)(float input) {
   if (!enabled || amount <= 0.01f) return input;
 
   float drive = 1.0f + amount * 9.0f; // Map 0..1 to 1..10 drive
@@ -32,19 +33,19 @@ float Distortion::process(float input) {
   return (1.0f - mix) * input + mix * wetSignal;
 }
 
-float Distortion::processSoftClip(float x, float drive) {
+float DSP_HOT_FUNC(Distortion::processSoftClip)(float x, float drive) {
   float val = x * drive;
   // Fast sigmoid: x / (1 + |x|)
   // Much faster than std::tanh and sounds similar (slightly softer knee)
   return val / (1.0f + std::abs(val));
 }
 
-float Distortion::processHardClip(float x, float drive) {
+float DSP_HOT_FUNC(Distortion::processHardClip)(float x, float drive) {
   float val = x * drive;
   return std::fmax(-1.0f, std::fmin(1.0f, val));
 }
 
-float Distortion::processWavefolder(float x, float drive) {
+float DSP_HOT_FUNC(Distortion::processWavefolder)(float x, float drive) {
   float val = x * drive;
   if (val > 1.0f) val = 2.0f - val;
   else if (val < -1.0f) val = -2.0f - val;
@@ -53,7 +54,7 @@ float Distortion::processWavefolder(float x, float drive) {
   return std::fmax(-1.0f, std::fmin(1.0f, val));
 }
 
-float Distortion::processDiode(float x, float drive) {
+float DSP_HOT_FUNC(Distortion::processDiode)(float x, float drive) {
   // Asymmetric clipping simulation
   float val = x * drive;
   if (val >= 0) {
@@ -66,7 +67,7 @@ float Distortion::processDiode(float x, float drive) {
   }
 }
 
-float Distortion::processWaveNet(float x, float drive) {
+float DSP_HOT_FUNC(Distortion::processWaveNet)(float x, float drive) {
   // Polynomial approximation of a tube-like saturation curve
   // y = x - a*x^2 + b*x^3 ...
   // This creates even harmonics (asymmetry)
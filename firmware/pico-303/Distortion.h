@@ -58,11 +58,22 @@ public:
    */
   float process(float input);
 
+  /**
+   * @brief Visits the settings (engine snapshots).
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.value(type, SOFT_CLIP, WAVENET_TUBE);
+    ar.value(amount);
+    ar.value(mix);
+    ar.value(enabled, false, true);
+  }
+
 private:
-  Type type = SOFT_CLIP;
+  bool enabled = false;
   float amount = 0.0f;
+  Type type = SOFT_CLIP;
   float mix = 1.0f;
-  bool enabled = false;
 
   // Internal processing functions
   float processSoftClip(float x, float drive);
@@ -4,20 +4,30 @@
  */
 
 #include "Filter303.h"
+#include "HotPath.h"
+#include "CoefficientTables.h"
 #include <cmath>
 
 Filter303::Filter303(float sr)
-  : sampleRate(sr), cutoff(1000.0f), resonance(0.0f), envMod(0.0f),
-    y1(0), y2(0), y3(0), y4(0) {}
+  : envMod(0.0f), cutoff(1000.0f), sampleRate(sr),
+    y1(0), y2(0), y3(0), y4(0), resonance(0.0f) {}
+
+void Filter303::setSampleRate(float sr) {
+  if (sr == sampleRate) return;
+  sampleRate = sr;
+  dirty = true;
+}
 
 void Filter303::setCutoff(float freq) {
   cutoff = freq;
-  updateCoefficients();
 }
 
 void Filter303::setResonance(float res) {
   // Allow resonance > 1.0 for Devilfish self-oscillation
-  resonance = std::fmax(0.0f, res);
+  res = std::fmax(0.0f, res);
+  if (res == resonance) return;
+  resonance = res;
+  dirty = true;
 }
 
 void Filter303::setEnvMod(float amount) {
@@ -28,7 +38,7 @@ void Filter303::setFMAmount(float amount) {
   fmAmount = amount;
 }
 
-float Filter303::process(float input, float env, float accentEnv, float fmInput) {
+float DSP_HOT_FUNC(Filter303::process)(float input, float env, float accentEnv, float fmInput) {
   float modAmt = std::fmin(std::fmax(envMod * env, -0.95f * cutoff), 4.0f * cutoff);
   
   // Apply FM: modulate cutoff by audio signal
@@ -37,18 +47,19 @@ float Filter303::process(float input, float env, float accentEnv, float fmInput)
   }
 
   float modCutoff = cutoff + modAmt;
+  if (model == ZDF) return processZDF(input, modCutoff);
   modCutoff = std::fmin(std::fmax(modCutoff, 5.0f), 0.45f * sampleRate);
 
-  // JC303 / Open303 Logic - recalculate coefficients with modCutoff
-  float wc = 2.0f * M_PI * modCutoff / sampleRate;
-  float fx = wc * 0.70710678f / (2.0f * M_PI);
+  // JC303 / Open303 Logic - recalculate coefficients with modCutoff.
+  // fx = wc / sqrt(2) / (2 pi) with wc = 2 pi fc / fs; the 2 pi cancels,
+  // and staying in float avoids soft-float double calls on the device
+  float fx = modCutoff * (0.70710678f / sampleRate);
   
   float b0 = (0.00045522346f + 6.1922189f * fx) / (1.0f + 12.358354f * fx + 4.4156345f * (fx * fx));
   float k  = fx*(fx*(fx*(fx*(fx*(fx+7198.6997f)-5837.7917f)-476.47308f)+614.95611f)+213.87126f)+16.998792f;
   float g  = k * 0.058823529411764705882352941176471f; // 1/17
   
   // Apply resonance
-  float r_skew = (1.0f - std::exp(-3.0f * resonance)) / 0.9502129316f;
   g = (g - 1.0f) * r_skew + 1.0f;
   g = (g * (1.0f + r_skew));
   k = k * r_skew;
@@ -76,13 +87,75 @@ float Filter303::getEnvMod() const {
 
 void Filter303::updateCoefficients() {
   // Highpass coeff (fixed 150Hz)
-  float w_hp = 2.0f * M_PI * hp_cutoff;
   // Simple 1-pole coeff approximation: exp(-2pi * fc / fs)
-  hp_coeff = std::exp(-w_hp / sampleRate); 
+  hp_coeff = 1.0f - onePoleForCutoff(hp_cutoff, sampleRate);
+  r_skew = (1.0f - std::exp(-3.0f * resonance)) / 0.9502129316f;
+  // Open303's b0 is ~6.1922189 * fx at low cutoffs, which puts the
+  // resonance peak at 0.9855 * cutoff. The ZDF ladder is tuned to the same
+  // peak: G = tan(pi * 0.9855 * fc / fs) / sqrt(2).
+  zdf_w = 3.0961100f / sampleRate;
+  dirty = false;
 }
 
-float Filter303::processFeedbackHPF(float input) {
+float DSP_HOT_FUNC(Filter303::processFeedbackHPF)(float input) {
   // Simple 1-pole Highpass: y = x - lpf(x)
   hp_state += (1.0f - hp_coeff) * (input - hp_state);
   return input - hp_state;
-}
\ No newline at end of file
+}
+
+float DSP_HOT_FUNC(Filter303::processZDF)(float input, float modCutoff) {
+  // Stable at any cutoff; the limit only keeps the tan() argument below pi/2
+  modCutoff = std::fmin(std::fmax(modCutoff, 5.0f), 0.49f * sampleRate);
+
+  // Integrator gain from a [5/4] Pade approximant of tan (0.3% off at fs/2)
+  float w = zdf_w * modCutoff;
+  float w2 = w * w;
+  float G = w * (945.0f + w2 * (w2 - 105.0f)) / (945.0f + w2 * (15.0f * w2 - 420.0f)) * 0.70710678f;
+
+  // The four trapezoidal stages form a tridiagonal system in their outputs
+  // (diagonal a, coupling G, 2G into stage 1). t2..t4 and p3 are the
+  // determinants of its leading and trailing blocks; the c* are the
+  // cofactors they share, so the solve needs no elimination.
+  float G2 = G * G;
+  float a = 1.0f + 2.0f * G;
+  float t2 = a * a - 2.0f * G2;
+  float t3 = a * (t2 - G2);
+  float t4 = a * t3 - G2 * t2;
+  float p3 = t2 + G2;
+  float c1 = G2 * G;
+  float c2 = G2 * a;
+  float c3 = G * t2;
+  float c5 = G * a * a;
+  float c6 = a * t2;
+  float c7 = G * p3;
+  float c8 = a * p3;
+
+  // Feedback resolved within the sample: u = input - h * (k * v4 - hp_state)
+  // with v4 = (ns + g4 * u) / t4. The highpass is trapezoidal too, its pole
+  // matched to hp_coeff, so h = 1 / (1 + Ghp).
+  float k = 17.0f * r_skew;   // The analog ladder's gain for self-oscillation
+  float h = 0.5f + 0.5f * hp_coeff;
+  float hk = h * k;
+  float ns = c1 * y1 + c2 * y2 + c3 * y3 + t3 * y4;
+  float g4 = 2.0f * G2 * G2;
+  float den = t4 + hk * g4;
+  float inv = 1.0f / (t4 * den);   // One division gives 1/den and 1/t4
+  float u = ((input + h * hp_state) * t4 - hk * ns) * t4 * inv;
+  float invT4 = den * inv;
+
+  // Stage outputs
+  float r1 = y1 + 2.0f * G * u;
+  float v1 = (c6 * r1 + 2.0f * (c7 * y2 + c2 * y3 + c1 * y4)) * invT4;
+  float v2 = (c7 * r1 + c8 * y2 + c5 * y3 + c2 * y4) * invT4;
+  float v3 = (c2 * r1 + c5 * y2 + c6 * y3 + c3 * y4) * invT4;
+  float v4 = (ns + g4 * u) * invT4;
+
+  // Integrator states
+  y1 = 2.0f * v1 - y1;
+  y2 = 2.0f * v2 - y2;
+  y3 = 2.0f * v3 - y3;
+  y4 = 2.0f * v4 - y4;
+  hp_state += 2.0f * (1.0f - h) * (k * v4 - hp_state);
+
+  return 2.0f * (1.0f + r_skew) * v4;
+}
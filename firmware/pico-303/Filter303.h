@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 /**
  * @file Filter303.h
  * @brief 4-pole Diode Ladder Filter emulation (TB-303 style).
@@ -12,8 +14,30 @@
  */
 class Filter303 {
 public:
+  /**
+   * @brief Discretization of the ladder, selected per patch.
+   */
+  enum Model : uint8_t {
+    OPEN303,  ///< Open303's fitted explicit ladder, feedback delayed by one sample
+    ZDF       ///< Trapezoidal (zero-delay feedback) ladder, solved in closed form
+  };
+
   Filter303(float sampleRate = 44100.0f);
 
+  /**
+   * @brief Sets the sample rate. Takes effect at the next update().
+   * @param sr Sample rate in Hz
+   */
+  void setSampleRate(float sr);
+
+  /**
+   * @brief Selects the ladder model. Both keep their state in the same
+   * members, so switching mid-note does not reset the filter.
+   * @param m Model enum
+   */
+  void setModel(Model m) { model = m; }
+  Model getModel() const { return model; }
+
   /**
    * @brief Sets the base cutoff frequency.
    * @param freq Frequency in Hz
@@ -21,11 +45,17 @@ public:
   void setCutoff(float freq);
 
   /**
-   * @brief Sets the resonance amount.
+   * @brief Sets the resonance amount. Takes effect at the next update().
    * @param res Resonance [0.0 ... 1.0] (can go >1.0 for self-oscillation)
    */
   void setResonance(float res);
 
+  /**
+   * @brief Recomputes the resonance skew and the feedback highpass
+   * coefficient if the resonance changed (or on first use).
+   */
+  void update() { if (dirty) updateCoefficients(); }
+
   /**
    * @brief Sets the envelope modulation amount.
    * @param amount Modulation depth
@@ -57,26 +87,59 @@ public:
   float getCutoff() const;
   float getEnvMod() const;
 
+  /**
+   * @brief Visits ladder and feedback HPF state plus settings (engine snapshots).
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.value(model, OPEN303, ZDF);
+    ar.value(sampleRate);
+    ar.value(cutoff);
+    ar.value(resonance);
+    ar.value(envMod);
+    ar.value(accentMod);
+    ar.value(fmAmount);
+    ar.value(y1);
+    ar.value(y2);
+    ar.value(y3);
+    ar.value(y4);
+    ar.value(jc_b0);
+    ar.value(jc_k);
+    ar.value(jc_g);
+    ar.value(hp_state);
+    ar.value(hp_cutoff);
+    ar.value(hp_coeff);
+    ar.value(r_skew);
+    ar.value(zdf_w);
+  }
+
 private:
-  float sampleRate;
-  float cutoff;
-  float resonance;
+  friend struct LaneRenderer;  // Host SIMD renderer (firmware/host/batch/LaneRenderer.h)
+
+  // Everything process() reads, in the order it reads it
+  Model model = OPEN303;
   float envMod;
-  float accentMod = 0.0f;
+  float cutoff;
   float fmAmount = 0.0f;
+  float sampleRate;
+  float r_skew = 0.0f;   // Resonance shaping, from resonance
+  float zdf_w = 0.0f;    // ZDF: tan() argument per Hz of cutoff
+  // Feedback Highpass (1-pole)
+  float hp_coeff = 0.0f;
+  float hp_state = 0.0f;
+  float y1, y2, y3, y4;  // Stage outputs (ZDF: trapezoidal integrator states)
 
-  float y1, y2, y3, y4;
-
-  void updateCoefficients();
-
+  // Control rate only
+  float resonance;
+  bool dirty = true;
+  float accentMod = 0.0f;
+  float hp_cutoff = 150.0f;
   // JC303 / Open303 Specifics
   float jc_b0 = 0.0f;
   float jc_k = 0.0f;
   float jc_g = 0.0f;
-  // Feedback Highpass (1-pole)
-  float hp_state = 0.0f;
-  float hp_cutoff = 150.0f;
-  float hp_coeff = 0.0f;
-  
+
+  void updateCoefficients();
   float processFeedbackHPF(float input);
+  float processZDF(float input, float modCutoff);
 };
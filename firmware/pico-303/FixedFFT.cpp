@@ -0,0 +1,74 @@
+/**
+ * @file FixedFFT.cpp
+ * @brief Implementation of the FixedFFT class.
+ */
+
+#include "FixedFFT.h"
+#include <cmath>
+#include <algorithm>
+
+void FixedFFT::begin() {
+  for (int i = 0; i < kSize / 2; i++) {
+    float w = 2.0f * M_PI * i / kSize;
+    cosTable[i] = (int16_t)lrintf(std::cos(w) * 32767.0f);
+    sinTable[i] = (int16_t)lrintf(std::sin(w) * 32767.0f);
+  }
+  for (int i = 0; i < kSize; i++) {
+    window[i] = (int16_t)lrintf((0.5f - 0.5f * std::cos(2.0f * M_PI * i / (kSize - 1))) * 32767.0f);
+  }
+}
+
+void FixedFFT::magnitudes(const float* input, uint16_t* mags) {
+  for (int i = 0; i < kSize; i++) {
+    float x = std::fmax(-1.0f, std::fmin(1.0f, input[i]));
+    int32_t q = (int32_t)(x * 32767.0f);
+    re[i] = (int16_t)((q * window[i]) >> 15);
+    im[i] = 0;
+  }
+
+  transform();
+
+  for (int i = 0; i < kBins; i++) {
+    // Alpha-max-plus-beta-min approximation of sqrt(re^2 + im^2)
+    uint16_t a = (uint16_t)std::abs(re[i]);
+    uint16_t b = (uint16_t)std::abs(im[i]);
+    uint16_t hi = std::max(a, b);
+    uint16_t lo = std::min(a, b);
+    mags[i] = hi + (lo >> 1) - (hi >> 3);
+  }
+}
+
+void FixedFFT::transform() {
+  // Bit-reversal permutation
+  for (int i = 1, j = 0; i < kSize; i++) {
+    int bit = kSize >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      std::swap(re[i], re[j]);
+      std::swap(im[i], im[j]);
+    }
+  }
+
+  // Radix-2 butterflies, scaled by 1/2 per stage
+  for (int len = 2; len <= kSize; len <<= 1) {
+    int half = len >> 1;
+    int step = kSize / len;
+    for (int start = 0; start < kSize; start += len) {
+      for (int k = 0; k < half; k++) {
+        int32_t wr = cosTable[k * step];
+        int32_t wi = -sinTable[k * step];
+        int a = start + k;
+        int b = a + half;
+        int32_t tr = (re[b] * wr - im[b] * wi) >> 15;
+        int32_t ti = (re[b] * wi + im[b] * wr) >> 15;
+        int32_t ar = re[a];
+        int32_t ai = im[a];
+        re[a] = (int16_t)((ar + tr) >> 1);
+        im[a] = (int16_t)((ai + ti) >> 1);
+        re[b] = (int16_t)((ar - tr) >> 1);
+        im[b] = (int16_t)((ai - ti) >> 1);
+      }
+    }
+  }
+}
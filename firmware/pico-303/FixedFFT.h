@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @file FixedFFT.h
+ * @brief Small Q15 fixed-point FFT for the spectrum display.
+ */
+
+/**
+ * @class FixedFFT
+ * @brief 128-point radix-2 FFT on 16-bit integers.
+ * Each butterfly stage scales by 1/2, so the result never overflows.
+ * Intended for the UI, not for audio processing.
+ */
+class FixedFFT {
+public:
+  static const int kLog2Size = 7;
+  static const int kSize = 1 << kLog2Size;  ///< 128 points
+  static const int kBins = kSize / 2;       ///< 64 magnitude bins
+
+  /**
+   * @brief Builds the twiddle and Hann window tables.
+   * Call once before the first transform.
+   */
+  void begin();
+
+  /**
+   * @brief Computes windowed magnitudes of a real signal.
+   * @param input kSize samples, nominal range [-1.0, 1.0]
+   * @param mags Receives kBins magnitudes (linear, Q15-scaled)
+   */
+  void magnitudes(const float* input, uint16_t* mags);
+
+private:
+  int16_t cosTable[kSize / 2];
+  int16_t sinTable[kSize / 2];
+  int16_t window[kSize];
+
+  int16_t re[kSize];
+  int16_t im[kSize];
+
+  void transform();
+};
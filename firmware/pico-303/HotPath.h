@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file HotPath.h
+ * @brief Places the audio hot path in SRAM instead of XIP flash.
+ *
+ * On the RP2350 code normally runs from flash through the 16 KB XIP cache.
+ * A miss inside the render loop stalls for hundreds of cycles, and UI,
+ * display and USB code keep evicting the DSP lines between blocks. Functions
+ * defined with DSP_HOT_FUNC and tables declared DSP_TABLE go into
+ * .time_critical sections instead, which the boot code copies to SRAM (the
+ * pico-sdk's __not_in_flash_func() does the same).
+ *
+ * DSP_IN_RAM=0 (a compiler flag, since every DSP source reads it) keeps them
+ * in flash for comparison. Host builds ignore both.
+ * firmware/host/tools/check_placement.py checks the result in the ELF.
+ */
+
+#ifndef DSP_IN_RAM
+#define DSP_IN_RAM 1
+#endif
+
+#if defined(ARDUINO_ARCH_RP2040) && DSP_IN_RAM
+#define DSP_HOT_FUNC(name) __attribute__((section(".time_critical.dsp." #name))) name
+#define DSP_TABLE __attribute__((section(".time_critical.dsp_tables")))
+#else
+#define DSP_HOT_FUNC(name) name
+#define DSP_TABLE
+#endif
+
+/**
+ * @brief Forces a header-defined hot function into its caller, so it runs
+ * from wherever the caller was placed rather than as a separate flash copy.
+ */
+#define DSP_INLINE inline __attribute__((always_inline))
@@ -4,18 +4,22 @@
  */
 
 #include "LeakyIntegrator.h"
+#include "HotPath.h"
+#include "CoefficientTables.h"
 
 void LeakyIntegrator::setSampleRate(float sr) {
+  if (sr == sampleRate) return;
   sampleRate = sr;
-  calculateCoeff();
+  dirty = true;
 }
 
 void LeakyIntegrator::setTimeConstant(float tauMs) {
+  if (tauMs == tau) return;
   tau = tauMs;
-  calculateCoeff();
+  dirty = true;
 }
 
-float LeakyIntegrator::process(float in) {
+float DSP_HOT_FUNC(LeakyIntegrator::process)(float in) {
   y += c * (in - y);
   return y;
 }
@@ -32,6 +36,7 @@ void LeakyIntegrator::calculateCoeff() {
     // Rosic uses: c = 1 - exp( -1.0 / (0.001*tau*fs) ) for "coeff" in some contexts
     // But for LeakyIntegrator: y[n] = y[n-1] + c * (x[n] - y[n-1])
     // where c = 1 - exp(-1 / (tau_seconds * fs))
-    c = 1.0f - std::exp(-1.0f / (0.001f * tau * sampleRate));
+    c = onePoleForTime(tau, sampleRate);
   }
+  dirty = false;
 }
@@ -25,6 +25,12 @@ public:
    * @param tauMs Time constant in milliseconds
    */
   void setTimeConstant(float tauMs);
+
+  /**
+   * @brief Recomputes the coefficient after setSampleRate() or
+   * setTimeConstant() changed a value. Call before process().
+   */
+  void update() { if (dirty) calculateCoeff(); }
   
   /**
    * @brief Processes a sample through the integrator.
@@ -38,11 +44,26 @@ public:
    */
   void reset();
 
+  /**
+   * @brief Visits output and coefficient (engine snapshots).
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.value(sampleRate);
+    ar.value(tau);
+    ar.value(c);
+    ar.value(y);
+  }
+
 private:
+  friend struct LaneRenderer;  // Host SIMD renderer (firmware/host/batch/LaneRenderer.h)
+
+  float y = 0.0f;
+  float c = 0.1f;
+
   float sampleRate = 44100.0f;
   float tau = 15.0f; // ms
-  float c = 0.1f;
-  float y = 0.0f;
+  bool dirty = true;
   
   void calculateCoeff();
 };
@@ -4,6 +4,7 @@
  */
 
 #include "Oscillator.h"
+#include "HotPath.h"
 #include <cmath>
 #include <algorithm>
 
@@ -30,15 +31,22 @@ void Oscillator::setMode(bool jc303) {
   pulseWidth = jc303Mode ? 0.53f : 0.5f; 
 }
 
-void Oscillator::glideTo(float newFreq, float glideTimeMs) {
-  targetFreq = newFreq;
-  glideSamples = (glideTimeMs / 1000.0f) * sampleRate;
+void Oscillator::glideToNote(float note, float glideTimeMs) {
+  pendingNote = note;
+  pendingGlideMs = glideTimeMs;
+  glidePending = true;
+}
+
+void Oscillator::startGlide() {
+  glidePending = false;
+  targetFreq = 440.0f * std::pow(2.0f, (pendingNote - 69) / 12.0f);
+  glideSamples = (pendingGlideMs / 1000.0f) * sampleRate;
   if (glideSamples < 1) glideSamples = 1;
   glideStep = std::pow(targetFreq / frequency, 1.0f / glideSamples);  // exponential step
   glideCounter = (int)glideSamples;
 }
 
-void Oscillator::tick() {
+void DSP_HOT_FUNC(Oscillator::tick)() {
   if (glideCounter > 0) {
     frequency *= glideStep;
     phaseIncrement = frequency / sampleRate;
@@ -51,7 +59,7 @@ void Oscillator::setSubBlend(float b) {
   subBlend = std::max(0.0f, std::min(1.0f, b));
 }
 
-float Oscillator::polyBLEP(float t) {
+float DSP_HOT_FUNC(Oscillator::polyBLEP)(float t) {
   if (t < phaseIncrement) {
     t /= phaseIncrement;
     return t + t - t * t - 1.0f;
@@ -62,16 +70,16 @@ float Oscillator::polyBLEP(float t) {
   return 0.0f;
 }
 
-float Oscillator::process() {
+float DSP_HOT_FUNC(Oscillator::process)() {
   tick();
 
-  float shifted = fmod(phase + 0.5f, 1.0f);
+  float shifted = std::fmod(phase + 0.5f, 1.0f);
   float saw = 2.0f * shifted - 1.0f - polyBLEP(shifted);
   
   // Variable Pulse Width Square (PolyBLEP)
   float square = (phase < pulseWidth ? 1.0f : -1.0f);
   square += polyBLEP(phase); // Rising edge at 0
-  square -= polyBLEP(fmod(phase + 1.0f - pulseWidth, 1.0f)); // Falling edge at pulseWidth
+  square -= polyBLEP(std::fmod(phase + 1.0f - pulseWidth, 1.0f)); // Falling edge at pulseWidth
 
   float value = (1.0f - blend) * square + blend * saw;
 
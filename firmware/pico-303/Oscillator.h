@@ -48,11 +48,17 @@ public:
   void setSubBlend(float b);
 
   /**
-   * @brief Glides to a new frequency over a specified time.
-   * @param newFreq Target frequency in Hz
-   * @param glideTimeMs Glide duration in milliseconds
+   * @brief Glides to a note over a specified time. Only records the target;
+   * its frequency and the glide step are computed by update().
+   * @param note MIDI note number, fractional for pitch offsets (69 = A4)
+   * @param glideTimeMs Glide duration in milliseconds (0 = next sample)
    */
-  void glideTo(float newFreq, float glideTimeMs);
+  void glideToNote(float note, float glideTimeMs);
+
+  /**
+   * @brief Starts a glide requested since the last call.
+   */
+  void update() { if (glidePending) startGlide(); }
 
   /**
    * @brief Advances the oscillator state. Should be called once per sample.
@@ -84,21 +90,52 @@ public:
    */
   float polyBLEP(float t);
 
+  /**
+   * @brief Visits phase, glide and waveform settings (engine snapshots, host only).
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.value(sampleRate);
+    ar.value(frequency);
+    ar.value(phase);
+    ar.value(phaseIncrement);
+    ar.value(blend);
+    ar.value(targetFreq);
+    ar.value(glideSamples);
+    ar.value(glideStep);
+    ar.value(glideCounter);
+    ar.value(subBlend);
+    ar.value(subPhase);
+    ar.value(subPhaseIncrement);
+    ar.value(waveform, SAW, SQUARE);
+    ar.value(jc303Mode, false, true);
+    ar.value(pulseWidth);
+  }
+
 private:
-  float sampleRate = 44100.0f;
+  friend struct LaneRenderer;  // Host SIMD renderer (firmware/host/batch/LaneRenderer.h)
+
+  // Read by tick()/process() on every sample, in that order
+  int glideCounter = 0;
   float frequency = 440.0f;
+  float glideStep = 0;
+  float sampleRate = 44100.0f;
   float phase = 0.0f;
   float phaseIncrement = 0.01f;
+  float pulseWidth = 0.5f; // 0.5 = square, 0.53 = 303-ish
   float blend = 0.0f;
-  float targetFreq = 440.0f;
-  float glideSamples = 0;
-  float glideStep = 0;
-  int glideCounter = 0;
-  float subBlend = 0.0f;
   float subPhase = 0.0f;
   float subPhaseIncrement = 0.005f;
+  float subBlend = 0.0f;
+
+  // Only touched when a note or controller changes
+  float targetFreq = 440.0f;
+  float glideSamples = 0;
   Waveform waveform = SAW;
-  
   bool jc303Mode = true;
-  float pulseWidth = 0.5f; // 0.5 = square, 0.53 = 303-ish
+  bool glidePending = false;
+  float pendingNote = 69.0f;
+  float pendingGlideMs = 0.0f;
+
+  void startGlide();
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+/**
+ * @file ParameterMap.cpp
+ * @brief CC map table.
+ */
+
+#include "ParameterMap.h"
+
+const Parameter kParameterMap[kParameterCount] = {
+  {"Volume",       7,   76,  0, 127},  // CC7 - default ~60% volume
+  {"Wave ",  18,   0,   0, 127},  // CC18
+  {"Pitch",   16,   64,  0, 127},  // CC16 - 64 = center (0 semitones)
+  {"Cutoff",      74,   64,  0, 127},  // CC74
+  {"Res",   71,   0,   0, 127},  // CC71
+  {"Env",     17,   64,  0, 127},  // CC17
+  {"Decay",       75,   64,  0, 127},  // CC75
+  {"Accent",  15,   64,  0, 127},  // CC15
+  {"SubOsc",   14,   0,   0, 127},  // CC14
+  {"Dist On",     80,   0,   0, 127},  // CC80 - >63 = on
+  {"Dist Mode",   77,   0,   0, 4},    // CC77 - 5 modes (0-4)
+  {"Dist Amt",    78,   0,   0, 127},  // CC78
+  {"Dist Mix",    79,   0,   0, 127},  // CC79
+  {"Dly Time",  81,   32,  0, 127},  // CC81
+  {"Dly Fdbk",    82,   64,  0, 127},  // CC82
+  {"Dly Sync",    86,   32,  0, 127},  // CC86
+  {"Dly L Div",   91,   32,  0, 127},  // CC91
+  {"Dly R Div",   92,   32,  0, 127},  // CC92
+  {"Dly L Mod",   93,   0,   0, 2},    // CC93 - 3 modes (0-2)
+  {"Dly R Mod",   94,   0,   0, 2},    // CC94 - 3 modes (0-2)
+  {"Dly Mix",     83,   38,  0, 127},  // CC83
+  {"Glide",      100,   64,  0, 127},  // CC100
+  {"Filter",      76,   0,   0, 1}     // CC76 - 0 = Open303, 1 = ZDF
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @file ParameterMap.h
+ * @brief The synth's CC map: every parameter the encoder menu edits, in menu order.
+ *
+ * Shared by the UI and the host plugin, so a patch made in a DAW uses the
+ * same controllers and ranges as the hardware.
+ */
+
+// Parameter structure
+struct Parameter {
+  const char* name;
+  uint8_t cc;
+  uint8_t value;    ///< Value shown at power-on
+  uint8_t minVal;
+  uint8_t maxVal;
+};
+
+const uint8_t kParameterCount = 23;
+
+extern const Parameter kParameterMap[kParameterCount];
@@ -0,0 +1,295 @@
+/**
+ * @file Pico303Engine.cpp
+ * @brief Implementation of the Pico303Engine class.
+ */
+
+#include "Pico303Engine.h"
+#include "DeferredLog.h"
+#include <algorithm>
+#include <math.h>
+#include <new>
+
+// Engine messages go to the deferred log when one is attached (see setLog)
+#define ENGINE_LOG(category, ...) do { if (log) log->write(category, __VA_ARGS__); } while (0)
+
+bool Pico303Engine::begin(int rate) {
+  const size_t bytes = arenaBytes() + ARENA_ALIGN;  // Slack to align heap storage
+  ownedStorage.reset(new (std::nothrow) uint8_t[bytes]);
+  if (!ownedStorage) return false;
+  ownedArena.reset(new Arena(ownedStorage.get(), bytes, "engine"));
+  return begin(rate, *ownedArena);
+}
+
+bool Pico303Engine::begin(int rate, Arena& arena) {
+  sampleRate = rate;
+  coefficientsDirty = true;
+
+  // Osc
+  osc.setSampleRate(sampleRate);
+  osc.setWaveform(Oscillator::SQUARE);
+  osc.setMode(true); // Enable JC303 mode (Square = Pulse 53%)
+  envAmp.setSampleRate(sampleRate);
+  envFilt.setSampleRate(sampleRate);
+  envAmp.setDecay(300.0f);    // 300ms
+  envAmp.setRelease(10.0f);   // 10ms
+  envFilt.setDecayTime(1000.0f); // 1000ms
+
+  filter.setSampleRate(sampleRate);
+  filter.setCutoff(1000.0f);
+  filter.setResonance(0.0f);
+  filter.setEnvMod(500.0f);      // how much the envelope modulates cutoff
+
+  stereoDelay.setSampleRate(sampleRate);
+  bool allocated = stereoDelay.begin(arena);
+  stereoDelay.setTimeSamplesL(sampleRate / 4);   // 250ms
+  stereoDelay.setTimeSamplesR(sampleRate / 4);
+
+  // Let's use 2.0ms to be safe and smooth.
+  ampDeClicker.setSampleRate(sampleRate);
+  ampDeClicker.setTimeConstant(2.0f);
+
+  // Post-filter HPF to remove DC offset (crucial for distortion)
+  hpfPostFilter.setSampleRate(sampleRate);
+  hpfPostFilter.setCutoff(30.0f); // ~25-30Hz like Open303
+  return allocated;
+}
+
+void Pico303Engine::apply(const SynthEvent& ev) {
+  switch (ev.type) {
+    case SynthEvent::NOTE_ON:
+      noteOn(ev.channel, ev.data1, ev.data2);
+      break;
+    case SynthEvent::NOTE_OFF:
+      noteOff(ev.channel, ev.data1, ev.data2);
+      break;
+    case SynthEvent::CONTROL_CHANGE:
+      controlChange(ev.channel, ev.data1, ev.data2);
+      break;
+    case SynthEvent::TEMPO:
+      bpm = ev.value;
+      break;
+  }
+}
+
+void Pico303Engine::noteOn(uint8_t channel, uint8_t pitch, uint8_t velocity) {
+  bool slide = (prevNote != 0xFF);
+  bool accent = (velocity >= 100);
+  coefficientsDirty = true;
+
+  // Modified‑Naive overlap counter
+  if (prevNote == pitch) noteOverlap++;
+  prevNote = pitch;
+
+  osc.glideToNote(pitch + pitchOffset, slide ? glideTimeMs : 0.0f);  // use configurable glide time
+
+  // Accent and envelope logic
+  if (!slide || accent) {
+    if (!slide) {
+      osc.resetPhase();
+    }
+    envAmp.setRelease(accent ? 50.0f : 10.0f);
+    envAmp.noteOn();
+    
+    // Use user-set decay time for normal notes, fixed 200ms for accent (TB-303 behavior)
+    envFilt.setDecayTime(accent ? 200.0f : userDecayTime);
+    envFilt.trigger();
+    
+    // Calculate accent gain for this note
+    currentAccentGain = accent ? accentLevel : 0.0f;
+    
+    // Filter modulation
+    // Base mod + Accent mod
+    // If accentLevel is 1.0, we want max boost (e.g. 2.5x total or similar)
+    // Old logic: accentBoost 1.0..2.5
+    // New logic: 1.0 + accentLevel * 1.5
+    float boost = 1.0f + currentAccentGain * 1.5f;
+    float modAmt = globalEnvMod * boost;
+    
+    modAmt = std::min(modAmt, 3000.0f);  // cap to prevent filter overload
+    filter.setEnvMod(modAmt);
+  }
+
+  lastNoteWasAccented = accent;
+
+  ENGINE_LOG(LOG_NOTE, "NoteON ch%u pitch%u vel%u slide=%d accent=%d\n",
+                channel, pitch, velocity, slide, accent);
+}
+
+void Pico303Engine::noteOff(uint8_t channel, uint8_t pitch, uint8_t velocity) {
+  // Modified‑Naive: decrement overlap before noteOff
+  if (prevNote == pitch) {
+    if (noteOverlap > 0) {
+      noteOverlap--;
+      return;
+    }
+    // If no overlap left, stop tone
+    prevNote = 0xFF;
+    envAmp.noteOff();
+
+    ENGINE_LOG(LOG_NOTE, "NoteOFF ch%u pitch%u vel%u\n",
+                  channel, pitch, velocity);
+  }
+}
+
+void Pico303Engine::controlChange(uint8_t /*channel*/, uint8_t cc, uint8_t value) {
+  coefficientsDirty = true;
+  if (cc == 7) {  // Volume
+    // Rescale volume: Max (127) = 0.6 (safe level)
+    volume = (value / 127.0f) * 0.6f;
+    ENGINE_LOG(LOG_CC, "CC7 Volume: %.2f\n", volume);
+  }
+  else if (cc == 14) {  // Sub oscillator blend
+    float subAmt = value / 127.0f;
+    osc.setSubBlend(subAmt);
+    ENGINE_LOG(LOG_CC, "CC14 Sub Blend: %.2f\n", subAmt);
+  }
+  else if (cc == 15) {  // Accent intensity
+    accentLevel = value / 127.0f; // 0.0 to 1.0
+    ENGINE_LOG(LOG_CC, "CC15 Accent Level: %.2f\n", accentLevel);
+  }
+  else if (cc == 16) {  // Pitch offset
+    pitchOffset = (value - 64) / 64.0f * 12.0f; // ±12 semitones
+    ENGINE_LOG(LOG_CC, "CC16 Pitch Offset: %.2f semitones\n", pitchOffset);
+  }
+  else if (cc == 17) {  // Mod envelope amount
+    globalEnvMod = (value / 127.0f) * 3000.0f;  // reduced to avoid filter instability
+    ENGINE_LOG(LOG_CC, "CC17 Env Mod: %.1f\n", globalEnvMod);
+  }
+  else if (cc == 18) {  // Waveform blend
+    float blendVal = value / 127.0f;
+    osc.setBlend(blendVal);
+    ENGINE_LOG(LOG_CC, "CC18 Waveform Blend: %.2f\n", blendVal);
+  }
+  else if (cc == 71) {  // Resonance
+    float res = value / 127.0f;
+    float shaped = powf(res, 0.8f);  // slightly aggressive but safe shaping
+    filter.setResonance(std::min(shaped, 1.0f));  // ensure cap
+    ENGINE_LOG(LOG_CC, "CC71 Resonance: %.2f (shaped: %.2f)\n", res, shaped);
+  }
+  else if (cc == 74) {  // Filter Cutoff
+    // Exponential mapping: 300Hz to 3000Hz
+    // freq = min * (max/min)^(val/127)
+    float freq = 300.0f * pow(3000.0f / 300.0f, value / 127.0f);
+    filter.setCutoff(freq);
+    ENGINE_LOG(LOG_CC, "CC74 Cutoff: %.1f Hz\n", freq);
+  }
+  else if (cc == 75) {  // Envelope decay time
+    userDecayTime = 50.0f + (value / 127.0f) * 1950.0f; // 50ms to 2000ms
+    envFilt.setDecayTime(userDecayTime); // From the next block on
+    ENGINE_LOG(LOG_CC, "CC75 Decay Time: %.2f ms\n", userDecayTime);
+  }
+  else if (cc == 76) {  // Filter model
+    filter.setModel(static_cast<Filter303::Model>(value % 2));
+    ENGINE_LOG(LOG_CC, "CC76 Filter Model: %d\n", value % 2);
+  }
+  else if (cc == 77) {  // Distortion mode
+    distFx.setType(static_cast<Distortion::Type>(value % 5));
+    ENGINE_LOG(LOG_CC, "CC77 Dist Mode: %d\n", value % 5);
+  }
+  else if (cc == 78) {  // Distortion amount
+    float amt = value / 127.0f;
+    distFx.setAmount(amt);
+    ENGINE_LOG(LOG_CC, "CC78 Dist Amount: %.2f\n", amt);
+  }
+  else if (cc == 79) {  // Distortion Mix
+    float mix = value / 127.0f;
+    distFx.setMix(mix);
+    ENGINE_LOG(LOG_CC, "CC79 Dist Mix: %.2f\n", mix);
+  }
+  else if (cc == 80) {  // Distortion On/Off
+    bool on = value > 63;
+    distFx.setEnabled(on);
+    ENGINE_LOG(LOG_CC, "CC80 Dist Enable: %d\n", on);
+  }
+  else if (cc == 81) {  // Delay Time
+    delayTimeSamplesL = 2000 + value * (44100 - 2000) / 127;  // 2ms to 1s
+    delayTimeSamplesR = delayTimeSamplesL;
+    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
+    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
+    ENGINE_LOG(LOG_CC, "CC81 Delay Time: %d samples\n", delayTimeSamplesL);
+  }
+  else if (cc == 82) {  // Delay Feedback
+    delayFeedback = value / 127.0f;
+    stereoDelay.setFeedback(delayFeedback);
+    ENGINE_LOG(LOG_CC, "CC82 Feedback: %.2f\n", delayFeedback);
+  }
+  else if (cc == 83) {  // Delay Mix
+    delayMix = value / 127.0f;
+    stereoDelay.setMix(delayMix);
+    ENGINE_LOG(LOG_CC, "CC83 Mix: %.2f\n", delayMix);
+  }
+  else if (cc == 86) {
+    int div = std::max(1, value / 16);  // Map 0–127 to divs
+    float beats = pow(2, div - 1) / 4.0f;  // 1/16, 1/8, 1/4, etc.
+    delayTimeSamplesL = beatsToSamples(beats);
+    delayTimeSamplesR = delayTimeSamplesL;
+    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
+    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
+    ENGINE_LOG(LOG_CC, "CC86 Delay Sync Division: 1/%d beat, %d samples (BPM %.1f)\n", (int)(1.0f / beats), delayTimeSamplesL, bpm);
+  }
+  else if (cc == 91) {
+    int div = std::max(1, value / 16);
+    float beats = pow(2, div - 1) / 4.0f;
+    if (delayModL == 1) beats *= 1.5f;       // Dotted
+    else if (delayModL == 2) beats *= 2.0f / 3.0f; // Triplet
+    int samples = beatsToSamples(beats);
+    samples = std::clamp(samples, 1, maxDelaySamples - 1);
+    delayTimeSamplesL = samples;
+    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
+    ENGINE_LOG(LOG_CC, "CC91 Delay L Div: 1/%d beat, %d samples\n", (int)(1.0f / beats), delayTimeSamplesL);
+  }
+  else if (cc == 92) {
+    int div = std::max(1, value / 16);
+    float beats = pow(2, div - 1) / 4.0f;
+    if (delayModR == 1) beats *= 1.5f;
+    else if (delayModR == 2) beats *= 2.0f / 3.0f;
+    int samples = beatsToSamples(beats);
+    samples = std::clamp(samples, 1, maxDelaySamples - 1);
+    delayTimeSamplesR = samples;
+    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
+    ENGINE_LOG(LOG_CC, "CC92 Delay R Div: 1/%d beat, %d samples\n", (int)(1.0f / beats), delayTimeSamplesR);
+  }
+  else if (cc == 93) {  // Delay L Modifier
+    delayModL = value % 3;
+    int div = std::max<float>(1, delayTimeSamplesL > 0 ? log2f((delayTimeSamplesL * 4.0f / sampleRate) / (60.0f / bpm)) + 1 : 2);
+    float beats = pow(2, div - 1) / 4.0f;
+    if (delayModL == 1) beats *= 1.5f;
+    else if (delayModL == 2) beats *= 2.0f / 3.0f;
+    int samples = beatsToSamples(beats);
+    samples = std::clamp(samples, 1, maxDelaySamples - 1);
+    delayTimeSamplesL = samples;
+    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
+    ENGINE_LOG(LOG_CC, "CC93 Delay L Mod: %d -> %d samples\n", delayModL, delayTimeSamplesL);
+  }
+  else if (cc == 94) {  // Delay R Modifier
+    delayModR = value % 3;
+    int div = std::max<float>(1, delayTimeSamplesR > 0 ? log2f((delayTimeSamplesR * 4.0f / sampleRate) / (60.0f / bpm)) + 1 : 2);
+    float beats = pow(2, div - 1) / 4.0f;
+    if (delayModR == 1) beats *= 1.5f;
+    else if (delayModR == 2) beats *= 2.0f / 3.0f;
+    int samples = beatsToSamples(beats);
+    samples = std::clamp(samples, 1, maxDelaySamples - 1);
+    delayTimeSamplesR = samples;
+    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
+    ENGINE_LOG(LOG_CC, "CC94 Delay R Mod: %d -> %d samples\n", delayModR, delayTimeSamplesR);
+  }
+  else if (cc == 100) {  // Glide Time
+    glideTimeMs = (value == 64) ? 80.0f : (value / 127.0f) * 500.0f;
+    ENGINE_LOG(LOG_CC, "CC100 Glide Time: %.1f ms\n", glideTimeMs);
+  }
+}
+
+void Pico303Engine::recomputeCoefficients() {
+  osc.update();
+  envAmp.update();
+  envFilt.update();
+  filter.update();
+  hpfPostFilter.update();
+  ampDeClicker.update();
+  coefficientsDirty = false;
+}
+
+int Pico303Engine::beatsToSamples(float beats) const {
+  float seconds = (60.0f / bpm) * beats;
+  return (int)(seconds * sampleRate);
+}
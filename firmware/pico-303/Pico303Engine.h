@@ -0,0 +1,382 @@
+#pragma once
+#include <stdint.h>
+#include <cmath>
+#include <memory>
+
+#include "Oscillator.h"
+#include "Filter303.h"
+#include "StereoDelay.h"
+#include "DecayEnvelope.h"
+#include "AnalogEnvelope.h"
+#include "LeakyIntegrator.h"
+#include "Distortion.h"
+#include "DCBlocker.h"
+#include "SynthEvent.h"
+#include "AudioTap.h"
+#include "StageProfiler.h"
+#include "Chain.h"
+#include "Arena.h"
+#include "HotPath.h"
+
+class DeferredLog;
+
+/**
+ * @file Pico303Engine.h
+ * @brief One complete pico-303 voice: oscillator, filter, envelopes, effects
+ * and the note/controller logic that drives them.
+ */
+
+/**
+ * @class Pico303Engine
+ * @brief Self-contained synth engine. The firmware owns one instance; host
+ * tools may create as many as they like, each instance touches only its own
+ * members.
+ */
+class Pico303Engine {
+public:
+  /**
+   * @brief Revision of the rendered sound. Bump whenever a change alters the
+   * output for the same input, so host render caches drop stale audio.
+   */
+  static const uint32_t renderVersion = 3;
+
+  /**
+   * @brief Arena space begin() takes for the engine's buffers.
+   */
+  static constexpr size_t arenaBytes() { return StereoDelay::arenaBytes(maxDelaySamples); }
+
+  /**
+   * @brief Sets the sample rate, takes the delay lines from the arena and
+   * loads the power-on patch. Must be called in setup(), not at global scope.
+   * @param sampleRate Output sample rate in Hz
+   * @param arena Source of every buffer the engine uses (arenaBytes() of room)
+   * @return false if the arena was too small
+   */
+  bool begin(int sampleRate, Arena& arena);
+
+  /**
+   * @brief Host tools: begin() with an arena of the engine's own, on the heap.
+   */
+  bool begin(int sampleRate);
+
+  /**
+   * @brief Applies a note, controller or tempo event.
+   */
+  void apply(const SynthEvent& ev);
+
+  /**
+   * @brief Handles MIDI Note On: frequency, slide, accent and envelope triggering.
+   */
+  void noteOn(uint8_t channel, uint8_t pitch, uint8_t velocity);
+
+  /**
+   * @brief Handles MIDI Note Off, honouring overlapping (legato) notes.
+   */
+  void noteOff(uint8_t channel, uint8_t pitch, uint8_t velocity);
+
+  /**
+   * @brief Updates synth parameters from a MIDI Control Change.
+   */
+  void controlChange(uint8_t channel, uint8_t cc, uint8_t value);
+
+  /**
+   * @brief Sets the tempo used by the tempo-synced delay controls.
+   */
+  void setTempo(float newBpm) { bpm = newBpm; }
+  float getTempo() const { return bpm; }
+
+  /**
+   * @brief Routes the engine's event messages to a deferred log (nullptr = off).
+   */
+  void setLog(DeferredLog* eventLog) { log = eventLog; }
+
+  /**
+   * @brief Brings the DSP coefficients up to date with the notes and
+   * controllers applied since the last call. Event handling only records
+   * new values, so it never evaluates exp() or pow(); render() starts each
+   * block with this. Host code that reads module state directly calls it too.
+   */
+  void updateCoefficients() {
+    if (coefficientsDirty) recomputeCoefficients();
+  }
+
+  /**
+   * @brief Size of the block of members the render loop reads per sample.
+   */
+  size_t hotStateBytes() const {
+    return (size_t)((const char*)(&stereoDelay + 1) - (const char*)&envAmp);
+  }
+
+  /**
+   * @brief Signals passed from stage to stage within one sample.
+   */
+  struct Signals {
+    float envAmp;
+    float envFilt;
+    float mono;     ///< Voice signal, oscillator through distortion
+    float vca;      ///< Post-VCA signal (audio tap)
+    float left;
+    float right;
+  };
+
+  // Stages of the voice and effects, in processing order (defined below the class)
+  struct EnvelopeStage;
+  struct OscillatorStage;
+  struct FilterStage;
+  struct DCBlockerStage;
+  struct VcaStage;
+  struct DistortionStage;
+  struct LevelStage;
+  struct DelayStage;
+  struct OutputStage;
+
+  /// The complete instrument, as shipped
+  using FullChain = Chain<EnvelopeStage, OscillatorStage, FilterStage, DCBlockerStage, VcaStage,
+                          DistortionStage, LevelStage, DelayStage, OutputStage>;
+  /// Voice only: distortion and delay compiled out (their controls still update state)
+  using DryChain = Chain<EnvelopeStage, OscillatorStage, FilterStage, DCBlockerStage, VcaStage,
+                         LevelStage, OutputStage>;
+
+  /**
+   * @brief Renders interleaved stereo 16-bit frames.
+   * @tparam StageChain Stages run on every sample (FullChain unless the build picks another)
+   * @param out Destination, frames * 2 samples
+   * @param frames Number of stereo frames
+   * @param tap Audio tap fed with the post-VCA and output signals, or nullptr
+   * @param probe StageProfiler, or NullProfiler to compile the marks out
+   */
+  template <class StageChain = FullChain, typename Probe>
+  DSP_INLINE void render(int16_t* out, int frames, AudioTap* tap, Probe& probe) {
+    static_assert(StageChain::template endsWith<OutputStage>(), "A chain must end in OutputStage");
+    updateCoefficients();
+    probe.beginBlock();
+
+    for (int i = 0; i < frames; i++) {
+      Signals s;
+      StageChain::process(*this, s, probe);
+
+      // Store in interleaved stereo buffer
+      out[i * 2] = (int16_t)s.left;
+      out[i * 2 + 1] = (int16_t)s.right;
+
+      if (tap) {
+        tap->write(s.vca, s.left * (1.0f / 32768.0f));
+      }
+      probe.mark(STAGE_OUTPUT);
+    }
+
+    if (tap) {
+      tap->publish();
+    }
+    probe.endBlock();
+  }
+
+  /**
+   * @brief Renders without tap or profiling.
+   */
+  void render(int16_t* out, int frames) {
+    NullProfiler probe;
+    render(out, frames, nullptr, probe);
+  }
+
+  /**
+   * @brief Visits the complete engine state: every DSP stage, voice and
+   * controller state. Used by the host to checkpoint and resume renders
+   * (firmware/host/batch/EngineSnapshot.h); the log target is not part of it.
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    updateCoefficients();  // A snapshot holds no pending changes
+    osc.serialize(ar);
+    filter.serialize(ar);
+    distFx.serialize(ar);
+    hpfPostFilter.serialize(ar);
+    envFilt.serialize(ar);
+    envAmp.serialize(ar);
+    ampDeClicker.serialize(ar);
+    stereoDelay.serialize(ar);
+    ar.value(sampleRate);
+    ar.value(accentLevel);
+    ar.value(currentAccentGain);
+    ar.value(bpm);
+    ar.value(prevNote);
+    ar.value(noteOverlap);
+    ar.value(volume);
+    ar.value(lastNoteWasAccented, false, true);
+    ar.value(pitchOffset);
+    ar.value(globalEnvMod);
+    ar.value(glideTimeMs);
+    ar.value(userDecayTime);
+    ar.value(delayTimeSamplesL);
+    ar.value(delayTimeSamplesR);
+    ar.value(delayFeedback);
+    ar.value(delayMix);
+    ar.value(delayModL);
+    ar.value(delayModR);
+  }
+
+private:
+  friend struct LaneRenderer;  // Host SIMD renderer (firmware/host/batch/LaneRenderer.h)
+
+  /**
+   * @brief Converts musical beats to sample count based on the current tempo.
+   */
+  int beatsToSamples(float beats) const;
+
+  /**
+   * @brief Lets each module recompute what its setters changed.
+   */
+  void recomputeCoefficients();
+
+  // ---- Hot voice state ----
+  // Everything the render stages read per sample, in stage order, starting
+  // on a cache line. Each module keeps its per-sample fields in front and
+  // its settings behind them, so the loop touches one contiguous block;
+  // the settings of each module still sit between it and the next one.
+  alignas(64) AnalogEnvelope envAmp;      // Amp Envelope
+  DecayEnvelope envFilt;      // Filter Envelope
+  Oscillator osc;
+  Filter303 filter;
+  bool lastNoteWasAccented = false;
+  DCBlocker hpfPostFilter;
+  float currentAccentGain = 0.0f; // Actual gain applied to current note
+  LeakyIntegrator ampDeClicker;   // Smoothes VCA signal to prevent clicks
+  Distortion distFx;
+  float volume = 0.6f;
+  StereoDelay stereoDelay;
+
+  // ---- Control rate: notes, controllers, tempo ----
+  bool coefficientsDirty = true;  // Settings changed since updateCoefficients()
+  int sampleRate = 44100;
+  DeferredLog* log = nullptr;
+
+  float accentLevel = 0.5f;       // 0.0 to 1.0 (controlled by CC15)
+  float bpm = 120.0f;
+
+  // MIDI state (Modified‑Naive)
+  uint8_t prevNote = 0xFF;
+  uint8_t noteOverlap = 0;
+
+  // Synth state
+  float pitchOffset = 0.0f;         // in semitones
+  float globalEnvMod = 2000.0f;
+  float glideTimeMs = 80.0f;        // default TB-303 glide time
+  float userDecayTime = 1000.0f;    // decay time setting
+
+  // Delay
+  static const int maxDelaySamples = 44100;  // 1 second delay max
+  int delayTimeSamplesL = 22050;
+  int delayTimeSamplesR = 22050;
+  float delayFeedback = 0.5f;
+  float delayMix = 0.3f;
+
+  // Delay modifiers: 0 = Full, 1 = Dotted, 2 = Triplet
+  int delayModL = 0;
+  int delayModR = 0;
+
+  // Backing store for begin(int) only; the firmware passes a static arena
+  std::unique_ptr<uint8_t[]> ownedStorage;
+  std::unique_ptr<Arena> ownedArena;
+};
+
+// ---- Render stages ----
+// Each stage reads and writes the current sample's Signals and marks its
+// profiler stage. Stages without a mark are cheap enough to be counted
+// with the next stage.
+
+struct Pico303Engine::EnvelopeStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe& probe) {
+    s.envAmp = e.envAmp.process();
+    s.envFilt = e.envFilt.process();
+    probe.mark(STAGE_ENVELOPES);
+  }
+};
+
+struct Pico303Engine::OscillatorStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe& probe) {
+    s.mono = e.osc.process();
+    probe.mark(STAGE_OSCILLATOR);
+  }
+};
+
+struct Pico303Engine::FilterStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe& probe) {
+    s.mono = e.filter.process(s.mono, s.envFilt, e.lastNoteWasAccented ? 1.0f : 0.0f);
+    probe.mark(STAGE_FILTER);
+  }
+};
+
+/**
+ * @brief Removes the DC offset of the resonant filter *before* VCA/Distortion.
+ */
+struct Pico303Engine::DCBlockerStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe& probe) {
+    s.mono = e.hpfPostFilter.processHPF(s.mono);
+    probe.mark(STAGE_DC_BLOCKER);
+  }
+};
+
+/**
+ * @brief VCA mixing (Open303 style), smoothed to remove clicks. Applied
+ * *before* distortion.
+ */
+struct Pico303Engine::VcaStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe& probe) {
+    float vcaMod = s.envAmp;
+    if (e.envAmp.isActive()) {
+        vcaMod += 0.45f * s.envFilt;
+        vcaMod += e.currentAccentGain * 3.0f * s.envFilt;
+    }
+    vcaMod = e.ampDeClicker.process(vcaMod);
+    s.vca = s.mono * vcaMod;
+    s.mono = s.vca;
+    probe.mark(STAGE_VCA);
+  }
+};
+
+struct Pico303Engine::DistortionStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe& probe) {
+    s.mono = e.distFx.process(s.mono);
+    probe.mark(STAGE_DISTORTION);
+  }
+};
+
+/**
+ * @brief Master volume, and the split into the two output channels.
+ */
+struct Pico303Engine::LevelStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe&) {
+    s.left = s.mono * e.volume;
+    s.right = s.left;
+  }
+};
+
+struct Pico303Engine::DelayStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine& e, Signals& s, Probe& probe) {
+    float dryL = s.left;
+    float dryR = s.right;
+    s.left = e.stereoDelay.processL(dryL);
+    s.right = e.stereoDelay.processR(dryR);
+    e.stereoDelay.tick(dryL, dryR);
+    probe.mark(STAGE_DELAY);
+  }
+};
+
+/**
+ * @brief Soft clipper into the int16 range; render() stores the result.
+ */
+struct Pico303Engine::OutputStage {
+  template <typename Probe>
+  static DSP_INLINE void process(Pico303Engine&, Signals& s, Probe&) {
+    s.left = std::tanh(s.left * 0.10f) * 30000.0f;
+    s.right = std::tanh(s.right * 0.10f) * 30000.0f;
+  }
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @file RenderStats.h
+ * @brief Running statistics of audio block render times.
+ */
+
+/**
+ * @class RenderStats
+ * @brief Accumulates min/max/mean/variance of block render times (Welford).
+ * Updated on the audio side once per block; summaries are handed to the
+ * housekeeping side through a queue so nothing here needs to be shared.
+ */
+class RenderStats {
+public:
+  /**
+   * @brief Snapshot of the statistics since the last reset.
+   */
+  struct Summary {
+    uint32_t blocks;
+    float minUs;
+    float maxUs;
+    float meanUs;
+    float stddevUs;
+  };
+
+  /**
+   * @brief Adds one block render time.
+   * @param us Render time in microseconds
+   */
+  void add(uint32_t us) {
+    count++;
+    minUs = std::min(minUs, us);
+    maxUs = std::max(maxUs, us);
+    float delta = us - mean;
+    mean += delta / count;
+    m2 += delta * (us - mean);
+  }
+
+  /**
+   * @brief Number of blocks accumulated since the last reset.
+   */
+  uint32_t blocks() const { return count; }
+
+  /**
+   * @brief Returns the current statistics.
+   */
+  Summary summarize() const {
+    Summary s;
+    s.blocks = count;
+    s.minUs = count ? (float)minUs : 0.0f;
+    s.maxUs = (float)maxUs;
+    s.meanUs = mean;
+    s.stddevUs = count > 1 ? std::sqrt(m2 / (count - 1)) : 0.0f;
+    return s;
+  }
+
+  /**
+   * @brief Clears all accumulated values.
+   */
+  void reset() {
+    count = 0;
+    minUs = UINT32_MAX;
+    maxUs = 0;
+    mean = 0.0f;
+    m2 = 0.0f;
+  }
+
+private:
+  uint32_t count = 0;
+  uint32_t minUs = UINT32_MAX;
+  uint32_t maxUs = 0;
+  float mean = 0.0f;
+  float m2 = 0.0f;
+};
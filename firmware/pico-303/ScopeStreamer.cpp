@@ -0,0 +1,98 @@
+/**
+ * @file ScopeStreamer.cpp
+ * @brief Implementation of the ScopeStreamer class.
+ */
+
+#include "ScopeStreamer.h"
+#include <cmath>
+#include <algorithm>
+
+void ScopeStreamer::configure(uint8_t f, uint8_t rate) {
+  flags = f;
+  fps = std::max<uint8_t>(1, std::min(rate, kMaxFps));
+  byteBudget = 0;
+}
+
+void ScopeStreamer::service(uint32_t nowMs, float audioLoad, const AudioTap& tap, FixedFFT& fft, SendFn send) {
+  if (!isActive()) return;
+
+  // Refill the USB byte budget (at most one second worth)
+  uint32_t elapsed = nowMs - lastBudgetMs;
+  lastBudgetMs = nowMs;
+  byteBudget = std::min<int32_t>(byteBudget + (int32_t)(elapsed * kMaxBytesPerSecond / 1000), kMaxBytesPerSecond);
+
+  // Back off when the audio engine is busy: streaming is the first thing to go
+  if (audioLoad > 0.9f) return;
+  uint32_t interval = 1000 / fps;
+  if (audioLoad > 0.75f) interval *= 4;
+  else if (audioLoad > 0.6f) interval *= 2;
+
+  if (nowMs - lastFrameMs < interval) return;
+  if (byteBudget <= 0) return;
+
+  AudioTap::Channel ch = (flags & STREAM_OUTPUT) ? AudioTap::OUTPUT : AudioTap::POST_VCA;
+
+  // Alternate scope and spectrum frames when both are enabled
+  bool spectrum = (flags & STREAM_SPECTRUM) && (spectrumNext || !(flags & STREAM_SCOPE));
+  spectrumNext = !spectrumNext;
+
+  unsigned length = spectrum ? encodeSpectrum(tap, ch, fft) : encodeScope(tap, ch);
+  if (length == 0) return;  // Tap overtaken the copy; try again next call
+
+  send(frame, length);
+  byteBudget -= length;
+  lastFrameMs = nowMs;
+  sequence = (sequence + 1) & 0x3FFF;
+}
+
+unsigned ScopeStreamer::encodeScope(const AudioTap& tap, AudioTap::Channel ch) {
+  if (!tap.snapshot(ch, samples, 2 * kScopeSamples)) return 0;
+
+  // Trigger on a rising zero crossing, like the OLED scope page
+  int trigger = 0;
+  for (int i = 1; i < kScopeSamples; i++) {
+    if (samples[i - 1] < 0.0f && samples[i] >= 0.0f) {
+      trigger = i;
+      break;
+    }
+  }
+  const float* wave = samples + trigger;
+
+  float peak = 0.01f;
+  for (int i = 0; i < kScopeSamples; i++) {
+    peak = std::max(peak, std::fabs(wave[i]));
+  }
+  for (int i = 0; i < kScopeSamples; i++) {
+    quantized[i] = (uint8_t)lrintf(127.5f + wave[i] / peak * 127.0f);
+  }
+
+  unsigned len = sysexWriteHeader(frame, SYSEX_SCOPE_FRAME);
+  len += sysexWrite14(frame + len, sequence);
+  frame[len++] = (uint8_t)ch;
+  frame[len++] = kScopeSamples - 1;
+  len += sysexWrite14(frame + len, (uint16_t)std::min(peak * 1000.0f, 16383.0f));  // Peak in 1/1000
+  len += sysexDeltaEncode(quantized, kScopeSamples, frame + len);
+  frame[len++] = 0xF7;
+  return len;
+}
+
+unsigned ScopeStreamer::encodeSpectrum(const AudioTap& tap, AudioTap::Channel ch, FixedFFT& fft) {
+  if (!tap.snapshot(ch, samples, FixedFFT::kSize)) return 0;
+
+  uint16_t mags[FixedFFT::kBins];
+  fft.magnitudes(samples, mags);
+
+  // 0 dB .. -72 dB mapped onto 0..255
+  for (int i = 0; i < FixedFFT::kBins; i++) {
+    float db = 20.0f * std::log10(std::max<float>(mags[i], 1.0f) / 32767.0f);
+    quantized[i] = (uint8_t)std::max(0.0f, std::min(255.0f, (db + 72.0f) * (255.0f / 72.0f)));
+  }
+
+  unsigned len = sysexWriteHeader(frame, SYSEX_SPECTRUM_FRAME);
+  len += sysexWrite14(frame + len, sequence);
+  frame[len++] = (uint8_t)ch;
+  frame[len++] = FixedFFT::kBins - 1;
+  len += sysexDeltaEncode(quantized, FixedFFT::kBins, frame + len);
+  frame[len++] = 0xF7;
+  return len;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+#include "AudioTap.h"
+#include "FixedFFT.h"
+#include "SysExProtocol.h"
+
+/**
+ * @file ScopeStreamer.h
+ * @brief Streams decimated waveform and spectrum frames over SysEx.
+ */
+
+/**
+ * @class ScopeStreamer
+ * @brief Turns AudioTap snapshots into compact SysEx frames for the web controller.
+ * Runs on the housekeeping side. Frame rate is configured by the host and
+ * capped by a USB byte budget; it is reduced automatically when the audio
+ * render load gets high.
+ */
+class ScopeStreamer {
+public:
+  static const uint8_t kMaxFps = 30;
+  static const uint32_t kMaxBytesPerSecond = 12000;  ///< ~10% of USB-MIDI full-speed throughput
+  static const int kScopeSamples = 128;
+
+  /**
+   * @brief Function used to send a complete SysEx message (including F0/F7).
+   */
+  typedef void (*SendFn)(const uint8_t* data, unsigned length);
+
+  /**
+   * @brief Applies a SYSEX_STREAM_CONFIG request.
+   * @param flags STREAM_* flags (0 stops streaming)
+   * @param fps Requested frames per second (clamped to 1..kMaxFps)
+   */
+  void configure(uint8_t flags, uint8_t fps);
+
+  /**
+   * @brief Checks whether any stream is enabled (the audio tap must be armed).
+   */
+  bool isActive() const { return (flags & (STREAM_SCOPE | STREAM_SPECTRUM)) != 0; }
+
+  /**
+   * @brief Sends the next frame if one is due.
+   * @param nowMs Current time in milliseconds
+   * @param audioLoad Recent audio render time / block period (0..1+)
+   * @param tap Audio tap to read from
+   * @param fft FFT used for spectrum frames
+   * @param send Function that transmits the frame
+   */
+  void service(uint32_t nowMs, float audioLoad, const AudioTap& tap, FixedFFT& fft, SendFn send);
+
+private:
+  uint8_t flags = 0;
+  uint8_t fps = 15;
+  uint16_t sequence = 0;
+  bool spectrumNext = false;
+  uint32_t lastFrameMs = 0;
+  uint32_t lastBudgetMs = 0;
+  int32_t byteBudget = 0;
+
+  float samples[2 * kScopeSamples];
+  uint8_t quantized[2 * kScopeSamples];
+  uint8_t frame[SYSEX_HEADER_SIZE + 8 + 3 * kScopeSamples + 1];
+
+  unsigned encodeScope(const AudioTap& tap, AudioTap::Channel ch);
+  unsigned encodeSpectrum(const AudioTap& tap, AudioTap::Channel ch, FixedFFT& fft);
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+#include "SynthEvent.h"
+
+/**
+ * @file SketchHooks.h
+ * @brief The sketch functions that host drivers (replay, stress) call
+ * between blocks instead of running loop().
+ *
+ * pico-303.ino includes this header too, so a changed signature fails to
+ * compile rather than linking against the wrong type.
+ */
+
+/// Applies one event the way the audio side does when it pops the queue
+void applyEvent(const SynthEvent& ev);
+
+/// Renders one AUDIO_BLOCK_SIZE block into the audio buffer
+void renderBlock();
+
+/// The block renderBlock() wrote last, L/R interleaved
+const int16_t* renderedBlock();
+
+/// Frames rendered since power-on (audio side)
+extern uint32_t samplesRendered;
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * @file SpscQueue.h
+ * @brief Lock-free single-producer / single-consumer ring buffer.
+ */
+
+/**
+ * @class SpscQueue
+ * @brief Wait-free FIFO for passing small POD messages between the two cores
+ * (or between an ISR and the main loop). Exactly one thread may push and
+ * exactly one thread may pop. Never blocks and never allocates.
+ * @tparam T Message type (trivially copyable)
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, uint32_t Capacity>
+class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+  /**
+   * @brief Appends a message (producer side).
+   * @param item Message to copy into the queue
+   * @return false if the queue is full (message dropped)
+   */
+  bool push(const T& item) {
+    uint32_t head = writePos.load(std::memory_order_relaxed);
+    if (head - readPos.load(std::memory_order_acquire) >= Capacity) {
+      return false;
+    }
+    slots[head & (Capacity - 1)] = item;
+    writePos.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest message (consumer side).
+   * @param item Receives the message
+   * @return false if the queue is empty
+   */
+  bool pop(T& item) {
+    uint32_t tail = readPos.load(std::memory_order_relaxed);
+    if (tail == writePos.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = slots[tail & (Capacity - 1)];
+    readPos.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Checks whether there is nothing to pop (consumer side).
+   */
+  bool empty() const {
+    return readPos.load(std::memory_order_acquire) == writePos.load(std::memory_order_acquire);
+  }
+
+private:
+  T slots[Capacity];
+  std::atomic<uint32_t> writePos{0};
+  std::atomic<uint32_t> readPos{0};
+};
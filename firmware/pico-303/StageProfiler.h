@@ -0,0 +1,160 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @file StageProfiler.h
+ * @brief Per-stage cycle profiler for the audio render loop.
+ *
+ * Enable with ENABLE_PROFILER. Without it the engine renders with a
+ * NullProfiler, whose empty marks compile away.
+ */
+
+#if defined(ARDUINO_ARCH_RP2040) && defined(__ARM_ARCH_8M_MAIN__)
+  // Cortex-M33 DWT cycle counter (RP2350 Arm cores)
+  #define PROFILER_HAS_DWT
+  #define PROFILER_DEMCR      (*(volatile uint32_t*)0xE000EDFC)
+  #define PROFILER_DWT_CTRL   (*(volatile uint32_t*)0xE0001000)
+  #define PROFILER_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+#elif defined(ARDUINO_ARCH_RP2040)
+  // RP2040's Cortex-M0+ and RP2350's RISC-V cores have no DWT: micros()
+  #include <Arduino.h>
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#else
+  #include <chrono>
+#endif
+
+/**
+ * @brief Stages of fillAudioBlock(), in processing order.
+ */
+enum ProfileStage : uint8_t {
+  STAGE_ENVELOPES,
+  STAGE_OSCILLATOR,
+  STAGE_FILTER,
+  STAGE_DC_BLOCKER,
+  STAGE_VCA,
+  STAGE_DISTORTION,
+  STAGE_DELAY,
+  STAGE_OUTPUT,     ///< Soft clip, int16 conversion and audio tap
+  STAGE_COUNT
+};
+
+/**
+ * @class StageProfiler
+ * @brief Accumulates cycles spent in each stage over a block, then folds the
+ * per-block totals into min/avg/max. Audio side only; results are copied out
+ * as a Report.
+ */
+class StageProfiler {
+public:
+  /**
+   * @brief Per-stage cycles per block since the last reset.
+   */
+  struct Report {
+    uint32_t blocks;
+    uint32_t minCycles[STAGE_COUNT];
+    uint32_t avgCycles[STAGE_COUNT];
+    uint32_t maxCycles[STAGE_COUNT];
+  };
+
+  /**
+   * @brief Enables the hardware cycle counter (device only).
+   */
+  void begin() {
+#if defined(PROFILER_HAS_DWT)
+    PROFILER_DEMCR |= (1u << 24);   // TRCENA
+    PROFILER_DWT_CYCCNT = 0;
+    PROFILER_DWT_CTRL |= 1u;        // CYCCNTENA
+#endif
+    reset();
+  }
+
+  /**
+   * @brief Reads the cycle counter (CPU cycles on device and x86, ns elsewhere).
+   * Devices without DWT count cycles in steps of one microsecond.
+   */
+  static inline uint32_t now() {
+#if defined(PROFILER_HAS_DWT)
+    return PROFILER_DWT_CYCCNT;
+#elif defined(ARDUINO_ARCH_RP2040)
+    return (uint32_t)micros() * (uint32_t)(F_CPU / 1000000);
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  /**
+   * @brief Starts timing a block.
+   */
+  inline void beginBlock() {
+    for (int i = 0; i < STAGE_COUNT; i++) acc[i] = 0;
+    last = now();
+  }
+
+  /**
+   * @brief Charges the time since the previous mark to a stage.
+   */
+  inline void mark(ProfileStage stage) {
+    uint32_t t = now();
+    acc[stage] += t - last;
+    last = t;
+  }
+
+  /**
+   * @brief Folds the block's per-stage totals into the statistics.
+   */
+  void endBlock() {
+    blocks++;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+      if (acc[i] < minCycles[i]) minCycles[i] = acc[i];
+      if (acc[i] > maxCycles[i]) maxCycles[i] = acc[i];
+      sumCycles[i] += acc[i];
+    }
+  }
+
+  /**
+   * @brief Returns the statistics accumulated since the last reset.
+   */
+  Report report() const {
+    Report r;
+    r.blocks = blocks;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+      r.minCycles[i] = blocks ? minCycles[i] : 0;
+      r.maxCycles[i] = maxCycles[i];
+      r.avgCycles[i] = blocks ? (uint32_t)(sumCycles[i] / blocks) : 0;
+    }
+    return r;
+  }
+
+  /**
+   * @brief Clears the statistics.
+   */
+  void reset() {
+    blocks = 0;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+      minCycles[i] = UINT32_MAX;
+      maxCycles[i] = 0;
+      sumCycles[i] = 0;
+    }
+  }
+
+private:
+  uint32_t last = 0;
+  uint32_t acc[STAGE_COUNT];
+  uint32_t blocks = 0;
+  uint32_t minCycles[STAGE_COUNT];
+  uint32_t maxCycles[STAGE_COUNT];
+  uint64_t sumCycles[STAGE_COUNT];
+};
+
+/**
+ * @brief Stand-in with the StageProfiler marking interface that does nothing.
+ */
+struct NullProfiler {
+  inline void beginBlock() {}
+  inline void mark(ProfileStage) {}
+  inline void endBlock() {}
+};
@@ -4,6 +4,8 @@
  */
 
 #include "StereoDelay.h"
+#include "HotPath.h"
+#include "CoefficientTables.h"
 #include <cmath>
 #include <algorithm>
 
@@ -14,18 +16,26 @@ StereoDelay::StereoDelay(int maxDelay)
 
 StereoDelay::~StereoDelay() {}
 
-bool StereoDelay::begin() {
-  // Allocate memory now
-  bufferL.resize(maxDelaySamples, 0.0f);
-  bufferR.resize(maxDelaySamples, 0.0f);
+bool StereoDelay::begin(Arena& arena) {
+  bufferL = arena.allocate<float>(maxDelaySamples, "StereoDelay L");
+  bufferR = arena.allocate<float>(maxDelaySamples, "StereoDelay R");
+  if (!bufferL || !bufferR) {
+    bufferL = bufferR = nullptr;
+    return false;
+  }
+  // Arena memory is not zeroed (it may sit in a NOLOAD section)
+  std::fill(bufferL, bufferL + maxDelaySamples, 0.0f);
+  std::fill(bufferR, bufferR + maxDelaySamples, 0.0f);
   
   // Calculate smoothing coefficient for 400ms ramp time
   // Using one-pole lowpass: coeff = 1 - exp(-1 / (rampTime * sampleRate))
-  float rampTimeSec = 0.4f; // 400ms
-  smoothingCoeff = 1.0f - std::exp(-1.0f / (rampTimeSec * sampleRate));
-  
-  // Check if allocation succeeded (though std::vector usually throws)
-  return (bufferL.size() == maxDelaySamples && bufferR.size() == maxDelaySamples);
+  smoothingCoeff = onePoleForTime(400.0f, sampleRate);
+  return true;
+}
+
+void StereoDelay::setSampleRate(float sr) {
+  sampleRate = sr;
+  smoothingCoeff = onePoleForTime(400.0f, sampleRate);
 }
 
 void StereoDelay::setTimeSamplesL(int samples) {
@@ -46,8 +56,8 @@ void StereoDelay::setMix(float m) {
   mix = std::max(0.0f, std::min(m, 1.0f));
 }
 
-float StereoDelay::processL(float input) {
-  if (bufferL.empty()) return input; // Safety check
+float DSP_HOT_FUNC(StereoDelay::processL)(float input) {
+  if (!bufferL) return input; // Safety check
 
   int readIndex = writeIndex - (int)delaySamplesL;
   if (readIndex < 0) readIndex += maxDelaySamples;
@@ -56,8 +66,8 @@ float StereoDelay::processL(float input) {
   return (1.0f - mix) * input + mix * delayed;
 }
 
-float StereoDelay::processR(float input) {
-  if (bufferR.empty()) return input; // Safety check
+float DSP_HOT_FUNC(StereoDelay::processR)(float input) {
+  if (!bufferR) return input; // Safety check
 
   int readIndex = writeIndex - (int)delaySamplesR;
   if (readIndex < 0) readIndex += maxDelaySamples;
@@ -66,8 +76,8 @@ float StereoDelay::processR(float input) {
   return (1.0f - mix) * input + mix * delayed;
 }
 
-void StereoDelay::tick(float inL, float inR) {
-  if (bufferL.empty() || bufferR.empty()) return;
+void DSP_HOT_FUNC(StereoDelay::tick)(float inL, float inR) {
+  if (!bufferL || !bufferR) return;
 
   // Smooth delay time changes (one-pole lowpass filter)
   delaySamplesL += smoothingCoeff * (targetDelaySamplesL - delaySamplesL);
@@ -1,5 +1,6 @@
 #pragma once
-#include <vector>
+#include <stddef.h>
+#include "Arena.h"
 
 /**
  * @file StereoDelay.h
@@ -9,7 +10,7 @@
 /**
  * @class StereoDelay
  * @brief Implements a stereo delay line with independent left/right delay times.
- * Uses std::vector for buffer management to allow dynamic allocation.
+ * The two delay lines come from an Arena, so their RAM is fixed at build time.
  */
 class StereoDelay {
 public:
@@ -21,11 +22,24 @@ public:
   ~StereoDelay();
 
   /**
-   * @brief Allocates memory for the delay buffers.
+   * @brief Arena space needed for a delay of maxDelay samples.
+   */
+  static constexpr size_t arenaBytes(int maxDelay = 44100) {
+    return 2 * Arena::bytesFor<float>(maxDelay);
+  }
+
+  /**
+   * @brief Takes the delay buffers from the arena and clears them.
    * Must be called in setup(), not global scope.
-   * @return true if allocation succeeded
+   * @return true if the arena had room
    */
-  bool begin(); 
+  bool begin(Arena& arena);
+
+  /**
+   * @brief Sets the sample rate the delay-time smoothing is computed for.
+   * @param sr Sample rate in Hz
+   */
+  void setSampleRate(float sr);
 
   /**
    * @brief Sets the left channel delay time.
@@ -73,17 +87,39 @@ public:
    */
   void tick(float inL, float inR);
 
+  /**
+   * @brief Visits settings, smoothing state and both delay lines for engine
+   * snapshots. The archive decides how to store the buffers (host tools
+   * drop silent runs). maxDelaySamples is fixed by the build and only
+   * checked through the buffer lengths; the write index and delay times
+   * index the buffers, so a restore rejects them out of range.
+   */
+  template <class Archive>
+  void serialize(Archive& ar) {
+    const float maxDelay = (float)(maxDelaySamples - 1);
+    ar.value(writeIndex, 0, maxDelaySamples - 1);
+    ar.value(sampleRate);
+    ar.value(delaySamplesL, 1.0f, maxDelay);
+    ar.value(delaySamplesR, 1.0f, maxDelay);
+    ar.value(targetDelaySamplesL, 1.0f, maxDelay);
+    ar.value(targetDelaySamplesR, 1.0f, maxDelay);
+    ar.value(smoothingCoeff);
+    ar.value(feedback);
+    ar.value(mix);
+    ar.samples(bufferL, maxDelaySamples);
+    ar.samples(bufferR, maxDelaySamples);
+  }
+
 private:
-  std::vector<float> bufferL;
-  std::vector<float> bufferR;
+  float* bufferL = nullptr;
+  float* bufferR = nullptr;
   int maxDelaySamples;
   int writeIndex = 0;
   
-  float sampleRate = 44100.0f;
-  
   // Current delay times (smoothed)
   float delaySamplesL = 10000.0f;
   float delaySamplesR = 10000.0f;
+  float mix = 0.3f;
   
   // Target delay times (set by user)
   float targetDelaySamplesL = 10000.0f;
@@ -93,5 +129,6 @@ private:
   float smoothingCoeff = 0.0f;
   
   float feedback = 0.3f;
-  float mix = 0.3f;
+
+  float sampleRate = 44100.0f;  // Only used to compute smoothingCoeff
 };
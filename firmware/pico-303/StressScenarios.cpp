@@ -0,0 +1,143 @@
+/**
+ * @file StressScenarios.cpp
+ * @brief Stress scenario table and the StressPlayer implementation.
+ */
+
+#include "StressScenarios.h"
+
+namespace {
+
+// Neutral patch every scenario starts from, so results do not depend on what ran before
+const StressCC kBaseline[] = {
+  {7, 100}, {14, 0}, {15, 64}, {17, 64}, {18, 0}, {71, 64}, {74, 64}, {75, 64},
+  {77, 0}, {78, 0}, {79, 0}, {80, 0}, {81, 64}, {82, 0}, {83, 0}, {100, 64}
+};
+
+// 16-step acid line (0 = rest)
+const uint8_t kPattern[16] = {36, 36, 48, 36, 39, 0, 36, 51, 36, 43, 36, 0, 48, 46, 36, 39};
+
+const StressCC kResonance[] = {{71, 127}, {17, 127}, {74, 20}, {75, 127}};
+const StressCC kAccentSlide[] = {{71, 110}, {17, 127}, {15, 127}, {100, 127}};
+const StressCC kDistSoft[] = {{80, 127}, {77, 0}, {78, 127}, {79, 127}};
+const StressCC kDistHard[] = {{80, 127}, {77, 1}, {78, 127}, {79, 127}};
+const StressCC kDistFold[] = {{80, 127}, {77, 2}, {78, 127}, {79, 127}};
+const StressCC kDistDiode[] = {{80, 127}, {77, 3}, {78, 127}, {79, 127}};
+const StressCC kDistTube[] = {{80, 127}, {77, 4}, {78, 127}, {79, 127}};
+const StressCC kDelay[] = {{81, 127}, {82, 127}, {83, 127}};
+const StressCC kFlood[] = {{71, 100}, {17, 100}};
+const StressCC kEverything[] = {
+  {71, 127}, {17, 127}, {15, 127}, {100, 127}, {80, 127}, {77, 4}, {78, 127}, {79, 127},
+  {81, 127}, {82, 127}, {83, 127}
+};
+
+#define CCS(list) list, sizeof(list) / sizeof(list[0])
+
+}  // namespace
+
+const StressScenario kStressScenarios[] = {
+  // name              patch               accents  slides  flood        bpm  s
+  {"reso_envmod",      CCS(kResonance),    0x0000,  0x0000,  0,    0,    130, 5},
+  {"accent_slides",    CCS(kAccentSlide),  0x5555,  0x6666,  0,    0,    130, 5},
+  {"dist_soft",        CCS(kDistSoft),     0x1111,  0x0000,  0,    0,    130, 3},
+  {"dist_hard",        CCS(kDistHard),     0x1111,  0x0000,  0,    0,    130, 3},
+  {"dist_fold",        CCS(kDistFold),     0x1111,  0x0000,  0,    0,    130, 3},
+  {"dist_diode",       CCS(kDistDiode),    0x1111,  0x0000,  0,    0,    130, 3},
+  {"dist_tube",        CCS(kDistTube),     0x1111,  0x0000,  0,    0,    130, 3},
+  {"delay_feedback",   CCS(kDelay),        0x1111,  0x0000,  0,    0,    130, 5},
+  {"cc_flood",         CCS(kFlood),        0x1111,  0x2222,  74,   1000, 130, 5},
+  {"everything",       CCS(kEverything),   0x5555,  0x6666,  74,   1000, 140, 5},
+};
+
+const int kStressScenarioCount = sizeof(kStressScenarios) / sizeof(kStressScenarios[0]);
+
+void StressPlayer::start(int index, uint32_t sampleRate) {
+  scenario = &kStressScenarios[index];
+  current = index;
+  active = true;
+  setupPending = true;
+  pos = 0;
+  length = scenario->seconds * sampleRate;
+  stepSamples = sampleRate * 15 / scenario->bpm;  // 16th notes
+  nextStep = 0;
+  step = 0;
+  noteOffAt = UINT32_MAX;
+  heldNote = 0xFF;
+  floodInterval = scenario->floodPerSecond ? sampleRate / scenario->floodPerSecond : 0;
+  nextFlood = floodInterval ? 0 : UINT32_MAX;
+  floodCount = 0;
+  blocks = 0;
+  maxUs = 0;
+  totalUs = 0;
+  worstBlock = 0;
+}
+
+bool StressPlayer::advance(uint32_t frames, EmitFn emit) {
+  if (!active) return false;
+
+  if (setupPending) {
+    for (const StressCC& c : kBaseline) emit({SynthEvent::CONTROL_CHANGE, 1, c.cc, c.value, 0.0f});
+    for (int i = 0; i < scenario->ccCount; i++) {
+      emit({SynthEvent::CONTROL_CHANGE, 1, scenario->ccs[i].cc, scenario->ccs[i].value, 0.0f});
+    }
+    setupPending = false;
+  }
+
+  uint32_t blockEnd = pos + frames;
+  if (pos >= length) {
+    // Release the last note; the block after it is still rendered and timed
+    if (heldNote != 0xFF) emit({SynthEvent::NOTE_OFF, 1, heldNote, 0, 0.0f});
+    heldNote = 0xFF;
+    active = false;
+    return false;
+  }
+
+  // Events inside the block, in time order (all take effect at the block start)
+  while (true) {
+    uint32_t next = nextStep;
+    if (noteOffAt < next) next = noteOffAt;
+    if (nextFlood < next) next = nextFlood;
+    if (next >= blockEnd) break;
+
+    if (next == noteOffAt) {
+      emit({SynthEvent::NOTE_OFF, 1, heldNote, 0, 0.0f});
+      heldNote = 0xFF;
+      noteOffAt = UINT32_MAX;
+    } else if (next == nextStep) {
+      int s = step & 15;
+      uint8_t pitch = kPattern[s];
+      if (pitch) {
+        uint8_t velocity = (scenario->accentMask >> s) & 1 ? 120 : 80;
+        uint8_t previous = heldNote;
+        emit({SynthEvent::NOTE_ON, 1, pitch, velocity, 0.0f});
+        // A held note makes this a slide; release the old pitch after the new one starts
+        if (previous != 0xFF && previous != pitch) emit({SynthEvent::NOTE_OFF, 1, previous, 0, 0.0f});
+        heldNote = pitch;
+        noteOffAt = (scenario->slideMask >> s) & 1 ? UINT32_MAX : nextStep + stepSamples / 2;
+      }
+      step++;
+      nextStep += stepSamples;
+    } else {
+      // Triangle sweep over the full controller range
+      uint32_t phase = (floodCount++ * 4) % 254;
+      uint8_t value = phase < 127 ? phase : 254 - phase;
+      emit({SynthEvent::CONTROL_CHANGE, 1, scenario->floodCC, value, 0.0f});
+      nextFlood += floodInterval;
+    }
+  }
+
+  pos = blockEnd;
+  return true;
+}
+
+void StressPlayer::recordBlock(uint32_t us) {
+  if (us > maxUs) {
+    maxUs = us;
+    worstBlock = blocks;
+  }
+  totalUs += us;
+  blocks++;
+}
+
+StressPlayer::Result StressPlayer::result() const {
+  return {(uint8_t)current, blocks, maxUs, blocks ? (uint32_t)(totalUs / blocks) : 0, worstBlock};
+}
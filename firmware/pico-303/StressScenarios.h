@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+#include "SynthEvent.h"
+
+/**
+ * @file StressScenarios.h
+ * @brief Fixed worst-case render load scenarios, shared by the firmware's
+ * stress mode and the host benchmark (firmware/host/pico303_stress).
+ */
+
+/**
+ * @brief One controller setting applied when a scenario starts.
+ */
+struct StressCC {
+  uint8_t cc;
+  uint8_t value;
+};
+
+/**
+ * @struct StressScenario
+ * @brief A patch, a 16-step pattern and an optional controller flood.
+ */
+struct StressScenario {
+  const char* name;
+  const StressCC* ccs;          ///< Applied on top of the common baseline
+  uint8_t ccCount;
+  uint16_t accentMask;          ///< Bit per step: velocity 120 instead of 80
+  uint16_t slideMask;           ///< Bit per step: hold into the next step (303 slide)
+  uint8_t floodCC;              ///< Swept controller, 0 = no flood
+  uint16_t floodPerSecond;
+  uint16_t bpm;
+  uint8_t seconds;
+};
+
+extern const StressScenario kStressScenarios[];
+extern const int kStressScenarioCount;
+
+/**
+ * @class StressPlayer
+ * @brief Plays a scenario block by block and keeps the render time statistics.
+ * Runs on the audio side: advance() before rendering a block, recordBlock()
+ * after it.
+ */
+class StressPlayer {
+public:
+  typedef void (*EmitFn)(const SynthEvent& ev);
+
+  struct Result {
+    uint8_t index;
+    uint16_t blocks;
+    uint32_t maxUs;
+    uint32_t meanUs;
+    uint16_t worstBlock;
+  };
+
+  void start(int index, uint32_t sampleRate);
+  bool isActive() const { return active; }
+  int index() const { return current; }
+
+  /**
+   * @brief Emits the events due in the next block.
+   * @return false once the scenario has finished (the last note is released)
+   */
+  bool advance(uint32_t frames, EmitFn emit);
+
+  void recordBlock(uint32_t us);
+  Result result() const;
+
+private:
+  const StressScenario* scenario = nullptr;
+  int current = -1;
+  bool active = false;
+  bool setupPending = false;
+  uint32_t pos = 0;
+  uint32_t length = 0;
+  uint32_t stepSamples = 0;
+  uint32_t nextStep = 0;
+  uint32_t step = 0;
+  uint32_t noteOffAt = 0;
+  uint8_t heldNote = 0xFF;
+  uint32_t floodInterval = 0;
+  uint32_t nextFlood = 0;
+  uint32_t floodCount = 0;
+
+  uint16_t blocks = 0;
+  uint32_t maxUs = 0;
+  uint64_t totalUs = 0;
+  uint16_t worstBlock = 0;
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @file SynthEvent.h
+ * @brief Compact event passed from the housekeeping side to the audio engine.
+ */
+
+/**
+ * @struct SynthEvent
+ * @brief One note, controller or tempo change, applied at the next block boundary.
+ */
+struct SynthEvent {
+  enum Type : uint8_t {
+    NOTE_ON,
+    NOTE_OFF,
+    CONTROL_CHANGE,
+    TEMPO           ///< value = BPM measured from MIDI clock
+  };
+
+  Type type;
+  uint8_t channel;
+  uint8_t data1;    ///< Note number or CC number
+  uint8_t data2;    ///< Velocity or CC value
+  float value;
+};
@@ -0,0 +1,134 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @file SysExProtocol.h
+ * @brief SysEx message layout shared by the firmware and the web controller.
+ *
+ * Every message: F0 7D 50 33 <command> <payload (7-bit bytes)> F7
+ * (0x7D = non-commercial manufacturer ID, 0x50 0x33 = "P3").
+ */
+
+#define SYSEX_MANUFACTURER_ID 0x7D
+#define SYSEX_DEVICE_ID_0     0x50
+#define SYSEX_DEVICE_ID_1     0x33
+#define SYSEX_HEADER_SIZE     5     // F0 + manufacturer + device id + command
+
+enum SysExCommand : uint8_t {
+  // Host -> device
+  SYSEX_STREAM_CONFIG = 0x01,   ///< [flags, fps] see STREAM_* flags
+  SYSEX_PROFILE_REQUEST = 0x02, ///< [reset] 1 = clear statistics after reporting
+  SYSEX_LOG_MASK = 0x03,        ///< [mask] enabled log categories (DEBUG_SERIAL builds)
+  SYSEX_TRACE_REQUEST = 0x04,   ///< [] dump the event trace (TRACE_HEADER, then TRACE_EVENTS)
+  SYSEX_STRESS_RUN = 0x05,      ///< [scenario] run one stress scenario, 0x7F = all in turn
+
+  // Device -> host
+  SYSEX_SCOPE_FRAME = 0x10,     ///< [seq lo, seq hi, source, count, scale lo, scale hi, delta data]
+  SYSEX_SPECTRUM_FRAME = 0x11,  ///< [seq lo, seq hi, source, count, delta data]
+  SYSEX_PROFILE_REPORT = 0x12,  ///< [stage count, MHz (14), blocks (28), per stage: min, avg, max cycles (28 each)]
+  SYSEX_TRACE_HEADER = 0x13,    ///< [flags, sample rate (28), block size (14), start (32), end (32), events (14),
+                                ///<  bpm bits (32), CC set mask (19 x 7 bits), 128 CC values]
+  SYSEX_TRACE_EVENTS = 0x14,    ///< [first index (14), count, per event: sample (32), type, channel, data1, data2, value bits (32)]
+  SYSEX_STRESS_REPORT = 0x15    ///< [scenario, scenario count, blocks (14), max us (28), mean us (28), worst block (14), name (ASCII)]
+};
+
+// SYSEX_TRACE_HEADER flags
+#define TRACE_COMPLETE   0x01   // Trace starts at power-on, replay is exact
+
+// SYSEX_STREAM_CONFIG flags
+#define STREAM_SCOPE     0x01
+#define STREAM_SPECTRUM  0x02
+#define STREAM_OUTPUT    0x04   // Tap the final output instead of post-VCA
+
+/**
+ * @brief Writes the common message header.
+ * @return Number of bytes written (SYSEX_HEADER_SIZE)
+ */
+inline unsigned sysexWriteHeader(uint8_t* out, uint8_t command) {
+  out[0] = 0xF0;
+  out[1] = SYSEX_MANUFACTURER_ID;
+  out[2] = SYSEX_DEVICE_ID_0;
+  out[3] = SYSEX_DEVICE_ID_1;
+  out[4] = command;
+  return SYSEX_HEADER_SIZE;
+}
+
+/**
+ * @brief Checks that a complete message (F0 ... F7) is addressed to the pico-303.
+ */
+inline bool sysexIsOurs(const uint8_t* msg, unsigned size) {
+  return size > SYSEX_HEADER_SIZE && msg[0] == 0xF0 && msg[1] == SYSEX_MANUFACTURER_ID &&
+         msg[2] == SYSEX_DEVICE_ID_0 && msg[3] == SYSEX_DEVICE_ID_1 && msg[size - 1] == 0xF7;
+}
+
+/**
+ * @brief Writes a 14-bit value as two 7-bit bytes (low first).
+ * @return Number of bytes written (2)
+ */
+inline unsigned sysexWrite14(uint8_t* out, uint16_t value) {
+  out[0] = value & 0x7F;
+  out[1] = (value >> 7) & 0x7F;
+  return 2;
+}
+
+/**
+ * @brief Writes a 28-bit value as four 7-bit bytes (low first).
+ * @return Number of bytes written (4)
+ */
+inline unsigned sysexWrite28(uint8_t* out, uint32_t value) {
+  if (value > 0x0FFFFFFF) value = 0x0FFFFFFF;
+  for (int i = 0; i < 4; i++) {
+    out[i] = (value >> (7 * i)) & 0x7F;
+  }
+  return 4;
+}
+
+/**
+ * @brief Writes a full 32-bit value as five 7-bit bytes (low first).
+ * @return Number of bytes written (5)
+ */
+inline unsigned sysexWrite32(uint8_t* out, uint32_t value) {
+  for (int i = 0; i < 5; i++) {
+    out[i] = (value >> (7 * i)) & 0x7F;
+  }
+  return 5;
+}
+
+/**
+ * @brief Reads a value written by sysexWrite14/28/32.
+ * @param bytes Number of 7-bit bytes (2, 4 or 5)
+ */
+inline uint32_t sysexRead(const uint8_t* in, unsigned bytes) {
+  uint32_t value = 0;
+  for (unsigned i = 0; i < bytes; i++) {
+    value |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+  }
+  return value;
+}
+
+/**
+ * @brief Delta-encodes 8-bit samples into 7-bit bytes.
+ * The first sample is coded against 128. Deltas in [-63, 63] take one
+ * zigzag byte (0..126); larger jumps take 0x7F followed by the absolute
+ * sample as two bytes (bit 7, bits 0-6).
+ * @param in Samples
+ * @param n Number of samples
+ * @param out Destination, must hold 3 * n bytes
+ * @return Number of bytes written
+ */
+inline unsigned sysexDeltaEncode(const uint8_t* in, unsigned n, uint8_t* out) {
+  unsigned len = 0;
+  int prev = 128;
+  for (unsigned i = 0; i < n; i++) {
+    int delta = (int)in[i] - prev;
+    if (delta >= -63 && delta <= 63) {
+      out[len++] = (uint8_t)(delta >= 0 ? delta << 1 : ((-delta) << 1) - 1);
+    } else {
+      out[len++] = 0x7F;
+      out[len++] = in[i] >> 7;
+      out[len++] = in[i] & 0x7F;
+    }
+    prev = in[i];
+  }
+  return len;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file TraceRecorder.cpp
+ * @brief Implementation of the TraceRecorder class.
+ */
+
+#include "TraceRecorder.h"
+#include <string.h>
+
+TraceRecorder::TraceRecorder()
+  : head(0), tail(0), start(0), end(0), complete(true), freezeRequested(false), frozen(false) {
+  memset(&base, 0, sizeof(base));
+  memset(&live, 0, sizeof(live));
+}
+
+void TraceRecorder::apply(State& s, const SynthEvent& ev) {
+  if (ev.type == SynthEvent::CONTROL_CHANGE) {
+    s.cc[ev.data1 & 0x7F] = ev.data2;
+    s.ccSet[(ev.data1 & 0x7F) >> 3] |= 1 << (ev.data1 & 7);
+  } else if (ev.type == SynthEvent::TEMPO) {
+    s.bpm = ev.value;
+    s.bpmSet = true;
+  }
+}
+
+void TraceRecorder::evictOldest() {
+  const Entry& e = ring[tail & (kCapacity - 1)];
+  apply(base, e.event);
+  start = e.sample;
+  tail++;
+  // Voice and effect state before the window is not captured
+  complete = false;
+}
+
+void TraceRecorder::record(uint32_t sample, const SynthEvent& ev) {
+  apply(live, ev);
+  if (frozen.load(std::memory_order_relaxed)) return;
+
+  if (head - tail == kCapacity) evictOldest();
+  ring[head & (kCapacity - 1)] = {sample, ev};
+  head++;
+}
+
+void TraceRecorder::tick(uint32_t sample, uint32_t windowSamples) {
+  bool wantFrozen = freezeRequested.load(std::memory_order_acquire);
+  bool isFrozenNow = frozen.load(std::memory_order_relaxed);
+
+  if (wantFrozen && !isFrozenNow) {
+    end = sample;
+    frozen.store(true, std::memory_order_release);
+    return;
+  }
+  if (!wantFrozen && isFrozenNow) {
+    // Events during the dump were not recorded: restart from the current settings
+    base = live;
+    head = tail = 0;
+    start = sample;
+    complete = false;
+    frozen.store(false, std::memory_order_release);
+  }
+  if (isFrozenNow) return;
+
+  while (head != tail && sample - ring[tail & (kCapacity - 1)].sample > windowSamples) {
+    evictOldest();
+  }
+  // The baseline holds anywhere between the last evicted and the oldest kept
+  // event, so the replay only needs to start at the window edge
+  if (!complete && sample - start > windowSamples) {
+    start = sample - windowSamples;
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include "SynthEvent.h"
+
+/**
+ * @file TraceRecorder.h
+ * @brief RAM ring of the events applied to the audio engine, for offline replay.
+ */
+
+/**
+ * @class TraceRecorder
+ * @brief Keeps the last kWindowSeconds (at most kCapacity events) of notes,
+ * controllers and tempo changes, stamped with the sample position where they
+ * took effect. Everything that falls out of the window is folded into a
+ * baseline of controller values, so a replay starts from the right settings.
+ *
+ * record() and tick() run on the audio side. A dump freezes the ring through
+ * a request/acknowledge pair checked at block boundaries, so the reader never
+ * sees a half-written entry and the audio side never waits. After a dump the
+ * recording restarts with the current controller values as its baseline.
+ */
+class TraceRecorder {
+public:
+  static const int kCapacity = 1024;       ///< Events (power of two), 12 bytes each
+  static const int kWindowSeconds = 30;    ///< Nominal window, see tick()
+
+  struct Entry {
+    uint32_t sample;   ///< Samples rendered before the event was applied
+    SynthEvent event;
+  };
+
+  /**
+   * @brief Controller values that apply before the first entry.
+   */
+  struct State {
+    uint8_t cc[128];
+    uint8_t ccSet[16];   ///< Bit per CC that has been received
+    float bpm;
+    bool bpmSet;
+  };
+
+  TraceRecorder();
+
+  /**
+   * @brief Records an event at the given sample position (audio side).
+   */
+  void record(uint32_t sample, const SynthEvent& ev);
+
+  /**
+   * @brief Expires old entries and handles freeze requests (audio side, once per block).
+   * @param windowSamples Window length, a multiple of the block size so the
+   *        trace start stays on a block boundary
+   */
+  void tick(uint32_t sample, uint32_t windowSamples);
+
+  // ---- Reader side ----
+
+  /**
+   * @brief Asks the audio side to stop recording.
+   */
+  void requestFreeze() { freezeRequested.store(true, std::memory_order_release); }
+
+  /**
+   * @brief true once the audio side has stopped touching the ring.
+   */
+  bool isFrozen() const { return frozen.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Restarts recording after a dump.
+   */
+  void release() { freezeRequested.store(false, std::memory_order_release); }
+
+  // Only valid while frozen
+  int size() const { return (int)(head - tail); }
+  const Entry& at(int i) const { return ring[(tail + i) & (kCapacity - 1)]; }
+  const State& baseline() const { return base; }
+  uint32_t startSample() const { return start; }
+  uint32_t endSample() const { return end; }
+
+  /**
+   * @brief true if the trace covers everything since boot, so a replay from
+   * power-on state is exact.
+   */
+  bool isComplete() const { return complete; }
+
+private:
+  Entry ring[kCapacity];
+  uint32_t head;        ///< Next write (monotonic)
+  uint32_t tail;        ///< Oldest entry (monotonic)
+  uint32_t start;       ///< Sample position the baseline describes
+  uint32_t end;         ///< Sample position at freeze
+  State base;
+  State live;           ///< Controller values after the newest entry
+  bool complete;
+
+  std::atomic<bool> freezeRequested;
+  std::atomic<bool> frozen;
+
+  static void apply(State& s, const SynthEvent& ev);
+  void evictOldest();
+};
@@ -22,33 +22,9 @@ uint8_t UIManager::pinA = 0;
 uint8_t UIManager::pinB = 0;
 uint8_t UIManager::pinSW = 0;
 
-// Parameter definitions (24 parameters from pico-303)
-Parameter UIManager::parameters[] = {
-  {"Volume",       7,   76,  0, 127},  // CC7 - default ~60% volume
-  {"Wave ",  18,   0,   0, 127},  // CC18
-  {"Pitch",   16,   64,  0, 127},  // CC16 - 64 = center (0 semitones)
-  {"Cutoff",      74,   64,  0, 127},  // CC74
-  {"Res",   71,   0,   0, 127},  // CC71
-  {"Env",     17,   64,  0, 127},  // CC17
-  {"Decay",       75,   64,  0, 127},  // CC75
-  {"Accent",  15,   64,  0, 127},  // CC15
-  {"SubOsc",   14,   0,   0, 127},  // CC14
-  {"Dist On",     80,   0,   0, 127},  // CC80 - >63 = on
-  {"Dist Mode",   77,   0,   0, 4},    // CC77 - 5 modes (0-4)
-  {"Dist Amt",    78,   0,   0, 127},  // CC78
-  {"Dist Mix",    79,   0,   0, 127},  // CC79
-  {"Dly Time",  81,   32,  0, 127},  // CC81
-  {"Dly Fdbk",    82,   64,  0, 127},  // CC82
-  {"Dly Sync",    86,   32,  0, 127},  // CC86
-  {"Dly L Div",   91,   32,  0, 127},  // CC91
-  {"Dly R Div",   92,   32,  0, 127},  // CC92
-  {"Dly L Mod",   93,   0,   0, 2},    // CC93 - 3 modes (0-2)
-  {"Dly R Mod",   94,   0,   0, 2},    // CC94 - 3 modes (0-2)
-  {"Dly Mix",     83,   38,  0, 127},  // CC83
-  {"Glide",      100,   64,  0, 127}   // CC100
-};
+Parameter UIManager::parameters[kParameterCount];
 
-const uint8_t UIManager::paramCount = sizeof(UIManager::parameters) / sizeof(Parameter);
+const uint8_t UIManager::paramCount = kParameterCount;
 
 UIManager::UIManager()
   : state(UI_MENU)
@@ -57,6 +33,9 @@ UIManager::UIManager()
   , lastButtonTime(0)
   , parameterCallback(nullptr)
 {
+  for (uint8_t i = 0; i < kParameterCount; i++) {
+    parameters[i] = kParameterMap[i];
+  }
 }
 
 void UIManager::begin(uint8_t pinA, uint8_t pinB, uint8_t pinSW) {
@@ -100,10 +79,11 @@ bool UIManager::update() {
       // Navigate menu
       int16_t newIndex = (int16_t)currentParamIndex + delta;
       
-      // Wrap around
+      // Wrap around (parameters, then the view pages)
+      int16_t menuLength = paramCount + kViewPageCount;
       if (newIndex < 0) {
-        newIndex = paramCount - 1;
-      } else if (newIndex >= paramCount) {
+        newIndex = menuLength - 1;
+      } else if (newIndex >= menuLength) {
         newIndex = 0;
       }
       
@@ -134,8 +114,12 @@ bool UIManager::update() {
   if (readButton()) {
     needsRedraw = true;
     
+    // View pages have nothing to edit: the button switches the tapped signal
+    if (getView() != VIEW_PARAMETER) {
+      scopeSource ^= 1;
+    }
     // Toggle between menu and edit mode
-    if (state == UI_MENU) {
+    else if (state == UI_MENU) {
       state = UI_EDIT;
     } else {
       state = UI_MENU;
@@ -212,6 +196,13 @@ bool UIManager::readButton() {
   return false;
 }
 
+UIView UIManager::getView() const {
+  if (currentParamIndex < paramCount) {
+    return VIEW_PARAMETER;
+  }
+  return (currentParamIndex == paramCount) ? VIEW_SCOPE : VIEW_SPECTRUM;
+}
+
 const Parameter& UIManager::getParameter(uint8_t index) const {
   if (index >= paramCount) {
     index = 0;  // Safety fallback
@@ -11,6 +11,7 @@
 #define UIMANAGER_H
 
 #include <Arduino.h>
+#include "ParameterMap.h"
 
 // Pin definitions moved to main sketch
 // #define ENCODER_A_PIN   6
@@ -23,15 +24,14 @@ enum UIState {
   UI_EDIT     // Editing selected parameter
 };
 
-// Parameter structure
-struct Parameter {
-  const char* name;
-  uint8_t cc;
-  uint8_t value;
-  uint8_t minVal;
-  uint8_t maxVal;
+// What the current menu position shows
+enum UIView {
+  VIEW_PARAMETER, // A synth parameter (menu/edit)
+  VIEW_SCOPE,     // Live oscilloscope
+  VIEW_SPECTRUM   // Live coarse spectrum
 };
 
+
 class UIManager {
 public:
   UIManager();
@@ -61,8 +61,20 @@ public:
   
   /**
    * @brief Get current parameter index (for menu navigation)
+   * Positions past the last parameter belong to the scope/spectrum views.
    */
   uint8_t getCurrentParamIndex() const { return currentParamIndex; }
+
+  /**
+   * @brief Get what the current menu position shows
+   */
+  UIView getView() const;
+
+  /**
+   * @brief Get the signal selected on the scope/spectrum views
+   * Toggled with the button: 0 = post-VCA, 1 = final output
+   */
+  uint8_t getScopeSource() const { return scopeSource; }
   
   /**
    * @brief Get parameter at given index
@@ -96,6 +108,10 @@ private:
   // UI state
   UIState state;
   uint8_t currentParamIndex;
+  uint8_t scopeSource = 0;
+
+  // Scope and spectrum pages follow the parameters in the menu
+  static const uint8_t kViewPageCount = 2;
   
   // Encoder state (volatile for ISR)
   static volatile uint8_t lastEncoderState;
@@ -111,7 +127,7 @@ private:
   uint32_t lastButtonTime;
   
   // Parameters array
-  static Parameter parameters[];
+  static Parameter parameters[kParameterCount];  // Copied from kParameterMap, values change
   static const uint8_t paramCount;
   
   // Callback for parameter changes
@@ -12,6 +12,14 @@
 // Uncomment the following line to enable the OLED Display and Rotary Encoder UI
 #define ENABLE_UI
 
+// Uncomment the following line to move UI, display, LED and USB-MIDI parsing to core 1.
+// Core 0 then only renders audio and receives events through lock-free queues.
+// #define DUAL_CORE
+
+// Uncomment the following line to time each stage of fillAudioBlock (report via SysEx).
+// When disabled the profiling hooks compile to nothing.
+// #define ENABLE_PROFILER
+
 #include <algorithm>
 #include <Arduino.h>
 #include <Adafruit_TinyUSB.h>
@@ -19,16 +27,23 @@
 #include <I2S.h>
 #include <AudioBufferManager.h>
 #include <cmath>
+#include <atomic>
 #include <pico/mutex.h>
 
-#include "Oscillator.h"
-#include "Filter303.h"
-#include "StereoDelay.h"
-#include "DecayEnvelope.h"
-#include "AnalogEnvelope.h"
-#include "LeakyIntegrator.h"
-#include "Distortion.h"
-#include "DCBlocker.h"
+#include "Pico303Engine.h"
+#include "Arena.h"
+#include "SpscQueue.h"
+#include "SynthEvent.h"
+#include "RenderStats.h"
+#include "AudioTap.h"
+#include "FixedFFT.h"
+#include "ScopeStreamer.h"
+#include "SysExProtocol.h"
+#include "StageProfiler.h"
+#include "DeferredLog.h"
+#include "TraceRecorder.h"
+#include "StressScenarios.h"
+#include "SketchHooks.h"
 #ifdef ENABLE_UI
 #include "UIManager.h"
 #include "DisplayManager.h"
@@ -43,12 +58,18 @@
   #define DEBUG_PRINTF(...) Serial.printf(__VA_ARGS__)
   #define DEBUG_PRINTLN(...) Serial.println(__VA_ARGS__)
   #define DEBUG_BEGIN(...) Serial.begin(__VA_ARGS__)
+  // Deferred: records format + args, printed later by drainLog()
+  #define LOG_EVENT(category, ...) eventLog.write(category, __VA_ARGS__)
 #else
   #define DEBUG_PRINTF(...)
   #define DEBUG_PRINTLN(...)
   #define DEBUG_BEGIN(...)
+  #define LOG_EVENT(category, ...)
 #endif
 
+// Messages printed per drainLog() call, keeps the idle path short
+#define LOG_DRAIN_PER_CALL 4
+
 // =============================================================================
 // Pin Definitions
 // =============================================================================
@@ -76,29 +97,19 @@
 
 I2S i2sOut(OUTPUT, pBCLK, pDOUT);
 
-// Audio Objects
-Oscillator osc;
-Filter303 filter;
-StereoDelay delayFx;
-Distortion distFx;
-DCBlocker hpfPostFilter;
+// Synth engine: oscillator, filter, envelopes, effects and note logic (audio side)
+Pico303Engine engine;
 
-// Synthesis objects
 #ifdef ENABLE_UI
 UIManager uiManager;
 DisplayManager displayManager;
 #endif
 
-// Open303 Envelopes & Voice State
-DecayEnvelope envFilt;      // Filter Envelope (was mainEnv)
-AnalogEnvelope envAmp;      // Amp Envelope (was ampEnv)
-LeakyIntegrator accentSmoother; // rc2 in Open303
-LeakyIntegrator ampDeClicker;   // Smoothes VCA signal to prevent clicks
-
-float accentLevel = 0.5f; // 0.0 to 1.0 (controlled by CC15)
-float currentAccentGain = 0.0f; // Actual gain applied to current note
-float envMod = 0.5f;  // 0..1
-float accent = 0.5f;  // 0..1
+// Decimated copy of the signal for the scope/spectrum pages and SysEx streaming
+AudioTap audioTap;
+FixedFFT scopeFFT;
+ScopeStreamer scopeStreamer;
+bool liveViewVisible = false;   // Scope or spectrum page on the OLED
 
 // Audio Buffer
 const int sampleRate = 44100;
@@ -112,44 +123,106 @@ uint32_t ledOnUntil = 20;
 
 volatile uint32_t clockTickCount = 0;
 uint32_t lastClockMicros = 0;
-float bpm = 120.0f;
-
-// MIDI state (Modified‑Naive)
-uint8_t prev_note = 0xFF;
-uint8_t noteOverlap = 0;
-
-// Synth state
-float volume = 0.6f;
-bool lastNoteWasAccented = false;
-float pitchOffset = 0.0f;         // in semitones
-float globalEnvMod = 2000.0f;
-float glideTimeMs = 80.0f;        // default TB-303 glide time
-float userDecayTime = 1000.0f;    // decay time setting
-
-// ---- Delay globals ----
-const int maxDelaySamples = 44100;  // 1 second delay max
-int delayTimeSamplesL = 22050;
-int delayTimeSamplesR = 22050;
-float delayFeedback = 0.5f;
-float delayMix = 0.3f;
-
-// Delay modifiers: 0 = Full, 1 = Dotted, 2 = Triplet
-int delayModL = 0;
-int delayModR = 0;
-
-StereoDelay stereoDelay;
 
 // Flag to trigger display update when MIDI CC changes a parameter
 #ifdef ENABLE_UI
 volatile bool midiNeedsDisplayUpdate = false;
 
+#ifndef DUAL_CORE
 // Mutex for synchronizing parameter changes between cores (or interrupts)
 auto_init_mutex(paramMutex);
 #endif
+#endif
+
+// ---- Housekeeping <-> audio messaging ----
+// Events flow housekeeping -> audio, render statistics flow audio -> housekeeping.
+// In DUAL_CORE mode these queues are the only state shared between the cores.
+SpscQueue<SynthEvent, 64> eventQueue;
+SpscQueue<RenderStats::Summary, 4> statsQueue;
+uint32_t droppedEvents = 0;     // housekeeping side only
+
+#ifdef DUAL_CORE
+std::atomic<bool> audioReady(false);
+#endif
+
+#if DEBUG_SERIAL
+// Log messages from MIDI and audio paths (see LOG_EVENT)
+DeferredLog eventLog;
+#endif
+
+// Applied events stamped in sample time, dumped over SysEx for offline replay
+TraceRecorder traceRecorder;
+uint32_t samplesRendered = 0;   // audio side only
+bool traceDumpActive = false;   // housekeeping side only
+int traceDumpNext = -1;         // Next event to send, -1 = header
+#define TRACE_EVENTS_PER_MSG 32
+#define TRACE_WINDOW_SAMPLES (TraceRecorder::kWindowSeconds * 44100 / AUDIO_BLOCK_SIZE * AUDIO_BLOCK_SIZE)
+
+// Stress mode: fixed worst-case scenarios played and timed by the audio side
+StressPlayer stressPlayer;
+bool stressRunAll = false;      // audio side only
+SpscQueue<uint8_t, 2> stressRequests;
+SpscQueue<StressPlayer::Result, 4> stressResults;
+
+// Block render time statistics (audio side only)
+RenderStats renderStats;
+// Smoothed render time / block period in 1/1000, for throttling housekeeping work
+std::atomic<uint16_t> audioLoadPermille(0);
+
+#ifdef ENABLE_PROFILER
+// Per-stage cycle counts (audio side); reports are requested and returned via queues
+StageProfiler stageProfiler;
+SpscQueue<uint8_t, 2> profileRequests;
+SpscQueue<StageProfiler::Report, 2> profileReports;
+#endif
+#define RENDER_STATS_BLOCKS (5 * 44100 / AUDIO_BLOCK_SIZE)  // ~5s of blocks
 
 // ---- DMA Audio Block Processing ----
+// Block size and I2S queue depth set the MIDI-to-audio latency; they can be
+// overridden from the build (see firmware/host latency benchmark).
+#ifndef AUDIO_BLOCK_SIZE
 #define AUDIO_BLOCK_SIZE 256  // samples per stereo frame (larger = more CPU headroom)
-int16_t audioBuffer[AUDIO_BLOCK_SIZE * 2];  // L/R interleaved
+#endif
+#ifndef I2S_BUFFER_COUNT
+#define I2S_BUFFER_COUNT 8
+#endif
+#ifndef I2S_BUFFER_WORDS
+#define I2S_BUFFER_WORDS 256  // One word = one 16-bit stereo frame
+#endif
+
+// ---- Memory map ----
+// Every DSP buffer is taken from one of two static arenas in setup(), so RAM
+// use is fixed at link time and checked against the budget below. The delay
+// lines go in the large DSP arena. The per-block buffers the audio loop and
+// the I2S copy touch on every block go in the small hot arena. Each arena can
+// be placed in its own SRAM section from the build, e.g.
+// -DHOT_ARENA_SECTION='".scratch_y.hot"' for SRAM9 (shares core 0's stack).
+// By default both live in uninitialized main SRAM; modules clear what they use.
+#ifndef DSP_ARENA_SECTION
+#define DSP_ARENA_SECTION ".uninitialized_data.dsp_arena"
+#endif
+#ifndef HOT_ARENA_SECTION
+#define HOT_ARENA_SECTION ".uninitialized_data.hot_arena"
+#endif
+#ifndef DSP_RAM_BUDGET
+#define DSP_RAM_BUDGET (384 * 1024)  // Of 520 KB; the rest is statics, heap (USB, MIDI, display) and stacks
+#endif
+
+constexpr size_t kDspArenaBytes = Pico303Engine::arenaBytes();
+constexpr size_t kHotArenaBytes = Arena::bytesFor<int16_t>(AUDIO_BLOCK_SIZE * 2);
+static_assert(kDspArenaBytes + kHotArenaBytes <= DSP_RAM_BUDGET, "DSP arenas exceed DSP_RAM_BUDGET");
+
+alignas(ARENA_ALIGN) uint8_t dspArenaStorage[kDspArenaBytes] ARENA_SECTION(DSP_ARENA_SECTION);
+alignas(ARENA_ALIGN) uint8_t hotArenaStorage[kHotArenaBytes] ARENA_SECTION(HOT_ARENA_SECTION);
+Arena dspArena(dspArenaStorage, sizeof(dspArenaStorage), "dsp");
+Arena hotArena(hotArenaStorage, sizeof(hotArenaStorage), "hot");
+
+int16_t* audioBuffer = nullptr;  // L/R interleaved, AUDIO_BLOCK_SIZE frames (hot arena)
+
+// Stages compiled into fillAudioBlock(). Pico303Engine::DryChain is the voice
+// without distortion and delay; a build can list any engine stages here and
+// gets a loop specialized for exactly those.
+using AudioChain = Pico303Engine::FullChain;
 
 /**
  * @brief DMA transmit complete callback (currently unused but available for monitoring)
@@ -160,51 +233,18 @@ void onI2STransmit() {
 
 /**
  * @brief Fill audio buffer with processed samples
- * Generates AUDIO_BLOCK_SIZE stereo samples into the buffer.
+ * Generates AUDIO_BLOCK_SIZE stereo samples into the buffer. Runs from SRAM
+ * with the render loop inlined into it, unless built with -DDSP_IN_RAM=0
+ * (see HotPath.h).
  */
-void fillAudioBlock() {
-  for (int i = 0; i < AUDIO_BLOCK_SIZE; i++) {
-    // Process single sample
-    float envAmpOut = envAmp.process();
-    float envFiltOut = envFilt.process();
-    float rawSample = osc.process();
-    float filtered = filter.process(rawSample, envFiltOut, lastNoteWasAccented ? 1.0f : 0.0f);
-    
-    // Remove DC offset caused by resonant filter *before* VCA/Distortion
-    filtered = hpfPostFilter.processHPF(filtered);
-    
-    // VCA Mixing (Open303 Style)
-    float vcaMod = envAmpOut;
-    if (envAmp.isActive()) {
-        vcaMod += 0.45f * envFiltOut;
-        vcaMod += currentAccentGain * 3.0f * envFiltOut;
-    }
-    
-    // Smooth the VCA signal to remove clicks
-    vcaMod = ampDeClicker.process(vcaMod);
-    
-    // Apply VCA *before* Distortion
-    float vcaOutput = filtered * vcaMod;
-
-    // Apply Distortion (Post-VCA)
-    float distorted = distFx.process(vcaOutput);
-    
-    float sample = distorted * volume;
-    float dryL = sample;
-    float dryR = sample;
-
-    float outL = stereoDelay.processL(dryL);
-    float outR = stereoDelay.processR(dryR);
-    stereoDelay.tick(dryL, dryR);
-
-    // Soft Clipper on final output
-    float finalL = std::tanh(outL * 0.10f) * 30000.0f;
-    float finalR = std::tanh(outR * 0.10f) * 30000.0f;
-
-    // Store in interleaved stereo buffer
-    audioBuffer[i * 2] = (int16_t)finalL;
-    audioBuffer[i * 2 + 1] = (int16_t)finalR;
-  }
+void DSP_HOT_FUNC(fillAudioBlock)() {
+  AudioTap* tap = audioTap.isArmed() ? &audioTap : nullptr;
+#ifdef ENABLE_PROFILER
+  engine.render<AudioChain>(audioBuffer, AUDIO_BLOCK_SIZE, tap, stageProfiler);
+#else
+  NullProfiler noProfiler;
+  engine.render<AudioChain>(audioBuffer, AUDIO_BLOCK_SIZE, tap, noProfiler);
+#endif
 }
 
 #ifdef ENABLE_UI
@@ -218,10 +258,14 @@ void onParameterChange(uint8_t cc, uint8_t value) {
   MIDI.sendControlChange(cc, value, 1);
   
   // Also apply the change locally
+#ifdef DUAL_CORE
+  dispatchEvent({SynthEvent::CONTROL_CHANGE, 1, cc, value, 0.0f});
+#else
   if (mutex_try_enter(&paramMutex, nullptr)) {
-    handleControlChange(1, cc, value);
+    applyEvent({SynthEvent::CONTROL_CHANGE, 1, cc, value, 0.0f});
     mutex_exit(&paramMutex);
   }
+#endif
 }
 #endif
 
@@ -242,7 +286,7 @@ void setup() {
   // I2S setup
   i2sOut.setBitsPerSample(16);
   // Large buffers for adequate headroom (8 buffers of 256 words = ~46ms total)
-  i2sOut.setBuffers(8, 256);
+  i2sOut.setBuffers(I2S_BUFFER_COUNT, I2S_BUFFER_WORDS);
   i2sOut.onTransmit(onI2STransmit);  // Optional DMA callback
   if (!i2sOut.begin(sampleRate)) {
     DEBUG_PRINTLN("I2S init failed");
@@ -250,40 +294,51 @@ void setup() {
   }
 
   // MIDI setup
-  MIDI.setHandleNoteOn(handleNoteOn);
-  MIDI.setHandleNoteOff(handleNoteOff);
-  MIDI.setHandleControlChange(handleControlChange);
+  // Callbacks only translate messages into SynthEvents; see dispatchEvent()
+  MIDI.setHandleNoteOn(onMidiNoteOn);
+  MIDI.setHandleNoteOff(onMidiNoteOff);
+  MIDI.setHandleControlChange(onMidiControlChange);
   MIDI.begin(MIDI_CHANNEL_OMNI);
   MIDI.setHandleClock(handleClock);
+  MIDI.setHandleSystemExclusive(onMidiSysEx);
 
-  // Osc
-  osc.setSampleRate(sampleRate);
-  osc.setWaveform(Oscillator::SQUARE);
-  osc.setMode(true); // Enable JC303 mode (Square = Pulse 53%)
-  envAmp.setDecay(300.0f);    // 300ms
-  envAmp.setRelease(10.0f);   // 10ms
-  envFilt.setDecayTime(1000.0f); // 1000ms
-
-  filter.setCutoff(1000.0f);
-  filter.setResonance(0.0f);
-  filter.setEnvMod(500.0f);      // how much the envelope modulates cutoff
-
-  if (!stereoDelay.begin()) {
+  audioBuffer = hotArena.allocate<int16_t>(AUDIO_BLOCK_SIZE * 2, "audioBuffer");
+  std::fill(audioBuffer, audioBuffer + AUDIO_BLOCK_SIZE * 2, (int16_t)0);
+  if (!engine.begin(sampleRate, dspArena)) {
     DEBUG_PRINTLN("ERROR: Failed to allocate delay buffer!");
   }
-  stereoDelay.setTimeSamplesL(11025); 
-  stereoDelay.setTimeSamplesR(11025); 
+#if DEBUG_SERIAL
+  hotArena.report([](const char* line) { DEBUG_PRINTLN(line); });
+  dspArena.report([](const char* line) { DEBUG_PRINTLN(line); });
+  engine.setLog(&eventLog);
+#endif
 
-  // Let's use 2.0ms to be safe and smooth.
-  ampDeClicker.setSampleRate(sampleRate);
-  ampDeClicker.setTimeConstant(2.0f); 
-  
-  // Post-filter HPF to remove DC offset (crucial for distortion)
-  hpfPostFilter.setSampleRate(sampleRate);
-  hpfPostFilter.setCutoff(30.0f); // ~25-30Hz like Open303
+  scopeFFT.begin();
+#ifdef ENABLE_PROFILER
+  stageProfiler.begin();
+#endif
   
+#ifdef DUAL_CORE
+  // Core 1 sets up the UI itself (so encoder interrupts fire on core 1)
+  audioReady = true;
+  DEBUG_PRINTLN("Setup complete - Dual Core Mode");
+#else
   // UI setup
 #ifdef ENABLE_UI
+  setupUI();
+#endif
+  
+  // Core 1 is unused in this single-core implementation
+  DEBUG_PRINTLN("Setup complete - Single Core Mode");
+#endif
+}
+
+#ifdef ENABLE_UI
+/**
+ * @brief Initializes encoder and display and shows the first menu item.
+ * Runs on whichever core owns the UI.
+ */
+void setupUI() {
   uiManager.begin(ENCODER_A_PIN, ENCODER_B_PIN, ENCODER_SW_PIN);
   uiManager.setParameterCallback(onParameterChange);
   
@@ -295,37 +350,185 @@ void setup() {
     const Parameter& param = uiManager.getParameter(0);
     displayManager.renderMenu(param);
   }
-#endif
-  
-  // Core 1 is unused in this single-core implementation
-  DEBUG_PRINTLN("Setup complete - Single Core Mode");
 }
+#endif
 
 /**
  * @brief Main execution loop.
  * Uses block-based audio processing for efficiency.
  * Fills I2S buffer whenever there's enough space, then handles UI.
+ * In DUAL_CORE mode this loop only renders audio; housekeeping runs in loop1().
  */
 void loop() {
+#ifndef DUAL_CORE
   // Handle MIDI continuously
   MIDI.read();
-
-  // LED timeout
-  if (millis() > ledOnUntil) {
-    digitalWrite(LED_PIN, LOW);
-  }
+  serviceLed();
+#endif
   
   // --- Block-Based Audio Processing ---
   // Fill I2S buffer whenever there's space for a full block
   // availableForWrite() returns bytes, our block is AUDIO_BLOCK_SIZE * 4 bytes
   while (i2sOut.availableForWrite() >= AUDIO_BLOCK_SIZE * 4) {
-    fillAudioBlock();
+    renderBlock();
     i2sOut.write((const uint8_t*)audioBuffer, AUDIO_BLOCK_SIZE * 4);
   }
 
+#ifndef DUAL_CORE
   // --- UI Update ---
   // Runs between audio block fills
 #ifdef ENABLE_UI
+  serviceUI();
+#endif
+  reportRenderStats();
+  serviceStreaming();
+  serviceProfiler();
+  serviceTrace();
+  serviceStress();
+  drainLog();
+#endif
+}
+
+#ifdef DUAL_CORE
+/**
+ * @brief Core 1 setup. Waits for the audio engine, then brings up the UI.
+ */
+void setup1() {
+  while (!audioReady) {
+    tight_loop_contents();
+  }
+#ifdef ENABLE_UI
+  setupUI();
+#endif
+}
+
+/**
+ * @brief Core 1 loop. Owns all non-audio work: USB-MIDI parsing, LED,
+ * encoder, display and statistics reporting.
+ */
+void loop1() {
+  MIDI.read();
+  serviceLed();
+#ifdef ENABLE_UI
+  serviceUI();
+#endif
+  reportRenderStats();
+  serviceStreaming();
+  serviceProfiler();
+  serviceTrace();
+  serviceStress();
+  drainLog();
+}
+#endif
+
+/**
+ * @brief Applies pending events, then renders one block and records its render time.
+ */
+void renderBlock() {
+  traceRecorder.tick(samplesRendered, TRACE_WINDOW_SAMPLES);
+
+  SynthEvent ev;
+  while (eventQueue.pop(ev)) {
+    applyEvent(ev);
+  }
+
+  // Stress scenarios are applied like incoming MIDI, and every block is timed
+  uint8_t stressRequest;
+  if (stressRequests.pop(stressRequest)) {
+    stressRunAll = stressRequest >= kStressScenarioCount;
+    stressPlayer.start(stressRunAll ? 0 : stressRequest, sampleRate);
+  }
+  bool stressWasActive = stressPlayer.isActive();
+  bool stressing = stressWasActive && stressPlayer.advance(AUDIO_BLOCK_SIZE, applyEvent);
+
+  uint32_t start = micros();
+  fillAudioBlock();
+  uint32_t elapsed = micros() - start;
+  samplesRendered += AUDIO_BLOCK_SIZE;
+
+  if (stressing) {
+    stressPlayer.recordBlock(elapsed);
+  } else if (stressWasActive) {
+    stressResults.push(stressPlayer.result());
+    if (stressRunAll && stressPlayer.index() + 1 < kStressScenarioCount) {
+      stressPlayer.start(stressPlayer.index() + 1, sampleRate);
+    }
+  }
+  renderStats.add(elapsed);
+
+  // Fast attack, slow release so short spikes still throttle housekeeping
+  static float load = 0.0f;
+  const float blockPeriodUs = AUDIO_BLOCK_SIZE * 1000000.0f / sampleRate;
+  float instant = elapsed / blockPeriodUs;
+  load = (instant > load) ? instant : load + 0.02f * (instant - load);
+  audioLoadPermille.store((uint16_t)std::min(load * 1000.0f, 65535.0f), std::memory_order_relaxed);
+
+#ifdef ENABLE_PROFILER
+  uint8_t resetAfterReport;
+  if (profileRequests.pop(resetAfterReport)) {
+    profileReports.push(stageProfiler.report());
+    if (resetAfterReport) stageProfiler.reset();
+  }
+#endif
+
+  if (renderStats.blocks() >= RENDER_STATS_BLOCKS) {
+    statsQueue.push(renderStats.summarize());
+    renderStats.reset();
+  }
+}
+
+/**
+ * @brief The audio buffer as last rendered (for host drivers, see SketchHooks.h).
+ */
+const int16_t* renderedBlock() {
+  return audioBuffer;
+}
+
+/**
+ * @brief Turns the activity LED off once its blink time has passed.
+ */
+void serviceLed() {
+  // LED timeout
+  if (millis() > ledOnUntil) {
+    digitalWrite(LED_PIN, LOW);
+  }
+}
+
+/**
+ * @brief Lights the activity LED for 20ms.
+ */
+void blinkLed() {
+  digitalWrite(LED_PIN, HIGH);
+  ledOnUntil = millis() + 20;
+}
+
+/**
+ * @brief Prints a few deferred log messages (idle path / core 1).
+ */
+void drainLog() {
+#if DEBUG_SERIAL
+  eventLog.drain(Serial, LOG_DRAIN_PER_CALL);
+#endif
+}
+
+/**
+ * @brief Prints render time statistics published by the audio side.
+ * The spread (stddev, max - min) shows how deterministic block rendering is.
+ */
+void reportRenderStats() {
+  RenderStats::Summary summary;
+  while (statsQueue.pop(summary)) {
+    DEBUG_PRINTF("Render us: min %.0f avg %.1f max %.0f stddev %.2f (%lu blocks, %lu dropped events)\n",
+                 summary.minUs, summary.meanUs, summary.maxUs, summary.stddevUs,
+                 (unsigned long)summary.blocks, (unsigned long)droppedEvents);
+  }
+}
+
+#ifdef ENABLE_UI
+/**
+ * @brief Polls the encoder, redraws the framebuffer and streams it to the OLED.
+ */
+void serviceUI() {
   static uint32_t lastUiCheck = 0;
   static bool uiNeedsRedraw = false;
   static uint32_t lastDisplayUpdate = 0;
@@ -340,268 +543,306 @@ void loop() {
       midiNeedsDisplayUpdate = false;
     }
 
-    // Update display (slow I2C) - throttled to 200ms
-    if (uiNeedsRedraw && (millis() - lastDisplayUpdate >= 200)) {
+    // Live pages redraw continuously (and keep the audio tap armed)
+    UIView view = uiManager.getView();
+    liveViewVisible = (view != VIEW_PARAMETER);
+    if (liveViewVisible) {
+      uiNeedsRedraw = true;
+    }
+
+    // Redraw framebuffer - throttled to 30ms (transfer happens in service())
+    if (uiNeedsRedraw && (millis() - lastDisplayUpdate >= 30)) {
       lastDisplayUpdate = millis();
       uiNeedsRedraw = false;
       
       const Parameter& currentParam = uiManager.getParameter(uiManager.getCurrentParamIndex());
-      if (uiManager.getState() == UI_MENU) {
+      if (view == VIEW_SCOPE) {
+        renderScopePage();
+      } else if (view == VIEW_SPECTRUM) {
+        renderSpectrumPage();
+      } else if (uiManager.getState() == UI_MENU) {
         displayManager.renderMenu(currentParam);
       } else {
         displayManager.renderEdit(currentParam);
       }
     }
   }
-#endif
+
+  // Push changed framebuffer regions via DMA (non-blocking)
+  displayManager.service();
 }
 
-// ---- MIDI handlers ----
+/**
+ * @brief Draws the oscilloscope page from the audio tap.
+ * Triggers on a rising zero crossing so periodic waveforms stand still.
+ */
+void renderScopePage() {
+  static float samples[2 * DISPLAY_W];
+  AudioTap::Channel ch = uiManager.getScopeSource() ? AudioTap::OUTPUT : AudioTap::POST_VCA;
+  if (!audioTap.snapshot(ch, samples, 2 * DISPLAY_W)) return;  // Overtaken: keep last frame
+
+  int trigger = 0;
+  for (int i = 1; i < DISPLAY_W; i++) {
+    if (samples[i - 1] < 0.0f && samples[i] >= 0.0f) {
+      trigger = i;
+      break;
+    }
+  }
+  displayManager.renderScope(samples + trigger, DISPLAY_W, ch == AudioTap::OUTPUT ? "OUT" : "VCA");
+}
 
 /**
- * @brief Handles MIDI Note On events.
- * Triggers envelopes, sets frequency, and handles accent/slide logic.
- * 
- * @param channel MIDI channel (1-16)
- * @param pitch MIDI note number (0-127)
- * @param velocity Note velocity (0-127)
+ * @brief Draws the spectrum page (128-point fixed-point FFT of the audio tap).
+ */
+void renderSpectrumPage() {
+  static float samples[FixedFFT::kSize];
+  static uint16_t mags[FixedFFT::kBins];
+  AudioTap::Channel ch = uiManager.getScopeSource() ? AudioTap::OUTPUT : AudioTap::POST_VCA;
+  if (!audioTap.snapshot(ch, samples, FixedFFT::kSize)) return;
+
+  scopeFFT.magnitudes(samples, mags);
+  displayManager.renderSpectrum(mags, FixedFFT::kBins, ch == AudioTap::OUTPUT ? "OUT" : "VCA");
+}
+#endif
+
+/**
+ * @brief Arms the audio tap when someone is watching and sends due SysEx frames.
  */
-void handleNoteOn(byte channel, byte pitch, byte velocity) {
-  bool slide = (prev_note != 0xFF);
-  bool accent = (velocity >= 100);
+void serviceStreaming() {
+  audioTap.arm(liveViewVisible || scopeStreamer.isActive());
 
-  // Modified‑Naive overlap counter
-  if (prev_note == pitch) noteOverlap++;
-  prev_note = pitch;
+  float load = audioLoadPermille.load(std::memory_order_relaxed) / 1000.0f;
+  scopeStreamer.service(millis(), load, audioTap, scopeFFT, sendSysEx);
+}
 
-  // Blink LED
-  digitalWrite(LED_PIN, HIGH);
-  ledOnUntil = millis() + 20;
+/**
+ * @brief Sends a stage profile report as SysEx.
+ * With the profiler compiled out the report has zero stages.
+ */
+void sendProfileReport(const StageProfiler::Report* report) {
+  uint8_t msg[SYSEX_HEADER_SIZE + 7 + STAGE_COUNT * 12 + 1];
+  unsigned len = sysexWriteHeader(msg, SYSEX_PROFILE_REPORT);
+  msg[len++] = report ? STAGE_COUNT : 0;
+  len += sysexWrite14(msg + len, F_CPU / 1000000);
+  len += sysexWrite28(msg + len, report ? report->blocks : 0);
+  for (int i = 0; report && i < STAGE_COUNT; i++) {
+    len += sysexWrite28(msg + len, report->minCycles[i]);
+    len += sysexWrite28(msg + len, report->avgCycles[i]);
+    len += sysexWrite28(msg + len, report->maxCycles[i]);
+  }
+  msg[len++] = 0xF7;
+  sendSysEx(msg, len);
+}
 
-  float freq = 440.0f * powf(2.0f, (pitch + pitchOffset - 69) / 12.0f);
-  osc.glideTo(freq, slide ? glideTimeMs : 0.0f);  // use configurable glide time
+/**
+ * @brief Forwards profile reports from the audio side to the host.
+ */
+void serviceProfiler() {
+#ifdef ENABLE_PROFILER
+  StageProfiler::Report report;
+  while (profileReports.pop(report)) {
+    sendProfileReport(&report);
+  }
+#endif
+}
 
-  // Accent and envelope logic
-  if (!slide || accent) {
-    if (!slide) {
-      osc.resetPhase();
+/**
+ * @brief Sends the frozen event trace, one message per call: the header
+ * (baseline controller values), then TRACE_EVENTS_PER_MSG events at a time.
+ * Recording resumes once everything is sent.
+ */
+void serviceTrace() {
+  if (!traceDumpActive || !traceRecorder.isFrozen()) return;
+
+  if (traceDumpNext < 0) {
+    const TraceRecorder::State& base = traceRecorder.baseline();
+    uint8_t msg[SYSEX_HEADER_SIZE + 36 + 19 + 128 + 1];
+    unsigned len = sysexWriteHeader(msg, SYSEX_TRACE_HEADER);
+    msg[len++] = traceRecorder.isComplete() ? TRACE_COMPLETE : 0;
+    len += sysexWrite28(msg + len, sampleRate);
+    len += sysexWrite14(msg + len, AUDIO_BLOCK_SIZE);
+    len += sysexWrite32(msg + len, traceRecorder.startSample());
+    len += sysexWrite32(msg + len, traceRecorder.endSample());
+    len += sysexWrite14(msg + len, traceRecorder.size());
+    uint32_t bpmBits = 0;
+    if (base.bpmSet) memcpy(&bpmBits, &base.bpm, sizeof(bpmBits));
+    len += sysexWrite32(msg + len, bpmBits);
+    for (int i = 0; i < 19; i++) {
+      uint8_t bits = 0;
+      for (int b = 0; b < 7; b++) {
+        int cc = i * 7 + b;
+        if (cc < 128 && (base.ccSet[cc >> 3] & (1 << (cc & 7)))) bits |= 1 << b;
+      }
+      msg[len++] = bits;
     }
-    envAmp.setRelease(accent ? 50.0f : 10.0f);
-    envAmp.noteOn();
-    
-    // Use user-set decay time for normal notes, fixed 200ms for accent (TB-303 behavior)
-    envFilt.setDecayTime(accent ? 200.0f : userDecayTime);
-    envFilt.trigger();
-    
-    // Calculate accent gain for this note
-    currentAccentGain = accent ? accentLevel : 0.0f;
-    
-    // Filter modulation
-    // Base mod + Accent mod
-    // If accentLevel is 1.0, we want max boost (e.g. 2.5x total or similar)
-    // Old logic: accentBoost 1.0..2.5
-    // New logic: 1.0 + accentLevel * 1.5
-    float boost = 1.0f + currentAccentGain * 1.5f;
-    float modAmt = globalEnvMod * boost;
-    
-    modAmt = std::min(modAmt, 3000.0f);  // cap to prevent filter overload
-    filter.setEnvMod(modAmt);
+    for (int cc = 0; cc < 128; cc++) {
+      msg[len++] = base.cc[cc] & 0x7F;
+    }
+    msg[len++] = 0xF7;
+    sendSysEx(msg, len);
+    traceDumpNext = 0;
+    return;
+  }
+
+  int count = std::min(traceRecorder.size() - traceDumpNext, TRACE_EVENTS_PER_MSG);
+  if (count > 0) {
+    uint8_t msg[SYSEX_HEADER_SIZE + 3 + TRACE_EVENTS_PER_MSG * 14 + 1];
+    unsigned len = sysexWriteHeader(msg, SYSEX_TRACE_EVENTS);
+    len += sysexWrite14(msg + len, traceDumpNext);
+    msg[len++] = count;
+    for (int i = 0; i < count; i++) {
+      const TraceRecorder::Entry& e = traceRecorder.at(traceDumpNext + i);
+      uint32_t valueBits;
+      memcpy(&valueBits, &e.event.value, sizeof(valueBits));
+      len += sysexWrite32(msg + len, e.sample);
+      msg[len++] = e.event.type;
+      msg[len++] = e.event.channel & 0x7F;
+      msg[len++] = e.event.data1 & 0x7F;
+      msg[len++] = e.event.data2 & 0x7F;
+      len += sysexWrite32(msg + len, valueBits);
+    }
+    msg[len++] = 0xF7;
+    sendSysEx(msg, len);
+    traceDumpNext += count;
   }
 
-  lastNoteWasAccented = accent;
-
-  DEBUG_PRINTF("NoteON ch%u pitch%u vel%u slide=%d accent=%d\n",
-                channel, pitch, velocity, slide, accent);
+  if (traceDumpNext >= traceRecorder.size()) {
+    traceDumpActive = false;
+    traceRecorder.release();
+  }
 }
 
 /**
- * @brief Handles MIDI Note Off events.
- * Manages note overlap for legato playing and triggers release phase.
- * 
- * @param channel MIDI channel
- * @param pitch MIDI note number
- * @param velocity Release velocity
+ * @brief Reports finished stress scenarios to the host.
  */
-void handleNoteOff(byte channel, byte pitch, byte velocity) {
-  // Modified‑Naive: decrement overlap before noteOff
-  if (prev_note == pitch) {
-    if (noteOverlap > 0) {
-      noteOverlap--;
-      return;
+void serviceStress() {
+  StressPlayer::Result result;
+  while (stressResults.pop(result)) {
+    const char* name = kStressScenarios[result.index].name;
+    uint8_t msg[SYSEX_HEADER_SIZE + 14 + 24 + 1];
+    unsigned len = sysexWriteHeader(msg, SYSEX_STRESS_REPORT);
+    msg[len++] = result.index;
+    msg[len++] = kStressScenarioCount;
+    len += sysexWrite14(msg + len, result.blocks);
+    len += sysexWrite28(msg + len, result.maxUs);
+    len += sysexWrite28(msg + len, result.meanUs);
+    len += sysexWrite14(msg + len, result.worstBlock);
+    for (int i = 0; name[i] && i < 24; i++) {
+      msg[len++] = name[i] & 0x7F;
     }
-    // If no overlap left, stop tone
-    prev_note = 0xFF;
-    envAmp.noteOff();
+    msg[len++] = 0xF7;
+    sendSysEx(msg, len);
+    DEBUG_PRINTF("Stress %-16s max %lu us, mean %lu us over %u blocks\n", name,
+                 (unsigned long)result.maxUs, (unsigned long)result.meanUs, result.blocks);
+  }
+}
 
-    digitalWrite(LED_PIN, HIGH);
-    ledOnUntil = millis() + 20;
+/**
+ * @brief Sends a complete SysEx message (F0 ... F7) over USB MIDI.
+ */
+void sendSysEx(const uint8_t* data, unsigned length) {
+  MIDI.sendSysEx(length, data, true);
+}
 
-    DEBUG_PRINTF("NoteOFF ch%u pitch%u vel%u\n",
-                  channel, pitch, velocity);
+/**
+ * @brief MIDI SysEx callback (housekeeping side).
+ * @param data Complete message including F0 and F7
+ * @param size Message length in bytes
+ */
+void onMidiSysEx(byte* data, unsigned size) {
+  if (!sysexIsOurs(data, size)) return;
+
+  uint8_t command = data[4];
+  if (command == SYSEX_STREAM_CONFIG && size >= SYSEX_HEADER_SIZE + 3) {
+    scopeStreamer.configure(data[5], data[6]);
+    LOG_EVENT(LOG_SYSEX, "SysEx stream config: flags %u fps %u\n", data[5], data[6]);
+  }
+  else if (command == SYSEX_PROFILE_REQUEST && size >= SYSEX_HEADER_SIZE + 2) {
+#ifdef ENABLE_PROFILER
+    // Answered by the audio side at the next block boundary
+    profileRequests.push(data[5]);
+#else
+    sendProfileReport(nullptr);
+#endif
+  }
+  else if (command == SYSEX_LOG_MASK && size >= SYSEX_HEADER_SIZE + 2) {
+#if DEBUG_SERIAL
+    eventLog.setMask(data[5]);
+#endif
+  }
+  else if (command == SYSEX_STRESS_RUN && size >= SYSEX_HEADER_SIZE + 2) {
+    stressRequests.push(data[5]);
+    LOG_EVENT(LOG_SYSEX, "SysEx stress run %u\n", data[5]);
+  }
+  else if (command == SYSEX_TRACE_REQUEST && !traceDumpActive) {
+    // Sent from serviceTrace() once the audio side has frozen the ring
+    traceRecorder.requestFreeze();
+    traceDumpActive = true;
+    traceDumpNext = -1;
+    LOG_EVENT(LOG_SYSEX, "SysEx trace dump requested\n");
   }
 }
 
+// ---- Event routing ----
+
 /**
- * @brief Handles MIDI Control Change events.
- * Updates synth parameters based on CC messages.
- * 
- * @param channel MIDI channel
- * @param cc Control Change number
- * @param value Control value (0-127)
+ * @brief Hands an event to the audio engine.
+ * Single core: applied immediately. DUAL_CORE: queued for core 0, which
+ * applies it at the next block boundary.
  */
-void handleControlChange(byte channel, byte cc, byte value) {
-  // Sync parameter value with UI (so encoder displays current value)
-  // Sync parameter value with UI (so encoder displays current value)
+void dispatchEvent(const SynthEvent& ev) {
+#ifdef DUAL_CORE
+  if (!eventQueue.push(ev)) {
+    droppedEvents++;
+  }
+#else
+  applyEvent(ev);
+#endif
+}
+
+/**
+ * @brief Applies an event to the synth state (audio side).
+ */
+void applyEvent(const SynthEvent& ev) {
+  traceRecorder.record(samplesRendered, ev);
+  engine.apply(ev);
+}
+
+/**
+ * @brief MIDI Note On callback (housekeeping side).
+ */
+void onMidiNoteOn(byte channel, byte pitch, byte velocity) {
+  blinkLed();
+  dispatchEvent({SynthEvent::NOTE_ON, channel, pitch, velocity, 0.0f});
+}
+
+/**
+ * @brief MIDI Note Off callback (housekeeping side).
+ */
+void onMidiNoteOff(byte channel, byte pitch, byte velocity) {
+  blinkLed();
+  dispatchEvent({SynthEvent::NOTE_OFF, channel, pitch, velocity, 0.0f});
+}
+
+/**
+ * @brief MIDI Control Change callback (housekeeping side).
+ * Syncs the UI with the new value before handing the change to the engine.
+ */
+void onMidiControlChange(byte channel, byte cc, byte value) {
 #ifdef ENABLE_UI
+  // Sync parameter value with UI (so encoder displays current value)
   uiManager.updateParameterValue(cc, value);
   // Trigger display update so OLED shows the new value
   midiNeedsDisplayUpdate = true;
 #endif
-  if (cc == 7) {  // Volume
-    // Rescale volume: Max (127) = 0.6 (safe level)
-    volume = (value / 127.0f) * 0.6f;
-    DEBUG_PRINTF("CC7 Volume: %.2f\n", volume);
-  }
-  else if (cc == 14) {  // Sub oscillator blend
-    float subAmt = value / 127.0f;
-    osc.setSubBlend(subAmt);
-    DEBUG_PRINTF("CC14 Sub Blend: %.2f\n", subAmt);
-  }
-  else if (cc == 15) {  // Accent intensity
-    accentLevel = value / 127.0f; // 0.0 to 1.0
-    DEBUG_PRINTF("CC15 Accent Level: %.2f\n", accentLevel);
-  }
-  else if (cc == 16) {  // Pitch offset
-    pitchOffset = (value - 64) / 64.0f * 12.0f; // ±12 semitones
-    DEBUG_PRINTF("CC16 Pitch Offset: %.2f semitones\n", pitchOffset);
-  }
-  else if (cc == 17) {  // Mod envelope amount
-    globalEnvMod = (value / 127.0f) * 3000.0f;  // reduced to avoid filter instability
-    DEBUG_PRINTF("CC17 Env Mod: %.1f\n", globalEnvMod);
-  }
-  else if (cc == 18) {  // Waveform blend
-    float blendVal = value / 127.0f;
-    osc.setBlend(blendVal);
-    DEBUG_PRINTF("CC18 Waveform Blend: %.2f\n", blendVal);
-  }
-  else if (cc == 71) {  // Resonance
-    float res = value / 127.0f;
-    float shaped = powf(res, 0.8f);  // slightly aggressive but safe shaping
-    filter.setResonance(std::min(shaped, 1.0f));  // ensure cap
-    DEBUG_PRINTF("CC71 Resonance: %.2f (shaped: %.2f)\n", res, shaped);
-  }
-  else if (cc == 74) {  // Filter Cutoff
-    // Exponential mapping: 300Hz to 3000Hz
-    // freq = min * (max/min)^(val/127)
-    float freq = 300.0f * pow(3000.0f / 300.0f, value / 127.0f);
-    filter.setCutoff(freq);
-    DEBUG_PRINTF("CC74 Cutoff: %.1f Hz\n", freq);
-  }
-  else if (cc == 75) {  // Envelope decay time
-    userDecayTime = 50.0f + (value / 127.0f) * 1950.0f; // 50ms to 2000ms
-    envFilt.setDecayTime(userDecayTime); // Update immediately
-    DEBUG_PRINTF("CC75 Decay Time: %.2f ms\n", userDecayTime);
-  }
-  else if (cc == 77) {  // Distortion mode
-    distFx.setType(static_cast<Distortion::Type>(value % 5));
-    DEBUG_PRINTF("CC77 Dist Mode: %d\n", value % 5);
-  }
-  else if (cc == 78) {  // Distortion amount
-    float amt = value / 127.0f;
-    distFx.setAmount(amt);
-    DEBUG_PRINTF("CC78 Dist Amount: %.2f\n", amt);
-  }
-  else if (cc == 79) {  // Distortion Mix
-    float mix = value / 127.0f;
-    distFx.setMix(mix);
-    DEBUG_PRINTF("CC79 Dist Mix: %.2f\n", mix);
-  }
-  else if (cc == 80) {  // Distortion On/Off
-    bool on = value > 63;
-    distFx.setEnabled(on);
-    DEBUG_PRINTF("CC80 Dist Enable: %d\n", on);
-  }
-  else if (cc == 81) {  // Delay Time
-    delayTimeSamplesL = map(value, 0, 127, 2000, 44100);  // 2ms to 1s
-    delayTimeSamplesR = delayTimeSamplesL;
-    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
-    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
-    DEBUG_PRINTF("CC81 Delay Time: %d samples\n", delayTimeSamplesL);
-  }
-  else if (cc == 82) {  // Delay Feedback
-    delayFeedback = value / 127.0f;
-    stereoDelay.setFeedback(delayFeedback);
-    DEBUG_PRINTF("CC82 Feedback: %.2f\n", delayFeedback);
-  }
-  else if (cc == 83) {  // Delay Mix
-    delayMix = value / 127.0f;
-    stereoDelay.setMix(delayMix);
-    DEBUG_PRINTF("CC83 Mix: %.2f\n", delayMix);
-  }
-  else if (cc == 86) {
-    int div = max(1, value / 16);  // Map 0–127 to divs
-    float beats = pow(2, div - 1) / 4.0f;  // 1/16, 1/8, 1/4, etc.
-    delayTimeSamplesL = beatsToSamples(beats);
-    delayTimeSamplesR = delayTimeSamplesL;
-    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
-    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
-    DEBUG_PRINTF("CC86 Delay Sync Division: 1/%d beat, %d samples (BPM %.1f)\n", (int)(1.0f / beats), delayTimeSamplesL, bpm);
-  }
-  else if (cc == 91) {
-    int div = max(1, value / 16);
-    float beats = pow(2, div - 1) / 4.0f;
-    if (delayModL == 1) beats *= 1.5f;       // Dotted
-    else if (delayModL == 2) beats *= 2.0f / 3.0f; // Triplet
-    int samples = beatsToSamples(beats);
-    samples = std::clamp(samples, 1, maxDelaySamples - 1);
-    delayTimeSamplesL = samples;
-    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
-    DEBUG_PRINTF("CC91 Delay L Div: 1/%d beat, %d samples\n", (int)(1.0f / beats), delayTimeSamplesL);
-  }
-  else if (cc == 92) {
-    int div = max(1, value / 16);
-    float beats = pow(2, div - 1) / 4.0f;
-    if (delayModR == 1) beats *= 1.5f;
-    else if (delayModR == 2) beats *= 2.0f / 3.0f;
-    int samples = beatsToSamples(beats);
-    samples = std::clamp(samples, 1, maxDelaySamples - 1);
-    delayTimeSamplesR = samples;
-    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
-    DEBUG_PRINTF("CC92 Delay R Div: 1/%d beat, %d samples\n", (int)(1.0f / beats), delayTimeSamplesR);
-  }
-  else if (cc == 93) {  // Delay L Modifier
-    delayModL = value % 3;
-    int div = max(1, delayTimeSamplesL > 0 ? log2f((delayTimeSamplesL * 4.0f / sampleRate) / (60.0f / bpm)) + 1 : 2);
-    float beats = pow(2, div - 1) / 4.0f;
-    if (delayModL == 1) beats *= 1.5f;
-    else if (delayModL == 2) beats *= 2.0f / 3.0f;
-    int samples = beatsToSamples(beats);
-    samples = std::clamp(samples, 1, maxDelaySamples - 1);
-    delayTimeSamplesL = samples;
-    stereoDelay.setTimeSamplesL(delayTimeSamplesL);
-    DEBUG_PRINTF("CC93 Delay L Mod: %d -> %d samples\n", delayModL, delayTimeSamplesL);
-  }
-  else if (cc == 94) {  // Delay R Modifier
-    delayModR = value % 3;
-    int div = max(1, delayTimeSamplesR > 0 ? log2f((delayTimeSamplesR * 4.0f / sampleRate) / (60.0f / bpm)) + 1 : 2);
-    float beats = pow(2, div - 1) / 4.0f;
-    if (delayModR == 1) beats *= 1.5f;
-    else if (delayModR == 2) beats *= 2.0f / 3.0f;
-    int samples = beatsToSamples(beats);
-    samples = std::clamp(samples, 1, maxDelaySamples - 1);
-    delayTimeSamplesR = samples;
-    stereoDelay.setTimeSamplesR(delayTimeSamplesR);
-    DEBUG_PRINTF("CC94 Delay R Mod: %d -> %d samples\n", delayModR, delayTimeSamplesR);
-  }
-  else if (cc == 100) {  // Glide Time
-    glideTimeMs = (value == 64) ? 80.0f : (value / 127.0f) * 500.0f;
-    DEBUG_PRINTF("CC100 Glide Time: %.1f ms\n", glideTimeMs);
-  }
+  dispatchEvent({SynthEvent::CONTROL_CHANGE, channel, cc, value, 0.0f});
 }
 
+// ---- MIDI clock ----
+
 /**
- * @brief Handles MIDI Clock events.
- * Calculates BPM based on clock interval.
+ * @brief Handles MIDI Clock events (housekeeping side).
+ * Calculates BPM based on clock interval and forwards it to the engine.
  */
 void handleClock() {
   clockTickCount++;
@@ -612,19 +853,9 @@ void handleClock() {
     lastClockMicros = now;
 
     if (interval > 0) {
-      bpm = 60.0f * 1000000.0f / (float)interval;
-      DEBUG_PRINTF("MIDI Clock BPM: %.2f\n", bpm);
+      float measuredBpm = 60.0f * 1000000.0f / (float)interval;
+      dispatchEvent({SynthEvent::TEMPO, 0, 0, 0, measuredBpm});
+      LOG_EVENT(LOG_CLOCK, "MIDI Clock BPM: %.2f\n", measuredBpm);
     }
   }
 }
-
-/**
- * @brief Converts musical beats to sample count based on current BPM.
- * 
- * @param beats Number of beats (e.g., 0.25 for 1/16th note)
- * @return int Number of samples
- */
-int beatsToSamples(float beats) {
-  float seconds = (60.0f / bpm) * beats;
-  return (int)(seconds * sampleRate);
-}
\ No newline at end of file